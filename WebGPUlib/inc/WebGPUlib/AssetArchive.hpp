@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace WebGPUlib
+{
+class ThreadPool;
+
+// How the data of a file is stored in an asset archive.
+enum class ArchiveCompression : uint32_t
+{
+    None = 0,
+    LZ4  = 1,  // LZ4 block format.
+};
+
+// A read-only archive that stores many asset files in a single file.
+//
+// The archive starts with a header, followed by the data of the files and a table of contents.
+// The table of contents is sorted by the 64-bit hash of the (relative) file paths so a file is found
+// with a binary search. Each file is compressed with LZ4 if that makes it smaller. Files that are
+// stored uncompressed are aligned to 4 KB so they can be used directly from the mapped archive.
+//
+// The table of contents also stores the modification time of each file when the archive was created,
+// so a file in the archive can be compared with its source (see getModifiedTime). Archives with a different
+// format version are not opened.
+//
+// The archive is memory-mapped when it is opened. Files are read by copying (or decompressing) the
+// mapped data, which is safe to do from multiple threads at the same time.
+class AssetArchive
+{
+public:
+    // Open an archive. The paths of the files in the archive are relative to rootPath
+    // (usually the directory the archive was created from). Returns nullptr if the archive is not valid.
+    static std::unique_ptr<AssetArchive> open( const std::filesystem::path& archivePath,
+                                               const std::filesystem::path& rootPath );
+
+    // Create an archive from the regular files in a directory (and its subdirectories).
+    // Only the files for which filter returns true are added (all files if the filter is empty).
+    // If compress is true, the files for which compressFilter returns true (all files if it is empty) are
+    // compressed. Files that are not compressed can be used directly from the mapped archive (see getMappedData).
+    // The files are compressed on the worker threads if a thread pool is specified.
+    static bool create( const std::filesystem::path& archivePath, const std::filesystem::path& directory,
+                        const std::function<bool( const std::filesystem::path& )>& filter = {}, bool compress = true,
+                        ThreadPool* threadPool = nullptr,
+                        const std::function<bool( const std::filesystem::path& )>& compressFilter = {} );
+
+    ~AssetArchive();
+
+    AssetArchive( const AssetArchive& )            = delete;
+    AssetArchive( AssetArchive&& )                 = delete;
+    AssetArchive& operator=( const AssetArchive& ) = delete;
+    AssetArchive& operator=( AssetArchive&& )      = delete;
+
+    // Check if the archive contains a file.
+    bool contains( const std::filesystem::path& filePath ) const;
+
+    // Read (and decompress) a file. The result is empty if the archive does not contain the file.
+    std::vector<uint8_t> read( const std::filesystem::path& filePath ) const;
+
+    // Get the data of a file that is stored uncompressed (without copying it).
+    // Returns nullptr if the archive does not contain the file or the file is compressed.
+    const uint8_t* getMappedData( const std::filesystem::path& filePath, std::size_t& size ) const;
+
+    // Get the modification time that the file had when it was added to the archive.
+    // Returns false if the archive does not contain the file.
+    bool getModifiedTime( const std::filesystem::path& filePath, std::filesystem::file_time_type& time ) const;
+
+    const std::filesystem::path& getRootPath() const noexcept
+    {
+        return rootPath;
+    }
+
+    std::size_t getNumFiles() const noexcept
+    {
+        return numEntries;
+    }
+
+private:
+    // An entry in the table of contents.
+    struct Entry
+    {
+        uint64_t pathHash;
+        uint64_t offset;        // The offset of the data in the archive.
+        uint64_t size;          // The size of the file.
+        uint64_t storedSize;    // The size of the (compressed) data in the archive.
+        int64_t  modifiedTime;  // The modification time of the file (std::filesystem::file_time_type ticks).
+        uint32_t compression;
+        uint32_t pathOffset;    // The offset of the path in the string table.
+        uint32_t pathLength;
+        uint32_t reserved;
+    };
+
+    AssetArchive() = default;
+
+    // Find the entry of a file (nullptr if the archive does not contain the file).
+    const Entry* find( const std::filesystem::path& filePath ) const;
+
+    std::filesystem::path rootPath;
+
+    const uint8_t* data = nullptr;
+    std::size_t    size = 0;
+
+    const Entry* entries    = nullptr;
+    std::size_t  numEntries = 0;
+    const char*  strings    = nullptr;
+
+#ifdef _WIN32
+    void* fileHandle    = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+}  // namespace WebGPUlib
@@ -12,6 +12,8 @@ class Buffer;
 class Sampler;
 class TextureView;
 
+// A set of resources that are bound to a bind group of a pipeline.
+// The WebGPU bind group is only recreated if the bindings or the layout changed since it was last created.
 class BindGroup
 {
 public:
@@ -28,6 +30,8 @@ protected:
 
 private:
     std::vector<WGPUBindGroupEntry> bindings;
-    mutable WGPUBindGroup           bindGroup = nullptr;
+    mutable WGPUBindGroup           bindGroup       = nullptr;
+    mutable WGPUBindGroupLayout     bindGroupLayout = nullptr;
+    mutable bool                    dirty           = true;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
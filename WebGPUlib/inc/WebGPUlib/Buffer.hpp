@@ -23,11 +23,19 @@ public:
         return buffer;
     }
 
+    // The offset (in bytes) of the buffer data in the WGPUBuffer.
+    // Only buffers that reference a range of a larger buffer have a non-zero offset.
+    std::size_t getOffset() const
+    {
+        return offset;
+    }
+
 protected:
-    Buffer( WGPUBuffer&& buffer );
+    Buffer( WGPUBuffer&& buffer, std::size_t offset = 0 );
     virtual ~Buffer();
 
 private:
-    WGPUBuffer buffer = nullptr;
+    WGPUBuffer  buffer = nullptr;
+    std::size_t offset = 0;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
@@ -28,6 +28,17 @@ public:
     void bindSampler( uint32_t groupIndex, uint32_t binding, const Sampler& sampler );
     void bindTexture( uint32_t groupIndex, uint32_t binding, const TextureView& texture );
 
+    // Bind a prebuilt bind group (for example, the bind group of a material) to a group index.
+    // The bind group replaces the resources that were bound to the group index with the other bind functions
+    // until one of those functions is used for the group index again.
+    // The dynamic offsets are applied to the bindings of the layout that have a dynamic offset (in binding order).
+    void bindBindGroup( uint32_t groupIndex, std::shared_ptr<BindGroup> bindGroup,
+                        std::vector<uint32_t> dynamicOffsets = {} );
+
+    // Remove all resources that are bound to a group index. Use this when switching to a pipeline
+    // that uses a different layout for the group, so resources of the previous layout are not bound.
+    void resetBindGroup( uint32_t groupIndex );
+
     void bindDynamicUniformBuffer( uint32_t groupIndex, uint32_t binding, const void* data, std::size_t sizeInBytes );
     template<typename T>
     void bindDynamicUniformBuffer( uint32_t groupIndex, uint32_t binding, const T& data );
@@ -51,13 +62,19 @@ protected:
     // Reset dynamic upload buffers.
     void reset();
 
-    virtual void setBindGroup( uint32_t groupIndex, const BindGroup& bindGroup ) = 0;
+    virtual void setBindGroup( uint32_t groupIndex, const BindGroup& bindGroup,
+                               const std::vector<uint32_t>& dynamicOffsets ) = 0;
     std::shared_ptr<BindGroup> getBindGroup( uint32_t groupIndex );
 
     void commitBindGroups();
 
     WGPUCommandEncoder commandEncoder = nullptr;
+    // The bind groups that are set before a draw or dispatch.
     std::vector<std::shared_ptr<BindGroup>> bindGroups;
+    // The dynamic offsets of the prebuilt bind groups.
+    std::vector<std::vector<uint32_t>> bindGroupOffsets;
+    // The bind groups of the resources that are bound with the bind functions.
+    std::vector<std::shared_ptr<BindGroup>> dynamicBindGroups;
     std::unique_ptr<UploadBuffer>           uniformUploadBuffer;
     std::unique_ptr<UploadBuffer>           storageUploadBuffer;
 };
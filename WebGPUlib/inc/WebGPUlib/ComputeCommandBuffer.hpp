@@ -2,9 +2,13 @@
 
 #include "CommandBuffer.hpp"
 
+#include <vector>
+
 namespace WebGPUlib
 {
+class Buffer;
 class ComputePipelineState;
+class Texture;
 
 class ComputeCommandBuffer : public CommandBuffer
 {
@@ -15,10 +19,29 @@ public:
     ComputeCommandBuffer& operator=( const ComputeCommandBuffer& ) = delete;
     ComputeCommandBuffer& operator=( ComputeCommandBuffer&& )      = delete;
 
+    // Set the pipeline state for the following dispatches. If the pipeline is not ready yet
+    // (see ComputePipelineState::isReady), the dispatches are skipped until another pipeline state is set.
     void setComputePipeline( ComputePipelineState& pipeline );
 
     void dispatch( uint32_t x, uint32_t y = 1, uint32_t z = 1 );
 
+    // Copy a buffer to a mip of a texture. Copies cannot be recorded during a compute pass,
+    // so the copy is recorded when the command buffer is finished (after all dispatches).
+    // The buffer and the texture must stay alive until the command buffer is submitted.
+    void copyBufferToTexture( const Buffer& buffer, uint64_t offset, uint32_t bytesPerRow, const Texture& texture,
+                              uint32_t mip );
+
+    // Copy a mip of a texture to the same mip of another texture (after all dispatches, like copyBufferToTexture).
+    // The textures must have the same size and copy-compatible formats (for example, rgba8unorm and rgba8unorm-srgb).
+    // The mip is copied to destinationLayer if the destination is a texture array.
+    void copyTextureToTexture( const Texture& source, const Texture& destination, uint32_t mip,
+                               uint32_t destinationLayer = 0 );
+
+    // Copy a mip of a texture to a different mip of another texture. The mips must have the same size
+    // (for example, mip 1 of a texture and mip 0 of a texture that is half as large).
+    void copyTextureToTexture( const Texture& source, uint32_t sourceMip, const Texture& destination,
+                               uint32_t destinationMip, uint32_t destinationLayer = 0 );
+
     WGPUComputePassEncoder getWGPUPassEncoder() const
     {
         return passEncoder;
@@ -28,12 +51,29 @@ protected:
     ComputeCommandBuffer( WGPUCommandEncoder&& encoder, WGPUComputePassEncoder&& passEncoder );
     ~ComputeCommandBuffer() override;
 
-    void setBindGroup( uint32_t groupIndex, const BindGroup& bindGroup ) override;
+    void setBindGroup( uint32_t groupIndex, const BindGroup& bindGroup,
+                       const std::vector<uint32_t>& dynamicOffsets ) override;
 
     WGPUCommandBuffer finish() override;
 
 private:
-    WGPUComputePassEncoder passEncoder          = nullptr;
-    ComputePipelineState*  currentPipelineState = nullptr;
+    struct BufferToTextureCopy
+    {
+        WGPUImageCopyBuffer  source {};
+        WGPUImageCopyTexture destination {};
+        WGPUExtent3D         size {};
+    };
+
+    struct TextureToTextureCopy
+    {
+        WGPUImageCopyTexture source {};
+        WGPUImageCopyTexture destination {};
+        WGPUExtent3D         size {};
+    };
+
+    WGPUComputePassEncoder            passEncoder          = nullptr;
+    ComputePipelineState*             currentPipelineState = nullptr;
+    std::vector<BufferToTextureCopy>  pendingCopies;
+    std::vector<TextureToTextureCopy> pendingTextureCopies;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
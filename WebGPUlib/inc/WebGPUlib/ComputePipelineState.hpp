@@ -1,7 +1,11 @@
 #pragma once
 
+#include "Hash.hpp"
+
 #include <webgpu/webgpu.h>
 
+#include <vector>
+
 namespace WebGPUlib
 {
 
@@ -15,12 +19,21 @@ public:
     ComputePipelineState& operator=( const ComputePipelineState& )     = delete;
     ComputePipelineState& operator=( ComputePipelineState&& ) noexcept = delete;
 
+    // Get the pipeline (nullptr if the pipeline is created in the background and is not ready yet).
     WGPUComputePipeline getWGPUComputePipeline() const
     {
         return pipeline;
     }
 
-    virtual WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex ) = 0;
+    // Check if the pipeline is ready. Pipelines that are created in the background (see
+    // Device::getComputePipelineAsync) are not ready until they are compiled. The command buffer skips
+    // the dispatches with a pipeline state that is not ready.
+    bool isReady();
+
+    virtual WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex )
+    {
+        return groupIndex < bindGroupLayouts.size() ? bindGroupLayouts[groupIndex] : nullptr;
+    }
 
 protected:
     friend class ComputeCommandBuffer;
@@ -30,6 +43,11 @@ protected:
 
     virtual void bind( ComputeCommandBuffer& commandBuffer ) = 0;
 
+    // The pipeline is owned by the device (see Device::getComputePipeline).
     WGPUComputePipeline pipeline = nullptr;
+    // The key of the descriptor of a pipeline that is created in the background (empty otherwise).
+    PipelineKey pipelineKey;
+    // The bind group layouts of the pipeline (see Device::getPipelineLayout). The layouts are owned by the device.
+    std::vector<WGPUBindGroupLayout> bindGroupLayouts;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
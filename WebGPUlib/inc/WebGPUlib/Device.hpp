@@ -1,9 +1,17 @@
 #pragma once
 
+#include "Hash.hpp"
+#include "TextureData.hpp"
+
 #include <filesystem>
 #include <webgpu/webgpu.h>
 
+#include <array>
+#include <future>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 struct SDL_Window;
@@ -11,18 +19,135 @@ struct SDL_Window;
 namespace WebGPUlib
 {
 
+class AssetArchive;
 class BindGroup;
+class FileReader;
 class Queue;
 class IndexBuffer;
+class Material;
+class MaterialTable;
 class Mesh;
+class PipelineCache;
 class Sampler;
 class Scene;
+class ShaderReflection;
 class Surface;
 class StorageBuffer;
 class Texture;
+class ThreadPool;
 class UniformBuffer;
 class VertexBuffer;
+class GenerateMipsBlitPipelineState;
 class GenerateMipsPipelineState;
+class GenerateMipsSinglePassPipelineState;
+class GeometryStreamer;
+class TextureStreamer;
+class TextureView;
+
+// The method that is used to generate the mips of a texture on the GPU.
+enum class MipGenerator
+{
+    // Generate at most 4 mips per dispatch (one dispatch for every 4 mips of the texture).
+    MultiPass,
+    // Generate up to 12 mips with two dispatches in a single compute pass. Textures with more mips
+    // (larger than 4096x4096) fall back to the multi pass generator.
+    SinglePass,
+};
+
+// Options that control how a texture is loaded with Device::loadTexture.
+struct TextureLoadOptions
+{
+    // Compress the texture with BCn block compression. The compressed texture (including all mips)
+    // is cached in a .dds file next to the source file for faster loading next time.
+    // If the device does not support WGPUFeatureName_TextureCompressionBC, the compressed
+    // texture is transcoded to RGBA8 when it is loaded.
+    bool compress = false;
+
+    // Generate the mips on the CPU and cache them with the texture in a .dds file.
+    // Loading the cached texture is a pure upload without any compute work and the
+    // mips are identical on every backend. Compressed textures always use CPU mips.
+    // Otherwise, the mips are generated on the GPU every time the texture is loaded.
+    bool precomputeMips = false;
+
+    // The filter that is used for CPU mips.
+    MipFilter mipFilter = MipFilter::Box;
+
+    // The color channels of the texture are sRGB encoded (for example, diffuse textures).
+    // CPU mips are filtered in linear space. The texture is still created with a linear format.
+    bool sRGB = false;
+
+    // Queue the GPU mip generation with Device::enqueueGenerateMips instead of generating the
+    // mips immediately. Device::flushGenerateMips must be called before the texture is used.
+    bool deferMips = false;
+
+    // The texture is a tangent-space normal map. Compressed normal maps only store the
+    // x and y components of the normals (BC5). The z component must be reconstructed in the shader.
+    bool normalMap = false;
+
+    // Keep the channel count of grayscale images: single channel images are loaded as R8Unorm
+    // and grayscale images with alpha as RG8Unorm (see getChannelFormat). Shaders must swizzle
+    // these textures (see TextureSwizzle). Compressed textures and normal maps always use 4 channels.
+    bool keepChannelCount = true;
+};
+
+// Options that control how a scene is imported with Device::loadScene.
+struct SceneImportOptions
+{
+    // Store the vertices of a mesh in the compact VertexPositionQTangentTexture layout
+    // if the mesh can be encoded without noticeable loss of precision.
+    // Otherwise, the VertexPositionNormalTangentBitangentTexture layout is used.
+    // loadScene reports the vertex memory with and without the compact layout. The effect on the
+    // vertex fetch bandwidth is not measured; compare the frame times with this option on and off.
+    bool compactVertices = true;
+
+    // Split meshes with more than 65536 vertices into submeshes that can be
+    // addressed with 16-bit indices. Otherwise, 32-bit indices are used for these meshes.
+    bool splitLargeMeshes = false;
+
+    // The number of (additional) levels of detail that are generated for each mesh.
+    // Each level of detail has about lodReduction times the triangles of the previous level.
+    // Generation stops early if a mesh cannot be simplified any further.
+    uint32_t numLODs      = 0;
+    float    lodReduction = 0.5f;
+
+    // Build meshlets for each mesh (see Mesh::setMeshlets) to support GPU meshlet culling.
+    bool buildMeshlets = false;
+
+    // Compress the textures of the materials (see TextureLoadOptions::compress).
+    bool compressTextures = true;
+
+    // Generate the mips of uncompressed textures on the CPU (see TextureLoadOptions::precomputeMips).
+    bool precomputeMips = false;
+
+    // Pack the grayscale specular, specular power and opacity textures of a material into the red, green
+    // and blue channels of a single texture (see Device::loadPackedTexture). The packed texture is bound to
+    // TextureSlot::Packed and the shader reads the packed slots from its channels. Packed textures are
+    // not compressed.
+    bool packTextures = true;
+
+    // Combine the material textures with the same size, format and mip count into texture arrays
+    // (see Device::createTextureArrays). Shaders must sample all material textures as texture_2d_array.
+    bool textureArrays = false;
+
+    // Stream the mips of the cooked (DDS) material textures with this texture streamer (see TextureStreamer).
+    // Textures that have not been cooked yet are loaded with all mips (and cooked for the next import).
+    // Streamed textures are not combined into texture arrays.
+    TextureStreamer* textureStreamer = nullptr;
+
+    // Stream the vertex and index data of the meshes with this geometry streamer (see GeometryStreamer).
+    // Only a proxy (the lowest level of detail) of each mesh is uploaded at import. Streamed meshes are not
+    // shared between different meshes with identical geometry.
+    GeometryStreamer* geometryStreamer = nullptr;
+};
+
+// Options that control how the device is created with Device::create.
+struct DeviceOptions
+{
+    // Persist the compiled shaders and pipelines of the backend in this directory (see PipelineCache),
+    // so they are not compiled again the next time the application is started.
+    // The cache is disabled if the path is empty or the backend does not support it (only Dawn does).
+    std::filesystem::path pipelineCachePath;
+};
 
 class Device
 {
@@ -33,7 +158,7 @@ public:
     Device& operator=( const Device& ) = delete;
     Device& operator=( Device&& )      = delete;
 
-    static void    create( SDL_Window* window );
+    static void    create( SDL_Window* window, const DeviceOptions& options = {} );
     static void    destroy();
     static Device& get();
 
@@ -48,11 +173,69 @@ public:
 
     std::shared_ptr<Texture> createTexture( const WGPUTextureDescriptor& textureDescriptor );
 
-    std::shared_ptr<Texture> loadTexture( const std::filesystem::path& filePath );
-
+    // Create a texture and upload all of the mips in textureData.
+    std::shared_ptr<Texture> createTexture( const TextureData& textureData, const char* label = nullptr );
+
+    // Load a texture from an image file. DDS files are loaded directly (including their mips)
+    // and all other files are loaded with stb_image. Block compressed DDS files are
+    // transcoded to RGBA8 if the device does not support block compressed textures.
+    std::shared_ptr<Texture> loadTexture( const std::filesystem::path& filePath,
+                                          const TextureLoadOptions&    options = {} );
+
+    // Mount an asset archive (see AssetArchive). The files in the archive are found at their paths relative
+    // to rootPath and take precedence over the files on disk when textures and scenes are loaded, unless the file
+    // on disk was modified after the archive was created. Cooked files (like the preprocessed scene and the cooked
+    // textures) in an archive are only used if they are newer than their sources (see isUpToDate).
+    bool mountArchive( const std::filesystem::path& archivePath, const std::filesystem::path& rootPath );
+
+    // Get the data of a file that is stored uncompressed in a mounted archive (see AssetArchive::getMappedData).
+    // The data stays valid as long as the device. Returns nullptr if the file is not in an archive or is compressed.
+    const uint8_t* getMappedFile( const std::filesystem::path& filePath, std::size_t& size ) const;
+
+    // Start reading a whole file from a mounted archive (decompressed on a worker thread) or from disk.
+    // Unlike the files that are prefetched while a scene is loaded, the file is not cached by the device.
+    std::future<std::vector<uint8_t>> readFileAsync( const std::filesystem::path& filePath ) const;
+
+    // Load up to 4 grayscale images and pack them into the channels of a single RGBA8 texture
+    // (see packTextureChannels). Empty paths leave the channel white. If precomputeMips is set in the
+    // options, the packed texture is cached in a .dds file next to the first image.
+    // Returns nullptr if an image could not be loaded or is not grayscale.
+    std::shared_ptr<Texture> loadPackedTexture( const std::array<std::filesystem::path, 4>& filePaths,
+                                                const TextureLoadOptions&                    options = {} );
+
+    // Generate the mips of a texture on the GPU (and submit the command buffer).
+    // Textures with a storage texture format (see GenerateMipsPipelineState::isStorageFormat) require the
+    // WGPUTextureUsage_StorageBinding usage flag and rgba8unorm-srgb textures require WGPUTextureUsage_CopyDst.
+    // The mips of all other formats are rendered, which requires WGPUTextureUsage_RenderAttachment.
     void generateMips( Texture& texture );
 
-    std::shared_ptr<Scene> loadScene( const std::filesystem::path& filePath );
+    // Queue a texture for mip generation. The mips of all queued textures are
+    // generated in a single compute pass and submission by flushGenerateMips.
+    void enqueueGenerateMips( std::shared_ptr<Texture> texture );
+    void flushGenerateMips();
+
+    // Select the method that is used to generate mips on the GPU (MipGenerator::SinglePass by default).
+    void setMipGenerator( MipGenerator generator ) noexcept
+    {
+        mipGenerator = generator;
+    }
+
+    MipGenerator getMipGenerator() const noexcept
+    {
+        return mipGenerator;
+    }
+
+    std::shared_ptr<Scene> loadScene( const std::filesystem::path& filePath, const SceneImportOptions& options = {} );
+
+    // Copy the textures of the materials that have the same size, format and mip count into texture arrays
+    // and replace the textures of the materials with the texture arrays. The layer of each texture is
+    // stored in the texture flags of the material (see Material::setTexture). Materials that use different
+    // layers of the same texture arrays bind the same textures, so they can share a bind group.
+    // Only textures with the WGPUTextureUsage_CopySrc usage flag (like the textures loaded with
+    // loadTexture) are combined. The textures of textureStreamer are replaced when their mips are streamed,
+    // so they are never combined.
+    void createTextureArrays( const std::vector<std::shared_ptr<Material>>& materials,
+                              const TextureStreamer*                        textureStreamer = nullptr );
 
     template<typename T>
     std::shared_ptr<VertexBuffer> createVertexBuffer( const std::vector<T>& vertices ) const;
@@ -61,8 +244,24 @@ public:
 
     template<typename T>
     std::shared_ptr<IndexBuffer> createIndexBuffer( const std::vector<T>& indices ) const;
+    // Use extraUsage to add additional usage flags to the buffer (for example, WGPUBufferUsage_Storage
+    // to write the indices in a compute shader).
     std::shared_ptr<IndexBuffer> createIndexBuffer( const void* indexData, std::size_t indexCount,
-                                                    std::size_t indexStride ) const;
+                                                    std::size_t          indexStride,
+                                                    WGPUBufferUsageFlags extraUsage = WGPUBufferUsage_None ) const;
+
+    // Create an index buffer with 16-bit indices if all vertices can be addressed
+    // with 16-bit indices (vertexCount <= 65536), otherwise 32-bit indices are used.
+    std::shared_ptr<IndexBuffer> createCompactIndexBuffer( const std::vector<uint32_t>& indices,
+                                                           std::size_t                  vertexCount ) const;
+
+    // Create a vertex or index buffer that references a range of an existing buffer (starting at offset).
+    // The buffer must have been created with the vertex or index usage flag. The returned buffer keeps a
+    // reference to the existing buffer. Used to sub-allocate meshes from the arenas of the GeometryStreamer.
+    std::shared_ptr<VertexBuffer> createVertexBufferRange( WGPUBuffer buffer, std::size_t offset,
+                                                           std::size_t vertexCount, std::size_t vertexStride ) const;
+    std::shared_ptr<IndexBuffer>  createIndexBufferRange( WGPUBuffer buffer, std::size_t offset,
+                                                          std::size_t indexCount, std::size_t indexStride ) const;
 
     template<typename T>
     std::shared_ptr<UniformBuffer> createUniformBuffer( const T& data ) const;
@@ -70,7 +269,9 @@ public:
 
     template<typename T>
     std::shared_ptr<StorageBuffer> createStorageBuffer( const std::vector<T>& data ) const;
-    std::shared_ptr<StorageBuffer> createStorageBuffer( const void* data, std::size_t elementCount, std::size_t elementSize ) const;
+    // Use extraUsage to add additional usage flags to the buffer (for example, WGPUBufferUsage_Indirect).
+    std::shared_ptr<StorageBuffer> createStorageBuffer( const void* data, std::size_t elementCount, std::size_t elementSize,
+                                                        WGPUBufferUsageFlags extraUsage = WGPUBufferUsage_None ) const;
 
     std::shared_ptr<Sampler> createSampler( const WGPUSamplerDescriptor& samplerDescriptor ) const;
 
@@ -80,6 +281,98 @@ public:
 
     void poll( bool sleep = false );
 
+    // Block until all work that was submitted to the queue is done.
+    void waitIdle();
+
+    // Check if a feature was enabled when the device was created.
+    bool hasFeature( WGPUFeatureName feature ) const;
+
+    // Get the worker threads that are used to load and process assets.
+    ThreadPool& getThreadPool() const noexcept
+    {
+        return *threadPool;
+    }
+
+    // Get the reader that is used to read asset files asynchronously.
+    FileReader& getFileReader() const noexcept
+    {
+        return *fileReader;
+    }
+
+    // Get the persistent cache of the compiled shaders and pipelines (see DeviceOptions::pipelineCachePath).
+    // Returns nullptr if the cache is disabled.
+    const PipelineCache* getPipelineCache() const noexcept
+    {
+        return pipelineCache.get();
+    }
+
+    // Get the table that stores the properties of all materials on the GPU.
+    // The materials of loaded scenes are added to this table.
+    MaterialTable& getMaterialTable() const noexcept
+    {
+        return *materialTable;
+    }
+
+    // Get a bind group layout with the given entries. Bind group layouts are cached by their entries,
+    // so pipelines with identical bind group layouts share the layout object and the bind groups that were
+    // created for one pipeline can be used with the other pipelines. The layouts are owned by the device.
+    WGPUBindGroupLayout getBindGroupLayout( const std::vector<WGPUBindGroupLayoutEntry>& entries );
+
+    // Get the layout of a pipeline from the resources that are declared in its shader code.
+    // The (cached) bind group layouts of the pipeline are returned in bindGroupLayouts.
+    // Pipeline layouts are cached by their bind group layouts and owned by the device.
+    WGPUPipelineLayout getPipelineLayout( const ShaderReflection&           reflection,
+                                          std::vector<WGPUBindGroupLayout>& bindGroupLayouts,
+                                          const char*                       label = nullptr );
+
+    // Get a shader module for the WGSL shader code. Shader modules are cached by their code,
+    // so a shader is only compiled once. The shader modules are owned by the device.
+    WGPUShaderModule getShaderModule( const char* shaderCode, const char* label = nullptr );
+
+    // Get a pipeline for the pipeline descriptor. Pipelines are cached by the fields of the descriptor
+    // (see PipelineKey in Hash.hpp), so pipeline states with identical descriptors share the same pipeline object.
+    // The shader modules and the layout of the descriptor are keyed by their handle, so use the cached
+    // objects (see getShaderModule and getPipelineLayout). The pipelines are owned by the device.
+    WGPURenderPipeline  getRenderPipeline( const WGPURenderPipelineDescriptor& pipelineDesc );
+    WGPUComputePipeline getComputePipeline( const WGPUComputePipelineDescriptor& pipelineDesc );
+
+    // Start creating a pipeline in the background (unless it is already cached or being created) and return
+    // the key of the descriptor. Use findRenderPipeline or findComputePipeline to get the pipeline when it
+    // is ready. The creation completes while the device is polled (see poll).
+    // wgpu-native does not support asynchronous pipeline creation, so the pipeline is created immediately.
+    PipelineKey getRenderPipelineAsync( const WGPURenderPipelineDescriptor& pipelineDesc );
+    PipelineKey getComputePipelineAsync( const WGPUComputePipelineDescriptor& pipelineDesc );
+
+    // Get a cached pipeline by the key of its descriptor. Returns nullptr if the pipeline is not ready (yet).
+    WGPURenderPipeline  findRenderPipeline( const PipelineKey& pipelineKey ) const;
+    WGPUComputePipeline findComputePipeline( const PipelineKey& pipelineKey ) const;
+
+    // Get the number of pipelines that are being created in the background.
+    std::size_t getNumPendingPipelines() const noexcept
+    {
+        return pendingRenderPipelines.size() + pendingComputePipelines.size();
+    }
+
+    // Block until all pipelines that are created in the background are ready.
+    void waitForPipelines();
+
+    // Get the layout of the material bind groups (see Material::getBindGroup).
+    // Pipelines that use the material bind groups must use this layout for the material bind group index:
+    //   @binding( 0 ) var<uniform> material : Material;
+    //   @binding( 0 ) is bound with a dynamic offset (see Material::getBindGroupOffset).
+    //   @binding( 1 - 9 ) the textures of the material in the order of the TextureSlot enum (texture_2d_array<f32>).
+    //   @binding( 10 ) var materialSampler : sampler;
+    WGPUBindGroupLayout getMaterialBindGroupLayout() const noexcept
+    {
+        return materialBindGroupLayout;
+    }
+
+    // Get the sampler that is used to sample the material textures (linear filtering, repeat addressing).
+    std::shared_ptr<Sampler> getMaterialSampler() const
+    {
+        return materialSampler;
+    }
+
     WGPUInstance getWGPUInstance() const noexcept
     {
         return instance;
@@ -92,12 +385,53 @@ public:
 
 private:
     friend struct std::default_delete<Device>;
-    Device( SDL_Window* window );
+    Device( SDL_Window* window, const DeviceOptions& options );
     ~Device();
 
+    void generateMips( const std::vector<Texture*>& textures );
+    void generateMipsMultiPass( const std::vector<Texture*>& textures );
+    void generateMipsSinglePass( const std::vector<Texture*>& textures );
+    void generateMipsBlit( const std::vector<Texture*>& textures );
+
+    // The mip generation pipelines are created when they are first used and cached per texture format.
+    GenerateMipsPipelineState&     getGenerateMipsPipelineState( WGPUTextureFormat format );
+    GenerateMipsBlitPipelineState& getGenerateMipsBlitPipelineState( WGPUTextureFormat format );
+
+    // Get a view of the placeholder texture that is bound to unused mips.
+    std::shared_ptr<TextureView> getMipPlaceholderView( WGPUTextureFormat format, uint32_t mip );
+
+    // Get the sampler that is used to sample the source mips.
+    std::shared_ptr<Sampler> getMipSampler();
+
+    // Start reading a file that is loaded later (for example, the textures of a scene).
+    // Files in an archive are decompressed on the worker threads.
+    void prefetchFile( const std::filesystem::path& filePath );
+    // Read a whole file (from a mounted archive or from disk). Waits for the read if the file was prefetched.
+    std::vector<uint8_t> readFile( const std::filesystem::path& filePath );
+
+    // Check if a file exists in a mounted archive or on disk.
+    bool fileExists( const std::filesystem::path& filePath ) const;
+    // Check if a cooked file is newer than its source file.
+    bool isUpToDate( const std::filesystem::path& cachePath, const std::filesystem::path& sourcePath ) const;
+
     static void onDeviceLostCallback( WGPUDeviceLostReason reason, char const* message, void* userdata );
+
+    // The userdata of the asynchronous pipeline creation callbacks.
+    struct PipelineRequest
+    {
+        Device*     device;
+        PipelineKey pipelineKey;
+    };
+
+    static void onRenderPipelineCreated( WGPUCreatePipelineAsyncStatus status, WGPURenderPipeline pipeline,
+                                         const char* message, void* userdata );
+    static void onComputePipelineCreated( WGPUCreatePipelineAsyncStatus status, WGPUComputePipeline pipeline,
+                                          const char* message, void* userdata );
     static void onUncapturedErrorCallback( WGPUErrorType type, const char* message, void* userdata );
 
+    // The pipeline cache must outlive the WGPU device, because the device stores the compiled pipelines in it.
+    std::unique_ptr<PipelineCache> pipelineCache;
+
     WGPUInstance             instance = nullptr;
     WGPUAdapter              adapter  = nullptr;
     WGPUDevice               device   = nullptr;
@@ -106,7 +440,35 @@ private:
     std::shared_ptr<Texture> whiteTexture = nullptr;
     std::shared_ptr<Texture> magentaTexture = nullptr;
 
-    std::unique_ptr<GenerateMipsPipelineState> generateMipsPipelineState;
+    MipGenerator mipGenerator = MipGenerator::SinglePass;
+
+    std::unordered_map<WGPUTextureFormat, std::unique_ptr<GenerateMipsPipelineState>>     mipPipelineStates;
+    std::unordered_map<WGPUTextureFormat, std::unique_ptr<GenerateMipsBlitPipelineState>> mipBlitPipelineStates;
+    std::unordered_map<WGPUTextureFormat, std::shared_ptr<Texture>>                       mipPlaceholderTextures;
+
+    std::unique_ptr<GenerateMipsSinglePassPipelineState> generateMipsSinglePassPipelineState;
+    std::shared_ptr<Sampler>                             mipSampler;
+    std::shared_ptr<UniformBuffer>                       mipParamsBuffer;
+    std::shared_ptr<UniformBuffer>                       singlePassMipParamsBuffer;
+    std::shared_ptr<StorageBuffer>                       mipBuffer;
+    std::vector<std::shared_ptr<Texture>>                pendingMips;
+    std::unique_ptr<ThreadPool>                          threadPool;
+
+    std::unique_ptr<FileReader>                                        fileReader;
+    std::unordered_map<std::string, std::future<std::vector<uint8_t>>> prefetchedFiles;
+    std::vector<std::unique_ptr<AssetArchive>>                         archives;
+
+    std::unique_ptr<MaterialTable> materialTable;
+    WGPUBindGroupLayout            materialBindGroupLayout = nullptr;
+    std::shared_ptr<Sampler>       materialSampler;
+
+    std::unordered_map<std::vector<WGPUBindGroupLayoutEntry>, WGPUBindGroupLayout> bindGroupLayouts;
+    std::unordered_map<std::vector<WGPUBindGroupLayout>, WGPUPipelineLayout>       pipelineLayouts;
+    std::unordered_map<std::string, WGPUShaderModule>                              shaderModules;
+    std::unordered_map<PipelineKey, WGPURenderPipeline>                            renderPipelines;
+    std::unordered_map<PipelineKey, WGPUComputePipeline>                           computePipelines;
+    std::unordered_set<PipelineKey>                                                pendingRenderPipelines;
+    std::unordered_set<PipelineKey>                                                pendingComputePipelines;
 };
 
 template<typename T>
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+class ThreadPool;
+
+// Reads whole files asynchronously so that many reads are in flight while the calling thread
+// decodes the files that have already been read.
+//
+// On Linux, the reads are issued with io_uring from a dedicated I/O thread (up to queueDepth reads
+// are in flight at the same time). If io_uring is not available (on other platforms, or if the kernel
+// does not support it), each file is read on a worker thread of the thread pool.
+class FileReader
+{
+public:
+    explicit FileReader( ThreadPool& threadPool, uint32_t queueDepth = 64 );
+    ~FileReader();
+
+    FileReader( const FileReader& )            = delete;
+    FileReader( FileReader&& )                 = delete;
+    FileReader& operator=( const FileReader& ) = delete;
+    FileReader& operator=( FileReader&& )      = delete;
+
+    // Start reading a file. The future is ready when the whole file has been read into a buffer
+    // that is allocated with the size of the file. The buffer is empty if the file could not be read.
+    std::future<std::vector<uint8_t>> read( const std::filesystem::path& filePath );
+
+    // Read a file on the calling thread.
+    static std::vector<uint8_t> readFile( const std::filesystem::path& filePath );
+
+    // Check if the reads are issued with io_uring.
+    bool usesIoUring() const noexcept
+    {
+        return ioUring != nullptr;
+    }
+
+private:
+    struct IoUring;
+
+    struct Request
+    {
+        std::filesystem::path              filePath;
+        std::promise<std::vector<uint8_t>> promise;
+    };
+
+    // The I/O thread submits the queued requests to io_uring and completes the finished reads.
+    void ioThread();
+
+    ThreadPool&              threadPool;
+    std::unique_ptr<IoUring> ioUring;
+    uint32_t                 queueDepth = 0;
+
+    std::thread             thread;
+    std::queue<Request>     requests;
+    std::mutex              mutex;
+    std::condition_variable condition;
+    bool                    stop = false;
+};
+
+}  // namespace WebGPUlib
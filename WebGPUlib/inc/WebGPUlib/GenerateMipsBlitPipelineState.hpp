@@ -0,0 +1,25 @@
+#pragma once
+
+#include "GraphicsPipelineState.hpp"
+
+namespace WebGPUlib
+{
+// Generates a single mip by rendering to the mip. Used for texture formats that cannot
+// be written with storage textures (see GenerateMipsPipelineState::isStorageFormat).
+// The texture must have the WGPUTextureUsage_RenderAttachment usage flag.
+// A pipeline is created for each texture format.
+class GenerateMipsBlitPipelineState : public GraphicsPipelineState
+{
+public:
+    explicit GenerateMipsBlitPipelineState( WGPUTextureFormat format );
+    ~GenerateMipsBlitPipelineState() override;
+
+    GenerateMipsBlitPipelineState( const GenerateMipsBlitPipelineState& )                = delete;
+    GenerateMipsBlitPipelineState( GenerateMipsBlitPipelineState&& ) noexcept            = delete;
+    GenerateMipsBlitPipelineState& operator=( const GenerateMipsBlitPipelineState& )     = delete;
+    GenerateMipsBlitPipelineState& operator=( GenerateMipsBlitPipelineState&& ) noexcept = delete;
+
+protected:
+    void bind( GraphicsCommandBuffer& commandBuffer ) override;
+};
+}  // namespace WebGPUlib
@@ -15,10 +15,12 @@ struct Mip
     glm::vec2 texelSize { 0 };
 };
 
+// Generates up to 4 mips per dispatch. The mips are written with storage textures,
+// so a pipeline is created for each texture format (see isStorageFormat).
 class GenerateMipsPipelineState : public ComputePipelineState
 {
 public:
-    GenerateMipsPipelineState();
+    explicit GenerateMipsPipelineState( WGPUTextureFormat format = WGPUTextureFormat_RGBA8Unorm );
     ~GenerateMipsPipelineState() override;
     
     GenerateMipsPipelineState( const GenerateMipsPipelineState& )                = delete;
@@ -26,17 +28,10 @@ public:
     GenerateMipsPipelineState& operator=( const GenerateMipsPipelineState& )     = delete;
     GenerateMipsPipelineState& operator=( GenerateMipsPipelineState&& ) noexcept = delete;
 
-    WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex ) override
-    {
-        // This pipeline only has a single bind group.
-        return bindGroupLayout;
-    }
+    // Check if textures with this format can be written with storage textures (without optional features).
+    static bool isStorageFormat( WGPUTextureFormat format );
 
 protected:
     void bind( ComputeCommandBuffer& commandBuffer ) override;
-
-
-private:
-    WGPUBindGroupLayout bindGroupLayout    = nullptr;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
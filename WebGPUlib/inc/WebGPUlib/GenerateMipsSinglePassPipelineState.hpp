@@ -0,0 +1,42 @@
+#pragma once
+
+#include "ComputePipelineState.hpp"
+
+#include <cstdint>
+
+namespace WebGPUlib
+{
+// The parameters of the single pass mip generation compute shader.
+// This struct matches the layout of the SinglePassMipParams struct in GenerateMipsSinglePass.wgsl.
+struct SinglePassMipParams
+{
+    uint32_t width         = 0;    // The width of mip 0.
+    uint32_t height        = 0;    // The height of mip 0.
+    uint32_t numMips       = 0;    // The number of mips of the texture (including mip 0).
+    uint32_t srcLevel      = 0;    // The mip that is downsampled (0 in the first dispatch, 6 in the second).
+    uint32_t bufferOffsets[8] {};  // The offset (in texels) of mips 5-12 in the mip buffer.
+};
+
+// Generates up to 12 mips of a RGBA8 texture in a single compute pass.
+// Dispatch one workgroup per 64x64 tile of mip 0 (srcLevel 0) and, if the texture has more than 7 mips,
+// a single workgroup for mip 6 (srcLevel 6). Mips 1-4 are written to the texture and mips 5-12 are
+// written to the mip buffer and must be copied to the texture after the dispatches.
+class GenerateMipsSinglePassPipelineState : public ComputePipelineState
+{
+public:
+    // The maximum width and height of a texture whose mips can be generated in a single pass
+    // (mip 6 must fit in a single 64x64 tile).
+    static constexpr uint32_t MaxSize = 4096;
+
+    GenerateMipsSinglePassPipelineState();
+    ~GenerateMipsSinglePassPipelineState() override;
+
+    GenerateMipsSinglePassPipelineState( const GenerateMipsSinglePassPipelineState& )                = delete;
+    GenerateMipsSinglePassPipelineState( GenerateMipsSinglePassPipelineState&& ) noexcept            = delete;
+    GenerateMipsSinglePassPipelineState& operator=( const GenerateMipsSinglePassPipelineState& )     = delete;
+    GenerateMipsSinglePassPipelineState& operator=( GenerateMipsSinglePassPipelineState&& ) noexcept = delete;
+
+protected:
+    void bind( ComputeCommandBuffer& commandBuffer ) override;
+};
+}  // namespace WebGPUlib
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "Mesh.hpp"
+
+#include <webgpu/webgpu.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace WebGPUlib
+{
+class IndexBuffer;
+class StorageBuffer;
+class VertexBuffer;
+
+// Streams the vertex and index data of meshes from disk within a GPU memory budget.
+//
+// The geometry of the registered meshes is stored in a geometry file. Only the meshes that are requested
+// by the renderer (for example, the meshes near the camera or the meshes that pass culling) are resident.
+// The resident meshes are sub-allocated from a few large GPU buffers (arenas) so streaming a mesh does not
+// create any GPU buffers. Meshes are loaded on the worker threads of the device (closest meshes first)
+// and the least recently used meshes are evicted when the arenas are full.
+//
+// While a mesh is not resident, the mesh draws a small proxy that is created from its lowest level of detail.
+//
+// The geometry file is kept between runs. Each mesh in the file is stored with the hash and the size of its
+// geometry, so the stored geometry is reused as long as it matches the meshes that are added (in the same order).
+// The file is only rewritten from the first mesh that does not match. If the geometry file is stored
+// uncompressed in a mounted archive (see Device::mountArchive), the meshes are read from the mapped archive.
+class GeometryStreamer
+{
+public:
+    // The geometry file at filePath (or in a mounted archive) is reused if it is valid and created otherwise.
+    // The archive must be mounted before the geometry streamer is created.
+    explicit GeometryStreamer( const std::filesystem::path& filePath, uint64_t budget = 256ull * 1024 * 1024,
+                               uint64_t arenaSize = 32ull * 1024 * 1024 );
+    ~GeometryStreamer();
+
+    GeometryStreamer( const GeometryStreamer& )            = delete;
+    GeometryStreamer( GeometryStreamer&& )                 = delete;
+    GeometryStreamer& operator=( const GeometryStreamer& ) = delete;
+    GeometryStreamer& operator=( GeometryStreamer&& )      = delete;
+
+    // Write the geometry of a mesh to the geometry file (unless the file already stores it) and register the mesh
+    // for streaming. The levels of detail and the meshlets of the mesh must be set before the mesh is added.
+    // The buffers of the mesh are replaced with the proxy until the mesh is resident.
+    // Returns false (and the mesh is not changed) if the mesh is not indexed, does not fit in an arena or has
+    // fewer than 2 levels of detail (the proxy would be the full geometry, so the mesh must stay resident).
+    bool addMesh( const std::shared_ptr<Mesh>& mesh, const void* vertexData, std::size_t vertexCount,
+                  std::size_t vertexStride, const void* indexData, std::size_t indexCount, std::size_t indexStride );
+
+    // Request the full geometry of a mesh for the current frame.
+    // Meshes with a smaller distance to the camera are loaded first.
+    void request( const Mesh& mesh, float distance );
+
+    // Check if the full geometry of a mesh is resident (meshes that are not streamed are always resident).
+    bool isResident( const Mesh& mesh ) const;
+
+    // Swap the meshes that have been loaded, evict meshes that are no longer used and start loading
+    // the requested meshes. Must be called once per frame (after the meshes are requested).
+    void update();
+
+    // The maximum size (in bytes) of the arenas. If the arenas exceed a smaller budget, the last arenas
+    // are released and the meshes in them are evicted (or their loads are discarded).
+    void setBudget( uint64_t budget );
+
+    uint64_t getBudget() const noexcept
+    {
+        return budget;
+    }
+
+    // The size (in bytes) of the geometry of the resident (or loading) meshes.
+    uint64_t getResidentSize() const noexcept
+    {
+        return residentSize;
+    }
+
+    // The size (in bytes) of the proxies (which are always resident).
+    uint64_t getProxySize() const noexcept
+    {
+        return proxySize;
+    }
+
+private:
+    // A large GPU buffer that stores the geometry of many meshes.
+    struct Arena
+    {
+        WGPUBuffer buffer = nullptr;
+        // The free ranges of the arena (offset -> size).
+        std::map<uint64_t, uint64_t> freeRanges;
+    };
+
+    struct Allocation
+    {
+        uint32_t arena  = UINT32_MAX;
+        uint64_t offset = 0;
+        uint64_t size   = 0;
+    };
+
+    struct StreamedMesh
+    {
+        std::weak_ptr<Mesh> mesh;
+
+        // The location of the geometry in the geometry file.
+        uint64_t    fileOffset   = 0;
+        std::size_t vertexCount  = 0;
+        std::size_t vertexStride = 0;
+        std::size_t indexCount   = 0;
+        std::size_t indexStride  = 0;
+
+        // The levels of detail and meshlets of the full geometry.
+        std::vector<MeshLOD>           lods;
+        std::shared_ptr<StorageBuffer> meshletBuffer;
+        std::shared_ptr<StorageBuffer> meshletIndexBuffer;
+
+        // The proxy that is drawn while the mesh is not resident.
+        std::shared_ptr<VertexBuffer> proxyVertexBuffer;
+        std::shared_ptr<IndexBuffer>  proxyIndexBuffer;
+        std::vector<MeshLOD>          proxyLODs;
+
+        Allocation allocation;
+        bool       resident = false;
+
+        // The distance of the closest instance in the frame the mesh was last requested.
+        float    distance      = 0.0f;
+        uint64_t lastUsedFrame = 0;
+
+        // The geometry that is loaded on a worker thread.
+        std::future<std::vector<uint8_t>> pendingLoad;
+    };
+
+    // The size of the geometry of a mesh in an arena (the indices follow the 4-byte aligned vertices).
+    static uint64_t getVertexDataSize( const StreamedMesh& mesh );
+    static uint64_t getAllocationSize( const StreamedMesh& mesh );
+
+    bool allocate( uint64_t size, Allocation& allocation );
+    void deallocate( Allocation& allocation );
+
+    // Create the buffers of a mesh in its allocation (after the geometry has been uploaded).
+    void makeResident( StreamedMesh& streamedMesh );
+    // Replace the buffers of a mesh with its proxy and free its allocation.
+    void evict( StreamedMesh& streamedMesh );
+
+    // The record that precedes the geometry of each mesh in the geometry file.
+    struct GeometryRecord
+    {
+        uint64_t hash;
+        uint64_t vertexDataSize;
+        uint64_t indexDataSize;
+    };
+
+    // Open (or create) the geometry file on disk.
+    void openFile();
+    // Check if the geometry file stores a record at the end of the added geometry.
+    bool isStored( const GeometryRecord& record );
+    // Write a record and its geometry at the end of the added geometry (the stale geometry after it is discarded).
+    bool write( const GeometryRecord& record, const void* vertexData, const void* indexData );
+
+    std::filesystem::path filePath;
+    std::fstream          file;
+    // The size of the geometry that has been added (the offset of the next mesh in the geometry file).
+    uint64_t fileSize = 0;
+    // The size of the geometry file. The geometry after fileSize is reused if it matches the added meshes.
+    uint64_t storedSize = 0;
+
+    // The geometry file in a mounted archive (nullptr if the geometry file is read from disk).
+    const uint8_t* archiveData = nullptr;
+
+    std::vector<Arena>                           arenas;
+    std::vector<StreamedMesh>                    meshes;
+    std::unordered_map<const Mesh*, std::size_t> meshIndices;
+
+    uint64_t budget       = 0;
+    uint64_t arenaSize    = 0;
+    uint64_t residentSize = 0;
+    uint64_t proxySize    = 0;
+    uint64_t frame        = 1;
+
+    // Meshes that were not requested for this number of frames are evicted.
+    uint64_t evictFrames = 120;
+    // The maximum number of meshes that are loaded at the same time.
+    uint32_t maxPendingLoads = 8;
+};
+}  // namespace WebGPUlib
@@ -4,7 +4,9 @@
 
 namespace WebGPUlib
 {
+class Buffer;
 class GraphicsPipelineState;
+class IndexBuffer;
 class Mesh;
 
 class GraphicsCommandBuffer : public CommandBuffer
@@ -16,9 +18,25 @@ public:
     GraphicsCommandBuffer& operator=( const GraphicsCommandBuffer& ) = delete;
     GraphicsCommandBuffer& operator=( GraphicsCommandBuffer&& )      = delete;
 
+    // Set the pipeline state for the following draws. If the pipeline is not ready yet
+    // (see GraphicsPipelineState::isReady), the draws are skipped until another pipeline state is set.
     void setGraphicsPipeline( GraphicsPipelineState& pipeline );
 
-    void draw( const Mesh& mesh );
+    // Draw a mesh. Use instanceCount > 1 to draw multiple instances of the mesh.
+    // The instance index in the shader starts at firstInstance.
+    // If the mesh has levels of detail, the index range of the requested LOD is drawn.
+    void draw( const Mesh& mesh, uint32_t instanceCount = 1, uint32_t firstInstance = 0, uint32_t lod = 0 );
+
+    // Draw vertices without vertex buffers (for example, a full screen triangle
+    // that is generated in the vertex shader from the vertex index).
+    void draw( uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0,
+               uint32_t firstInstance = 0 );
+
+    // Draw the vertices of a mesh using the index buffer and the draw arguments
+    // (DrawIndexedIndirectArgs) in indirectBuffer at indirectOffset.
+    // This is used to draw the visible meshlets of a mesh after meshlet culling.
+    void drawIndexedIndirect( const Mesh& mesh, const IndexBuffer& indexBuffer, const Buffer& indirectBuffer,
+                              uint64_t indirectOffset = 0 );
 
     WGPURenderPassEncoder getWGPUPassEncoder() const
     {
@@ -29,11 +47,15 @@ protected:
     GraphicsCommandBuffer( WGPUCommandEncoder&& encoder, WGPURenderPassEncoder&& passEncoder );
     ~GraphicsCommandBuffer() override;
 
-    void setBindGroup( uint32_t groupIndex, const BindGroup& bindGroup ) override;
+    void setBindGroup( uint32_t groupIndex, const BindGroup& bindGroup,
+                       const std::vector<uint32_t>& dynamicOffsets ) override;
 
     WGPUCommandBuffer finish() override;
 
 private:
+    // Check if the current pipeline state is ready to draw.
+    bool isPipelineReady() const;
+
     WGPURenderPassEncoder  passEncoder          = nullptr;
     GraphicsPipelineState* currentPipelineState = nullptr;
 };
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "Hash.hpp"
+
 #include <webgpu/webgpu.h>
 
+#include <vector>
+
 namespace WebGPUlib
 {
 class GraphicsCommandBuffer;
@@ -14,12 +18,21 @@ public:
     GraphicsPipelineState& operator=( const GraphicsPipelineState& )     = delete;
     GraphicsPipelineState& operator=( GraphicsPipelineState&& ) noexcept = delete;
 
+    // Get the pipeline (nullptr if the pipeline is created in the background and is not ready yet).
     WGPURenderPipeline getWGPURenderPipeline() const
     {
         return pipeline;
     }
 
-    virtual WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex ) = 0;
+    // Check if the pipeline is ready. Pipelines that are created in the background (see
+    // Device::getRenderPipelineAsync) are not ready until they are compiled. The command buffer skips
+    // the draws with a pipeline state that is not ready.
+    bool isReady();
+
+    virtual WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex )
+    {
+        return groupIndex < bindGroupLayouts.size() ? bindGroupLayouts[groupIndex] : nullptr;
+    }
 
 protected:
 
@@ -30,6 +43,11 @@ protected:
 
     virtual void bind( GraphicsCommandBuffer& commandBuffer ) = 0;
 
+    // The pipeline is owned by the device (see Device::getRenderPipeline).
     WGPURenderPipeline pipeline = nullptr;
+    // The key of the descriptor of a pipeline that is created in the background (empty otherwise).
+    PipelineKey pipelineKey;
+    // The bind group layouts of the pipeline (see Device::getPipelineLayout). The layouts are owned by the device.
+    std::vector<WGPUBindGroupLayout> bindGroupLayouts;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
@@ -2,7 +2,47 @@
 
 #include <webgpu/webgpu.h>
 
+#include <cstdint>
 #include <functional> // std::hash
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WebGPUlib
+{
+// 64-bit FNV-1a hash of the bytes of a block of memory. Unlike std::hash, the result is the same on every
+// platform, so it can be stored in files. Pass the hash of the previous block to hash several blocks.
+inline uint64_t hashBytes( const void* data, std::size_t size, uint64_t hash = 0xcbf29ce484222325ull )
+{
+    const auto* bytes = static_cast<const uint8_t*>( data );
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Identifies a cached pipeline (see Device::getRenderPipeline and Device::getComputePipeline).
+// The key stores a copy of all the fields of the pipeline descriptor, so two descriptors with the same hash
+// are still compared on lookup and never share a pipeline. Labels are not part of the key. Objects
+// (like shader modules and pipeline layouts) are stored by their handle.
+struct PipelineKey
+{
+    std::size_t hash = 0;  // The hash of the fields.
+    std::string fields;    // The fields of the pipeline descriptor (strings and arrays are copied).
+
+    bool empty() const noexcept
+    {
+        return fields.empty();
+    }
+
+    bool operator==( const PipelineKey& other ) const noexcept
+    {
+        return hash == other.hash && fields == other.fields;
+    }
+};
+}  // namespace WebGPUlib
 
 namespace std
 {
@@ -31,6 +71,64 @@ struct hash<WGPUTextureViewDescriptor>
     }
 };
 
+template<>
+struct hash<WGPUBindGroupLayoutEntry>
+{
+    std::size_t operator()( const WGPUBindGroupLayoutEntry& entry ) const noexcept
+    {
+        std::size_t seed = 0;
+        hash_combine( seed, entry.binding );
+        hash_combine( seed, entry.visibility );
+        hash_combine( seed, entry.buffer.type );
+        hash_combine( seed, entry.buffer.hasDynamicOffset );
+        hash_combine( seed, entry.buffer.minBindingSize );
+        hash_combine( seed, entry.sampler.type );
+        hash_combine( seed, entry.texture.sampleType );
+        hash_combine( seed, entry.texture.viewDimension );
+        hash_combine( seed, entry.texture.multisampled );
+        hash_combine( seed, entry.storageTexture.access );
+        hash_combine( seed, entry.storageTexture.format );
+        hash_combine( seed, entry.storageTexture.viewDimension );
+        return seed;
+    }
+};
+
+// Used to look up bind group layouts by their entries.
+template<>
+struct hash<std::vector<WGPUBindGroupLayoutEntry>>
+{
+    std::size_t operator()( const std::vector<WGPUBindGroupLayoutEntry>& entries ) const noexcept
+    {
+        std::size_t seed = entries.size();
+        for ( const auto& entry: entries )
+            hash_combine( seed, entry );
+        return seed;
+    }
+};
+
+// Used to look up pipeline layouts by their bind group layouts.
+template<>
+struct hash<std::vector<WGPUBindGroupLayout>>
+{
+    std::size_t operator()( const std::vector<WGPUBindGroupLayout>& bindGroupLayouts ) const noexcept
+    {
+        std::size_t seed = bindGroupLayouts.size();
+        for ( auto bindGroupLayout: bindGroupLayouts )
+            hash_combine( seed, bindGroupLayout );
+        return seed;
+    }
+};
+
+// Used to look up pipelines by their key. The hash of the fields is computed when the key is created.
+template<>
+struct hash<WebGPUlib::PipelineKey>
+{
+    std::size_t operator()( const WebGPUlib::PipelineKey& key ) const noexcept
+    {
+        return key.hash;
+    }
+};
+
 }  // namespace std
 
 inline bool operator<( const WGPUTextureViewDescriptor& lhs, const WGPUTextureViewDescriptor& rhs ) noexcept
@@ -65,4 +163,20 @@ inline bool operator==( const WGPUTextureViewDescriptor& lhs, const WGPUTextureV
         && lhs.mipLevelCount == rhs.mipLevelCount
         && lhs.baseArrayLayer == rhs.baseArrayLayer
         && lhs.arrayLayerCount == rhs.arrayLayerCount;
+}
+
+inline bool operator==( const WGPUBindGroupLayoutEntry& lhs, const WGPUBindGroupLayoutEntry& rhs ) noexcept
+{
+    return lhs.binding == rhs.binding
+        && lhs.visibility == rhs.visibility
+        && lhs.buffer.type == rhs.buffer.type
+        && lhs.buffer.hasDynamicOffset == rhs.buffer.hasDynamicOffset
+        && lhs.buffer.minBindingSize == rhs.buffer.minBindingSize
+        && lhs.sampler.type == rhs.sampler.type
+        && lhs.texture.sampleType == rhs.texture.sampleType
+        && lhs.texture.viewDimension == rhs.texture.viewDimension
+        && lhs.texture.multisampled == rhs.texture.multisampled
+        && lhs.storageTexture.access == rhs.storageTexture.access
+        && lhs.storageTexture.format == rhs.storageTexture.format
+        && lhs.storageTexture.viewDimension == rhs.storageTexture.viewDimension;
 }
\ No newline at end of file
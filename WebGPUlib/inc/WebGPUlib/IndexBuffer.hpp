@@ -37,7 +37,7 @@ public:
     }
 
 protected:
-    IndexBuffer( WGPUBuffer&& buffer, std::size_t indexCount, std::size_t indexStride );
+    IndexBuffer( WGPUBuffer&& buffer, std::size_t indexCount, std::size_t indexStride, std::size_t offset = 0 );
     ~IndexBuffer() override = default;
 
 private:
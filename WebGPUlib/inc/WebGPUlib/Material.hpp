@@ -2,11 +2,29 @@
 
 #include <glm/vec4.hpp>
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 
 namespace WebGPUlib
 {
+// Describes how the shader must swizzle a material texture that stores fewer than 4 channels
+// or that packs several single channel textures into its channels.
+// The has*Texture flags of the material properties store the swizzle of the texture
+// (or 0 if the material does not have a texture in that slot).
+enum class TextureSwizzle : uint32_t
+{
+    None = 0,  // The material does not have a texture in this slot.
+    RGBA = 1,  // Use the texture as-is.
+    RRR1 = 2,  // Single channel (grayscale) texture: broadcast red to the color channels.
+    RRRG = 3,  // Two channel (grayscale + alpha) texture: broadcast red, alpha is stored in green.
+    GGG1 = 4,  // Packed texture: broadcast green to the color channels.
+    BBB1 = 5,  // Packed texture: broadcast blue to the color channels.
+    AAA1 = 6,  // Packed texture: broadcast alpha to the color channels.
+    // The slot is stored in a channel of the packed texture of the material (see TextureSlot::Packed).
+    Packed = 7,
+};
+
 // clang-format off
 
 // The material properties need to stored in aligned memory when uploading
@@ -42,6 +60,7 @@ struct alignas( 16 ) MaterialProperties
     , hasNormalTexture( false )
     , hasBumpTexture( false )
     , hasOpacityTexture( false )
+    , hasPackedTexture( false )
     {}
 
     MaterialProperties(const MaterialProperties&) = default;
@@ -66,6 +85,8 @@ struct alignas( 16 ) MaterialProperties
     float     indexOfRefraction;  // For transparent materials, IOR > 0.
     float     bumpIntensity;      // Used for scaling bump maps.
     //------------------------------------ ( 16 bytes )
+    // The texture flags of each slot (see Material::setTexture).
+    // Bits 0-7 store the TextureSwizzle and bits 8-31 the layer of the texture in a texture array.
     uint32_t  hasAmbientTexture;
     uint32_t  hasDiffuseTexture;
     uint32_t  hasEmissiveTexture;
@@ -76,7 +97,10 @@ struct alignas( 16 ) MaterialProperties
     uint32_t  hasBumpTexture;
     uint32_t  hasOpacityTexture;
     //------------------------------------ ( 16 bytes )
-    // Total:                              ( 16 * 8 = 128 bytes )
+    uint32_t  hasPackedTexture;
+    uint32_t  padding[3];
+    //------------------------------------ ( 16 bytes )
+    // Total:                              ( 16 * 9 = 144 bytes )
 };
 // clang-format on
 
@@ -91,16 +115,27 @@ enum class TextureSlot
     Normal,
     Bump,
     Opacity,
+    // Packs the grayscale specular (red), specular power (green) and opacity (blue) textures of a material
+    // into a single texture (see Device::loadPackedTexture), so the shader only samples one texture for them.
+    // The slots that are stored in the packed texture use the TextureSwizzle::Packed swizzle
+    // (see Material::setPackedSlot).
+    Packed,
     NumTextureSlots
 };
 
+class BindGroup;
+class MaterialTable;
+class StorageBuffer;
 class Texture;
 
 class Material
 {
 public:
+    // The ID of a material that was not added to a material table.
+    static constexpr uint32_t InvalidId = UINT32_MAX;
+
     Material( const MaterialProperties& properties = {} );
-    ~Material() = default;
+    ~Material();
 
     const glm::vec4& getDiffuse() const noexcept;
     void             setDiffuse( const glm::vec4& diffuse ) noexcept;
@@ -132,6 +167,19 @@ public:
     std::shared_ptr<Texture> getTexture( TextureSlot slot ) const;
     void                     setTexture( TextureSlot slot, std::shared_ptr<Texture> texture );
 
+    // Set a texture with an explicit swizzle.
+    // If the texture is a texture array, layer is the array layer that is sampled by the material
+    // (see Device::createTextureArrays).
+    void setTexture( TextureSlot slot, std::shared_ptr<Texture> texture, TextureSwizzle swizzle,
+                     uint32_t layer = 0 );
+
+    // Read a slot from its channel of the packed texture of the material (see TextureSlot::Packed).
+    // Only the specular, specular power and opacity slots can be packed. The texture of the slot is removed.
+    void setPackedSlot( TextureSlot slot );
+
+    TextureSwizzle getTextureSwizzle( TextureSlot slot ) const noexcept;
+    uint32_t       getTextureLayer( TextureSlot slot ) const noexcept;
+
     // The material is transparent if the opacity is < 1 or there is an
     // opacity texture.
     bool isTransparent() const noexcept;
@@ -139,8 +187,43 @@ public:
     const MaterialProperties& getProperties() const noexcept;
     void                      setProperties( const MaterialProperties& properties ) noexcept;
 
+    // Get the index of the material properties in the buffer of the material table (see MaterialTable::add).
+    // Returns InvalidId if the material was not added to a material table.
+    uint32_t getId() const noexcept
+    {
+        return id;
+    }
+
+    // Get the bind group of the material (see Device::getMaterialBindGroupLayout).
+    // The bind group binds the buffer of the material table, the textures of the material (as texture arrays)
+    // and the material sampler. Materials with the same textures share a bind group (see MaterialTable), so the
+    // properties of the material are selected with the dynamic offset that is returned by getBindGroupOffset.
+    // The bind group is only looked up again if a texture of the material changes or the buffer of the material
+    // table grows. The material must be added to a material table and the table must be updated before the bind
+    // group is used.
+    std::shared_ptr<BindGroup> getBindGroup();
+
+    // Get the dynamic offset of the properties of the material in the bind group (see getBindGroup).
+    uint32_t getBindGroupOffset() const noexcept;
+
 private:
+    friend class MaterialTable;
+
+    // Get the texture flags of a slot in the material properties.
+    uint32_t* getTextureFlags( TextureSlot slot ) const noexcept;
+
+    // Mark the properties dirty in the material table (if the material was added to a table).
+    void markDirty() const noexcept;
+
     std::unique_ptr<MaterialProperties>                       properties;
     std::unordered_map<TextureSlot, std::shared_ptr<Texture>> textures;
+
+    MaterialTable* table = nullptr;
+    uint32_t       id    = InvalidId;
+
+    std::shared_ptr<BindGroup> bindGroup;
+    // The buffer of the material table that the bind group was created with.
+    std::shared_ptr<StorageBuffer> bindGroupBuffer;
+    bool                           bindGroupDirty = true;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
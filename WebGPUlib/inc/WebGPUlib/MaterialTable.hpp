@@ -0,0 +1,92 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace WebGPUlib
+{
+class BindGroup;
+class Material;
+class StorageBuffer;
+
+// Stores the properties of all materials in a single storage buffer on the GPU.
+//
+// Each material that is added to the table gets an ID that is the index of its properties in the buffer.
+// The entries are aligned to the minimum buffer offset alignment, so the properties of a single material
+// are selected with the dynamic offset of the uniform buffer in the material bind group (see Material::getBindGroup).
+// The table also stores the material bind groups, which are shared by the materials with the same textures.
+// Changing the properties of a material marks its entry dirty and update() uploads only the dirty entries
+// (contiguous dirty entries are uploaded with a single write).
+class MaterialTable
+{
+public:
+    // The size of an entry in the buffer.
+    static constexpr std::size_t Stride = 256;
+
+    MaterialTable() = default;
+    ~MaterialTable();
+
+    MaterialTable( const MaterialTable& )            = delete;
+    MaterialTable( MaterialTable&& )                 = delete;
+    MaterialTable& operator=( const MaterialTable& ) = delete;
+    MaterialTable& operator=( MaterialTable&& )      = delete;
+
+    // Add a material to the table and return its ID.
+    // If the material was already added to the table, the existing ID is returned.
+    uint32_t add( Material& material );
+
+    // Remove a material from the table. The ID of the material is reused by materials that are added later.
+    // This is called automatically when the material is destroyed.
+    void remove( Material& material );
+
+    // Mark the properties of a material as changed.
+    void markDirty( uint32_t id );
+
+    // Upload the properties of the materials that changed since the last update.
+    // The buffer grows if materials were added, so call this before the buffer is bound.
+    void update();
+
+    // Get the buffer that stores the properties of the materials (indexed by the material ID).
+    // The buffer is replaced when it grows, so don't hold on to it.
+    const std::shared_ptr<StorageBuffer>& getBuffer() const noexcept
+    {
+        return buffer;
+    }
+
+    // Get the offset of the properties of a material in the buffer.
+    static uint64_t getOffset( uint32_t id ) noexcept
+    {
+        return static_cast<uint64_t>( id ) * Stride;
+    }
+
+    std::size_t getNumMaterials() const noexcept
+    {
+        return materials.size() - freeIds.size();
+    }
+
+    // Get the bind group of the materials that use a set of texture views (see Material::getBindGroup).
+    // Returns nullptr if no material uses the texture views (yet). The bind groups are released when they are no
+    // longer used by any material, or when the buffer grows.
+    std::shared_ptr<BindGroup> findBindGroup( const std::vector<WGPUTextureView>& textureViews ) const;
+    void addBindGroup( const std::vector<WGPUTextureView>& textureViews, const std::shared_ptr<BindGroup>& bindGroup );
+
+private:
+    // The materials in the table (nullptr for unused IDs).
+    std::vector<Material*> materials;
+    std::vector<uint32_t>  freeIds;
+
+    // The IDs of the materials that need to be uploaded.
+    std::vector<uint32_t> dirtyIds;
+    std::vector<bool>     dirty;
+
+    std::shared_ptr<StorageBuffer> buffer;
+    std::size_t                    capacity = 0;
+
+    // The bind groups of the materials by their texture views. The materials own the bind groups.
+    std::map<std::vector<WGPUTextureView>, std::weak_ptr<BindGroup>> bindGroups;
+};
+}  // namespace WebGPUlib
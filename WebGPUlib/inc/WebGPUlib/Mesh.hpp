@@ -1,5 +1,10 @@
 #pragma once
 
+#include "Vertex.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -9,6 +14,17 @@ namespace WebGPUlib
 class VertexBuffer;
 class IndexBuffer;
 class Material;
+class StorageBuffer;
+
+// A level of detail of a mesh. All levels of detail share the vertex buffer
+// of the mesh and are stored consecutively in the index buffer.
+struct MeshLOD
+{
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    // The object-space geometric error of the LOD compared to the full resolution mesh.
+    float error = 0.0f;
+};
 
 class Mesh
 {
@@ -33,9 +49,37 @@ public:
     void                      setMaterial( std::shared_ptr<Material> material );
     std::shared_ptr<Material> getMaterial() const;
 
+    // The layout of the vertices in the vertex buffer.
+    // Used to select a pipeline state that is compatible with the mesh.
+    void         setVertexLayout( VertexLayout vertexLayout );
+    VertexLayout getVertexLayout() const;
+
+    // The levels of detail of the mesh, ordered from the highest to the lowest detail.
+    // If the mesh does not have any LODs, the full index buffer is drawn.
+    void                        setLODs( std::vector<MeshLOD> lods );
+    const std::vector<MeshLOD>& getLODs() const;
+
+    // The object-space bounding sphere of the mesh.
+    void             setBoundingSphere( const glm::vec3& center, float radius );
+    const glm::vec3& getBoundingSphereCenter() const;
+    float            getBoundingSphereRadius() const;
+
+    // The meshlets of the mesh (see Meshlet.hpp) and the indices of the meshlet triangles.
+    // Used to cull the mesh with the MeshletCullingPipelineState.
+    void                           setMeshlets( std::shared_ptr<StorageBuffer> meshletBuffer,
+                                                std::shared_ptr<StorageBuffer> meshletIndexBuffer );
+    std::shared_ptr<StorageBuffer> getMeshletBuffer() const;
+    std::shared_ptr<StorageBuffer> getMeshletIndexBuffer() const;
+
 private:
     std::vector<std::shared_ptr<VertexBuffer>> vertexBuffers;
     std::shared_ptr<IndexBuffer>               indexBuffer;
     std::shared_ptr<Material>                  material;
+    VertexLayout                               vertexLayout = VertexLayout::PositionNormalTangentBitangentTexture;
+    std::vector<MeshLOD>                       lods;
+    glm::vec3                                  boundingSphereCenter { 0 };
+    float                                      boundingSphereRadius = 0.0f;
+    std::shared_ptr<StorageBuffer>             meshletBuffer;
+    std::shared_ptr<StorageBuffer>             meshletIndexBuffer;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
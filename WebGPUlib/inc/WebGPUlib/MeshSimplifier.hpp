@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Vertex.hpp"
+
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+// Simplify a triangle mesh using edge collapses ordered by the quadric error metric
+// (Garland & Heckbert, "Surface Simplification Using Quadric Error Metrics", 1997).
+//
+// Vertices are only collapsed onto other existing vertices, so the simplified
+// indices can be used with the original vertex buffer. Vertices on mesh borders
+// and attribute seams (vertices that share a position but have different attributes)
+// are never moved to preserve the silhouette and the texture mapping. Differences in
+// the normal and texture coordinates of the collapsed vertices are added to the cost
+// of a collapse to preserve the shading of the mesh (they only affect the order of the
+// collapses, not the error).
+//
+// Returns the simplified index buffer which has at most targetIndexCount indices if
+// that can be achieved without exceeding maxError. The (object-space) geometric
+// error of the simplified mesh is returned in resultError. This is the maximum distance
+// of a collapsed vertex to the planes of the triangles in indices.
+std::vector<uint32_t> simplifyMesh( const std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
+                                    const std::vector<uint32_t>& indices, std::size_t targetIndexCount,
+                                    float maxError = FLT_MAX, float* resultError = nullptr );
+
+}  // namespace WebGPUlib
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Vertex.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+// A cluster of triangles of a mesh that is culled as a unit.
+// This struct matches the layout of the Meshlet struct in MeshletCulling.wgsl.
+struct Meshlet
+{
+    // The object-space bounding sphere of the meshlet.
+    glm::vec3 center { 0 };
+    float     radius = 0.0f;
+    //------------------------------------ ( 16 bytes )
+    // The normal cone of the meshlet. The meshlet is back-facing if:
+    // dot( center - cameraPosition, coneAxis ) >= coneCutoff * length( center - cameraPosition ) + radius
+    glm::vec3 coneAxis { 0 };
+    float     coneCutoff = 1.0f;
+    //------------------------------------ ( 16 bytes )
+    // The range of the meshlet in the meshlet index buffer.
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint32_t padding[2] {};
+    //------------------------------------ ( 16 bytes )
+    // Total:                              ( 16 * 3 = 48 bytes )
+};
+
+static_assert( sizeof( Meshlet ) == 48, "Unexpected padding in Meshlet." );
+
+// Split the triangles of a mesh into meshlets with at most maxVertices unique vertices
+// and maxTriangles triangles. The triangles are written to meshletIndices grouped by
+// meshlet (the indices still refer to the vertices of the mesh).
+std::vector<Meshlet> buildMeshlets( const std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
+                                    const std::vector<uint32_t>& indices, std::vector<uint32_t>& meshletIndices,
+                                    std::size_t maxVertices = 64, std::size_t maxTriangles = 124 );
+
+}  // namespace WebGPUlib
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ComputePipelineState.hpp"
+
+#include <glm/vec4.hpp>
+
+namespace WebGPUlib
+{
+// The parameters of the meshlet culling compute shader.
+// This struct matches the layout of the CullParams struct in MeshletCulling.wgsl.
+struct MeshletCullParams
+{
+    glm::vec4 frustumPlanes[6];  // Object-space frustum planes (normalized, pointing inwards).
+    glm::vec4 cameraPosition;    // Object-space camera position.
+    uint32_t  meshletCount = 0;  // The number of meshlets of the mesh.
+    uint32_t  drawIndex    = 0;  // The index of the draw arguments to write.
+    uint32_t  firstIndex   = 0;  // The first index in the output index buffer for this draw.
+    uint32_t  padding      = 0;
+};
+
+// The arguments of an indexed indirect draw.
+struct DrawIndexedIndirectArgs
+{
+    uint32_t indexCount    = 0;
+    uint32_t instanceCount = 0;
+    uint32_t firstIndex    = 0;
+    int32_t  baseVertex    = 0;
+    uint32_t firstInstance = 0;
+};
+
+// The maximum number of workgroups in each dimension of a dispatch (the default
+// maxComputeWorkgroupsPerDimension limit).
+constexpr uint32_t MaxWorkgroupsPerDimension = 65535;
+
+// Culls the meshlets of a mesh and writes the indices of the visible meshlets to an index buffer.
+// Dispatch one workgroup per meshlet. Meshes with more than MaxWorkgroupsPerDimension meshlets
+// are dispatched as a 2D grid (the meshlet index is groupId.y * numWorkgroups.x + groupId.x).
+class MeshletCullingPipelineState : public ComputePipelineState
+{
+public:
+    // If async is true, the pipeline is created in the background (see ComputePipelineState::isReady).
+    explicit MeshletCullingPipelineState( bool async = false );
+    ~MeshletCullingPipelineState() override;
+
+    MeshletCullingPipelineState( const MeshletCullingPipelineState& )                = delete;
+    MeshletCullingPipelineState( MeshletCullingPipelineState&& ) noexcept            = delete;
+    MeshletCullingPipelineState& operator=( const MeshletCullingPipelineState& )     = delete;
+    MeshletCullingPipelineState& operator=( MeshletCullingPipelineState&& ) noexcept = delete;
+
+protected:
+    void bind( ComputeCommandBuffer& commandBuffer ) override;
+};
+}  // namespace WebGPUlib
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace WebGPUlib
+{
+// Persists the compiled shaders and pipelines of the backend in a cache directory, so they don't have to be
+// compiled again the next time the application is started.
+//
+// The backend calls load and store with opaque keys and values (see Dawn's blob cache and
+// WGPUDawnCacheDeviceDescriptor). Each value is stored in its own file that is named by the hash of its key.
+// The key is stored with the value, so hash collisions are detected when the value is loaded.
+//
+// The entries are stored in a subdirectory of the cache path that is named by the cache version and the
+// isolation key (which identifies the adapter and its driver). A new version of the cache format or
+// a different adapter uses a new subdirectory, so stale entries are never loaded.
+//
+// load and store may be called from multiple threads at the same time.
+class PipelineCache
+{
+public:
+    // The version of the cache format. Increment this to invalidate all existing caches.
+    static constexpr uint32_t Version = 1;
+
+    PipelineCache( const std::filesystem::path& cachePath, std::string_view isolationKey );
+
+    PipelineCache( const PipelineCache& )            = delete;
+    PipelineCache( PipelineCache&& )                 = delete;
+    PipelineCache& operator=( const PipelineCache& ) = delete;
+    PipelineCache& operator=( PipelineCache&& )      = delete;
+
+    // Load the value of a key. Returns the size of the value, or 0 if the key is not in the cache.
+    // If value is nullptr (or valueSize is 0), only the size of the value is returned.
+    // The value is only copied if valueSize is at least the size of the value.
+    std::size_t load( const void* key, std::size_t keySize, void* value, std::size_t valueSize );
+
+    // Store the value of a key (replacing an existing value).
+    void store( const void* key, std::size_t keySize, const void* value, std::size_t valueSize );
+
+    // Get the directory that stores the entries of this cache version.
+    const std::filesystem::path& getDirectory() const noexcept
+    {
+        return directory;
+    }
+
+    // Check if the cache had any entries when it was opened (a warm cache).
+    bool isWarm() const noexcept
+    {
+        return numEntriesAtOpen > 0;
+    }
+
+    // The number of values that were loaded, requested but not found, and stored since the cache was opened.
+    std::size_t getNumHits() const noexcept
+    {
+        return numHits;
+    }
+
+    std::size_t getNumMisses() const noexcept
+    {
+        return numMisses;
+    }
+
+    std::size_t getNumStores() const noexcept
+    {
+        return numStores;
+    }
+
+private:
+    std::filesystem::path getEntryPath( const void* key, std::size_t keySize ) const;
+
+    std::filesystem::path directory;
+    std::size_t           numEntriesAtOpen = 0;
+
+    std::atomic<std::size_t> numHits   = 0;
+    std::atomic<std::size_t> numMisses = 0;
+    std::atomic<std::size_t> numStores = 0;
+    // Used to create unique names for the temporary files.
+    std::atomic<uint64_t> tempFileCounter = 0;
+};
+}  // namespace WebGPUlib
@@ -4,6 +4,7 @@
 #include <webgpu/webgpu.h>
 
 #include <memory>
+#include <vector>
 
 namespace WebGPUlib
 {
@@ -44,6 +45,9 @@ public:
 
     void submit( CommandBuffer& commandBuffer );
 
+    // Submit multiple command buffers with a single submission.
+    void submit( const std::vector<std::shared_ptr<CommandBuffer>>& commandBuffers );
+
     WGPUQueue getWGPUQueue() const
     {
         return queue;
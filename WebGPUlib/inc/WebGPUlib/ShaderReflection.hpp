@@ -0,0 +1,49 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace WebGPUlib
+{
+// Derives the bind group layouts of a pipeline from the resource declarations in its WGSL shader code.
+//
+// Every `@group( g ) @binding( b ) var ...` declaration becomes a bind group layout entry:
+//   var<uniform> -> uniform buffer, var<storage[, read]> -> read-only storage buffer,
+//   var<storage, read_write> -> storage buffer, sampler -> filtering sampler, sampler_comparison -> comparison
+//   sampler, texture_* -> sampled texture and texture_storage_* -> storage texture.
+// The minimum binding size of a buffer is the size of its type (computed with the WGSL memory layout rules).
+// The visibility of a resource is the set of stages of the entry points that use the resource
+// (directly or through the functions they call).
+//
+// Sampled float textures are assumed to be filterable. Use setTextureSampleType and setSamplerType if that
+// is not the case.
+class ShaderReflection
+{
+public:
+    explicit ShaderReflection( std::string_view shaderCode );
+
+    // Get the number of bind groups (the highest group index + 1). Unused group indices have no entries.
+    uint32_t getNumBindGroups() const noexcept
+    {
+        return static_cast<uint32_t>( bindGroups.size() );
+    }
+
+    // Get the layout entries of a bind group (sorted by binding).
+    const std::vector<WGPUBindGroupLayoutEntry>& getBindGroupLayoutEntries( uint32_t groupIndex ) const;
+
+    // Override the sample type of a texture (for example, for textures with an unfilterable format).
+    void setTextureSampleType( uint32_t groupIndex, uint32_t binding, WGPUTextureSampleType sampleType );
+    // Override the type of a sampler (for example, to sample textures with an unfilterable format).
+    void setSamplerType( uint32_t groupIndex, uint32_t binding, WGPUSamplerBindingType samplerType );
+    // Bind a buffer with a dynamic offset (see CommandBuffer::bindBindGroup).
+    void setDynamicOffset( uint32_t groupIndex, uint32_t binding, bool hasDynamicOffset = true );
+
+private:
+    WGPUBindGroupLayoutEntry* findEntry( uint32_t groupIndex, uint32_t binding );
+
+    std::vector<std::vector<WGPUBindGroupLayoutEntry>> bindGroups;
+};
+}  // namespace WebGPUlib
@@ -3,6 +3,7 @@
 #include <webgpu/webgpu.h>
 
 #include <unordered_map>
+#include <vector>
 
 namespace WebGPUlib
 {
@@ -26,6 +27,7 @@ public:
         return texture;
     }
 
+    // Get the descriptor that the texture was created with (without the label).
     WGPUTextureDescriptor getWGPUTextureDescriptor() const noexcept
     {
         return descriptor;
@@ -38,6 +40,7 @@ protected:
 private:
     WGPUTexture                                                                 texture = nullptr;
     WGPUTextureDescriptor                                                       descriptor {};
+    std::vector<WGPUTextureFormat>                                              viewFormats;
     std::shared_ptr<TextureView>                                                defaultView;
     std::unordered_map<WGPUTextureViewDescriptor, std::shared_ptr<TextureView>> views;
 };
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+class ThreadPool;
+
+// The maximum width and height of a 2D texture. The device is created with the default limits of WebGPU,
+// so this is the default maxTextureDimension2D limit.
+constexpr uint32_t MaxTextureDimension2D = 8192;
+
+// The pixel data of a 2D texture (including all mip levels) in CPU memory.
+struct TextureData
+{
+    WGPUTextureFormat format = WGPUTextureFormat_Undefined;
+    uint32_t          width  = 0;
+    uint32_t          height = 0;
+
+    // The data of each mip level. Compressed formats store complete 4x4 blocks,
+    // so mip levels that are smaller than a block are padded to the block size.
+    std::vector<std::vector<uint8_t>> mips;
+
+    // The options the texture was cooked with (see getCookKey). This is stored in the reserved fields
+    // of the DDS header and is 0 for textures that were not cooked by WebGPUlib.
+    uint32_t cookKey = 0;
+};
+
+// Check if the texture format is a BCn block compressed format.
+bool isBlockCompressed( WGPUTextureFormat format );
+
+// Get the size (in bytes) of a mip level of a texture with the given format and size.
+std::size_t getMipSize( WGPUTextureFormat format, uint32_t width, uint32_t height, uint32_t mip );
+
+// The filter that is used to downsample mips on the CPU.
+enum class MipFilter
+{
+    Box,       // Average 2x2 texels (same as the GPU mip generation).
+    Mitchell,  // Mitchell-Netravali cubic filter (sharper mips).
+};
+
+// Options that control how a texture is cooked on the CPU.
+struct TextureCookOptions
+{
+    MipFilter mipFilter = MipFilter::Box;
+
+    // The color channels of the image are sRGB encoded.
+    // The mips are filtered in linear space and encoded back to sRGB.
+    bool sRGB = false;
+
+    // The image is a tangent-space normal map. The normals of the mips are renormalized.
+    bool normalMap = false;
+
+    // The channels of the image store unrelated values (see packTextureChannels).
+    // The channels are filtered independently (the color channels are not weighted by alpha).
+    bool packedChannels = false;
+};
+
+// Encode the cook options in a key that is stored with a cooked texture (see TextureData::cookKey).
+// A cooked texture is only reused if it was cooked with the same options. The key is never 0.
+uint32_t getCookKey( const TextureCookOptions& options );
+
+// Generate the full mip chain of an RGBA8 image. The first mip level is a copy of the image.
+// The mips are generated with stb_image_resize2 which uses SIMD instructions (SSE2, AVX, NEON) if available.
+// The color channels are weighted by alpha so that transparent texels don't bleed into the mips.
+std::vector<std::vector<uint8_t>> generateMips( const uint8_t* rgba, uint32_t width, uint32_t height,
+                                                const TextureCookOptions& options = {} );
+
+// Get the uncompressed texture format that stores an image with the given number of channels:
+// R8Unorm for grayscale images, RG8Unorm for grayscale images with alpha and RGBA8Unorm for all other images.
+WGPUTextureFormat getChannelFormat( uint32_t channels );
+
+// Pack an RGBA8 image that was expanded from a grayscale image (with stb_image) into the format returned
+// by getChannelFormat. Grayscale is stored in the red channel and alpha (if present) in the green channel.
+// Images with 3 or 4 channels are copied as-is.
+std::vector<uint8_t> packChannels( const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t channels );
+
+// An RGBA8 image in CPU memory.
+struct ImageRGBA8
+{
+    const uint8_t* pixels = nullptr;
+    uint32_t       width  = 0;
+    uint32_t       height = 0;
+};
+
+// Check if all pixels of an RGBA8 image are gray (the red, green and blue channels are equal).
+bool isGrayscale( const uint8_t* rgba, uint32_t width, uint32_t height );
+
+// Pack the red channel of up to 4 grayscale images into the channels of a single RGBA8 image.
+// Images with a different size are resized to the size of the packed image (bilinear filter).
+// Channels without an image are filled with 255 (like the default white texture).
+// Use TextureCookOptions::packedChannels to generate the mips of the packed image.
+std::vector<uint8_t> packTextureChannels( const std::array<ImageRGBA8, 4>& images, uint32_t width,
+                                          uint32_t height );
+
+// Compress an RGBA8 image using stb_dxt. Supported formats are BC1, BC3, BC4 (red channel),
+// and BC5 (red and green channels). Partial blocks at the edges of the image are padded
+// by repeating the last row and column.
+std::vector<uint8_t> compressBC( const uint8_t* rgba, uint32_t width, uint32_t height, WGPUTextureFormat format );
+
+// Decompress a BC1-BC5 image to RGBA8. The result has exactly width x height pixels.
+// Single channel (BC4) and two channel (BC5) images are expanded like they are sampled in a shader.
+std::vector<uint8_t> decompressBC( const uint8_t* blocks, uint32_t width, uint32_t height, WGPUTextureFormat format );
+
+// Compress an RGBA8 image (and its mips) to a BCn format.
+// Normal maps are compressed to BC5, images with an alpha channel to BC3 and all other images to BC1.
+TextureData compressTexture( const uint8_t* rgba, uint32_t width, uint32_t height,
+                             const TextureCookOptions& options = {} );
+
+// Transcode a block compressed texture (and its mips) to RGBA8 for devices that
+// don't support block compressed formats. If a thread pool is provided, the blocks are
+// decompressed on the worker threads of the pool.
+TextureData decompressTexture( const TextureData& textureData, ThreadPool* threadPool = nullptr );
+
+// Load a texture from a DDS file. Only 2D textures with BC1-BC5, R8, RG8 or RGBA8 pixel data are supported.
+// Mips before firstMip are skipped (their data is left empty), which is used to stream the mips of a texture.
+// Returns false if the file could not be read, the format is not supported, the size is 0 or larger than
+// MaxTextureDimension2D, a block compressed texture is not a multiple of 4 in size, or firstMip is not in the file.
+// Mip counts larger than a full mip chain are clamped.
+bool loadDDS( const std::filesystem::path& filePath, TextureData& textureData, uint32_t firstMip = 0 );
+
+// Read only the format, the size and the number of mips of a DDS file (the mips of textureData are left empty).
+bool loadDDSHeader( const std::filesystem::path& filePath, TextureData& textureData );
+
+// Load a texture from the contents of a DDS file that has already been read into memory.
+// The file name is only used in error messages.
+bool loadDDS( const uint8_t* data, std::size_t size, const std::string& fileName, TextureData& textureData,
+              uint32_t firstMip = 0 );
+
+// Read only the format, the size and the number of mips of a DDS file that has already been read into memory.
+bool loadDDSHeader( const uint8_t* data, std::size_t size, const std::string& fileName, TextureData& textureData );
+
+// Save a texture to a DDS file (using the DX10 header extension).
+bool saveDDS( const std::filesystem::path& filePath, const TextureData& textureData );
+
+}  // namespace WebGPUlib
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "Material.hpp"
+#include "TextureData.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace WebGPUlib
+{
+class Texture;
+
+// A texture whose mips are streamed from a DDS file by the TextureStreamer.
+// The GPU texture only stores the resident mips (the resident mip and all smaller mips).
+// When the resident mips change, a new texture is created and swapped with the current texture
+// (and the texture of the materials that use the streamed texture is replaced). The mips that stay
+// resident are copied from the current texture on the GPU, so only the new mips are read from the file.
+class StreamedTexture
+{
+public:
+    // Get the texture that stores the resident mips.
+    std::shared_ptr<Texture> getTexture() const noexcept
+    {
+        return texture;
+    }
+
+    // The largest mip that is resident on the GPU.
+    uint32_t getResidentMip() const noexcept
+    {
+        return residentMip;
+    }
+
+    // The smallest mips (starting at this mip) are always resident.
+    uint32_t getMinResidentMip() const noexcept
+    {
+        return minResidentMip;
+    }
+
+    // The size of mip 0 of the source texture.
+    uint32_t getWidth() const noexcept
+    {
+        return width;
+    }
+
+    uint32_t getHeight() const noexcept
+    {
+        return height;
+    }
+
+    uint32_t getMipLevelCount() const noexcept
+    {
+        return mipLevelCount;
+    }
+
+    // The size (in bytes) of the texture if the mips starting at mip are resident.
+    uint64_t getResidentSize( uint32_t mip ) const;
+
+private:
+    friend class TextureStreamer;
+
+    struct MaterialSlot
+    {
+        std::weak_ptr<Material> material;
+        TextureSlot             slot;
+    };
+
+    std::filesystem::path filePath;
+    WGPUTextureFormat     format         = WGPUTextureFormat_Undefined;
+    uint32_t              width          = 0;
+    uint32_t              height         = 0;
+    uint32_t              mipLevelCount  = 0;
+    uint32_t              minResidentMip = 0;
+
+    std::shared_ptr<Texture> texture;
+    uint32_t                 residentMip = 0;
+
+    // The mip that is requested by the renderer and the frame it was last requested in.
+    uint32_t requestedMip  = 0;
+    uint64_t lastUsedFrame = 0;
+
+    // Check if the file is being read or the new mips are being loaded.
+    bool isLoading() const noexcept
+    {
+        return pendingRead.valid() || pendingLoad.valid();
+    }
+
+    // The file that is read for a load and the new mips (from pendingMip up to the resident mip)
+    // that are loaded from the file on a worker thread.
+    std::future<std::vector<uint8_t>> pendingRead;
+    std::future<TextureData>          pendingLoad;
+    uint32_t                          pendingMip = 0;
+
+    std::vector<MaterialSlot> materials;
+};
+
+// Streams the mips of textures from DDS files within a GPU memory budget.
+//
+// Only the smallest mips of a texture are loaded when the texture is created. The renderer requests
+// the mips that it needs each frame (based on the screen-space size of the meshes that use the texture)
+// and TextureStreamer::update loads the missing mips on the worker threads of the device. If the
+// requested mips don't fit in the budget, the mips of the least recently used textures are evicted.
+// The files are read from the archives that are mounted on the device or from disk (see Device::readFileAsync).
+class TextureStreamer
+{
+public:
+    explicit TextureStreamer( uint64_t budget = 256ull * 1024 * 1024 );
+    ~TextureStreamer();
+
+    TextureStreamer( const TextureStreamer& )            = delete;
+    TextureStreamer( TextureStreamer&& )                 = delete;
+    TextureStreamer& operator=( const TextureStreamer& ) = delete;
+    TextureStreamer& operator=( TextureStreamer&& )      = delete;
+
+    // Load the smallest mips of a DDS texture and register the texture for streaming.
+    // Returns nullptr if the file could not be loaded.
+    std::shared_ptr<StreamedTexture> load( const std::filesystem::path& filePath );
+
+    // Replace the texture of a material slot whenever the resident mips of the streamed texture change.
+    void addMaterial( const std::shared_ptr<StreamedTexture>& texture, const std::shared_ptr<Material>& material,
+                      TextureSlot slot );
+
+    // Request a mip of a texture for the current frame.
+    void request( StreamedTexture& texture, uint32_t mip );
+
+    // Request the mips of the streamed textures of a material that covers screenSize pixels on the screen.
+    void request( const std::shared_ptr<Material>& material, float screenSize );
+
+    // Check if a texture stores the resident mips of a streamed texture.
+    bool isStreamed( const Texture& texture ) const;
+
+    // Get the mip of a texture that has about one texel per pixel if the texture covers screenSize pixels.
+    static uint32_t getDesiredMip( uint32_t width, uint32_t height, float screenSize );
+
+    // Swap the textures whose mips have been loaded, evict mips to stay within the budget and start
+    // loading the requested mips. Must be called once per frame (after the mips are requested).
+    void update();
+
+    void setBudget( uint64_t _budget ) noexcept
+    {
+        budget = _budget;
+    }
+
+    uint64_t getBudget() const noexcept
+    {
+        return budget;
+    }
+
+    // The size (in bytes) of the resident mips of all textures.
+    uint64_t getResidentSize() const noexcept
+    {
+        return residentSize;
+    }
+
+private:
+    // Create a texture that stores the mips starting at mip and swap it with the current texture.
+    // textureData stores the new mips (starting at mip) and the other mips are copied from the current texture.
+    void swapTexture( StreamedTexture& texture, const TextureData& textureData, uint32_t mip );
+
+    std::vector<std::shared_ptr<StreamedTexture>> textures;
+    // The streamed textures of each material. The materials are compared by owner, so a new material that is
+    // allocated at the address of a destroyed material never finds the textures of the destroyed material.
+    std::map<std::weak_ptr<Material>, std::vector<StreamedTexture*>, std::owner_less<>> materialTextures;
+
+    uint64_t budget       = 0;
+    uint64_t residentSize = 0;
+    uint64_t frame        = 1;
+
+    // Mips that were not requested for this number of frames are evicted.
+    uint64_t evictFrames = 120;
+    // The maximum number of textures that are loaded at the same time.
+    uint32_t maxPendingLoads = 4;
+};
+}  // namespace WebGPUlib
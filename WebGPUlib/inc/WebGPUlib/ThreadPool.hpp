@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace WebGPUlib
+{
+
+// A fixed-size pool of worker threads that execute tasks in the order they are submitted.
+// If the pool has no worker threads (for example, on Emscripten without pthreads support),
+// tasks are executed immediately on the calling thread.
+class ThreadPool
+{
+public:
+    explicit ThreadPool( std::size_t numThreads = std::thread::hardware_concurrency() );
+    ~ThreadPool();
+
+    ThreadPool( const ThreadPool& )            = delete;
+    ThreadPool( ThreadPool&& )                 = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+    ThreadPool& operator=( ThreadPool&& )      = delete;
+
+    // Submit a task to the pool. The returned future is ready when the task has finished.
+    template<typename Func>
+    std::future<std::invoke_result_t<Func>> submit( Func&& func );
+
+    // Execute func( i ) for every i in [0, count) and wait for all of them to finish.
+    // The calling thread also executes tasks while it waits.
+    void parallelFor( std::size_t count, const std::function<void( std::size_t )>& func );
+
+    std::size_t getNumThreads() const noexcept
+    {
+        return threads.size();
+    }
+
+private:
+    void enqueue( std::function<void()> task );
+    void workerThread();
+
+    std::vector<std::thread>          threads;
+    std::queue<std::function<void()>> tasks;
+    std::mutex                        mutex;
+    std::condition_variable           condition;
+    bool                              stop = false;
+};
+
+template<typename Func>
+std::future<std::invoke_result_t<Func>> ThreadPool::submit( Func&& func )
+{
+    using ResultType = std::invoke_result_t<Func>;
+
+    // std::function requires copyable callables, so the packaged task is stored in a shared_ptr.
+    auto task   = std::make_shared<std::packaged_task<ResultType()>>( std::forward<Func>( func ) );
+    auto future = task->get_future();
+
+    enqueue( [task] { ( *task )(); } );
+
+    return future;
+}
+
+}  // namespace WebGPUlib
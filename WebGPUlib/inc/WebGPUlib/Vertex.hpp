@@ -2,10 +2,19 @@
 
 #include <webgpu/webgpu.h>
 
+#include <glm/gtc/type_precision.hpp>
 #include <glm/vec3.hpp>
 
 namespace WebGPUlib
 {
+// The vertex layouts that can be used by a mesh.
+enum class VertexLayout
+{
+    PositionNormalTexture,                  // VertexPositionNormalTexture
+    PositionNormalTangentBitangentTexture,  // VertexPositionNormalTangentBitangentTexture
+    PositionQTangentTexture,                // VertexPositionQTangentTexture
+};
+
 struct VertexPositionNormalTexture
 {
     VertexPositionNormalTexture() = default;
@@ -44,4 +53,32 @@ struct VertexPositionNormalTangentBitangentTexture
 
     static WGPUVertexAttribute attributes[5];
 };
-}  // namespace WebGPUlib
\ No newline at end of file
+
+// A compact (24 byte) version of VertexPositionNormalTangentBitangentTexture (60 bytes).
+// The tangent frame is stored as a quaternion (snorm16x4) and the sign of the
+// w component stores the handedness of the bitangent. The texture coordinates
+// are stored as half-precision floats (float16x2).
+// Use decodeQTangent in VertexDecode.wgsl to unpack the tangent frame in the vertex shader.
+struct VertexPositionQTangentTexture
+{
+    VertexPositionQTangentTexture() = default;
+    explicit VertexPositionQTangentTexture( const VertexPositionNormalTangentBitangentTexture& vertex );
+
+    glm::vec3    position;
+    glm::i16vec4 qTangent;
+    glm::u16vec2 texCoord;
+
+    // Check if the texture coordinate can be stored with half-precision without
+    // introducing more than maxError.
+    static bool canEncodeTexCoord( const glm::vec3& texCoord, float maxError = 1.0f / 2048.0f );
+
+    static WGPUVertexAttribute attributes[3];
+};
+
+static_assert( sizeof( VertexPositionQTangentTexture ) == 24, "Unexpected padding in VertexPositionQTangentTexture." );
+
+// Encode a tangent frame as a quaternion. If the tangent is degenerate, an
+// arbitrary tangent that is perpendicular to the normal is used.
+glm::i16vec4 encodeQTangent( const glm::vec3& normal, const glm::vec3& tangent, const glm::vec3& bitangent );
+
+}  // namespace WebGPUlib
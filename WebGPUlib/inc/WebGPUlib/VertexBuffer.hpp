@@ -31,7 +31,7 @@ public:
     }
 
 protected:
-    VertexBuffer( WGPUBuffer&& buffer, std::size_t vertexCount, std::size_t vertexStride );
+    VertexBuffer( WGPUBuffer&& buffer, std::size_t vertexCount, std::size_t vertexStride, std::size_t offset = 0 );
     ~VertexBuffer() override = default;
 
 private:
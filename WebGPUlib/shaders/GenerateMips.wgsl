@@ -67,27 +67,14 @@ fn loadColor( i : u32 ) -> vec4f
 // Source: https://en.wikipedia.org/wiki/SRGB#The_reverse_transformation
 fn convertToLinear( x : vec3f ) -> vec3f
 {
-    if( all(x < vec3f(0.04045f)) )
-    {
-    	return x / 12.92f;
-    }
-    else
-    {
-		return pow((x + 0.055f) / 1.055f, vec3f(2.4f));
-	}
+    // Select the curve per component so dark and bright channels of the same texel are converted correctly.
+    return select( pow( ( x + 0.055f ) / 1.055f, vec3f( 2.4f ) ), x / 12.92f, x < vec3f( 0.04045f ) );
 }
 
 // Source: https://en.wikipedia.org/wiki/SRGB#The_forward_transformation_(CIE_XYZ_to_sRGB)
 fn convertToSRGB( x : vec3f ) -> vec3f
 {
-    if( all(x < vec3f(0.0031308f)) )
-	{
-		return 12.92f * x;
-	}
-	else
-	{
-		return 1.055f * pow(x, vec3f(1.0f / 2.4f)) - 0.055f;
-	}
+    return select( 1.055f * pow( x, vec3f( 1.0f / 2.4f ) ) - 0.055f, 12.92f * x, x < vec3f( 0.0031308f ) );
 }
 
 fn packColor( x : vec4f ) -> vec4f
@@ -0,0 +1,35 @@
+R"(
+
+// Generate a single mip by rendering a full screen triangle to the mip.
+// This is used for texture formats that cannot be written with storage textures
+// (for example, r8unorm, rg8unorm and bgra8unorm). The source mip is sampled
+// with a bilinear filter at the center of each destination texel (2x2 box filter).
+
+struct VertexOutput
+{
+    @builtin(position) position : vec4f,
+    @location(0) uv : vec2f,
+};
+
+@group(0) @binding(0) var srcMip : texture_2d<f32>;
+@group(0) @binding(1) var linearClampSampler : sampler;
+
+@vertex
+fn vs_main( @builtin(vertex_index) vertexIndex : u32 ) -> VertexOutput
+{
+    // A triangle that covers the entire viewport.
+    let uv = vec2f( f32( ( vertexIndex << 1u ) & 2u ), f32( vertexIndex & 2u ) );
+
+    var out : VertexOutput;
+    out.position = vec4f( uv * vec2f( 2.0f, -2.0f ) + vec2f( -1.0f, 1.0f ), 0.0f, 1.0f );
+    out.uv = uv;
+
+    return out;
+}
+
+@fragment
+fn fs_main( in : VertexOutput ) -> @location(0) vec4f
+{
+    return textureSampleLevel( srcMip, linearClampSampler, in.uv, 0.0f );
+}
+)"
@@ -0,0 +1,161 @@
+R"(
+
+// Generate the full mip chain (up to 12 mips) of a texture in a single compute pass.
+// Based on the idea of AMD's FidelityFX Single Pass Downsampler (SPD).
+//
+// In the first dispatch, each workgroup downsamples a 64x64 tile of mip 0 to a single texel in mip 6.
+// A second dispatch with a single workgroup downsamples mip 6 (at most 64x64 texels) to the remaining
+// mips (7-12). WebGPU does not guarantee that the writes of a workgroup are visible to the other
+// workgroups of the same dispatch, but they are visible to the next dispatch.
+//
+// WebGPU only guarantees 4 storage textures per shader stage, so mips 1-4 are written
+// to storage textures while mips 5-12 are written to a buffer which is copied to the
+// texture after the dispatch.
+//
+// Each mip texel is the average of a 2x2 quad of the previous mip (box filter).
+
+struct ComputeShaderInput
+{
+    @builtin(workgroup_id) groupId : vec3u,             // Workgroup index in the dispatch.
+    @builtin(local_invocation_index) localIndex : u32,  // Local index of the thread in the workgroup.
+};
+
+struct SinglePassMipParams
+{
+    width : u32,                        // The width of mip 0.
+    height : u32,                       // The height of mip 0.
+    numMips : u32,                      // The number of mips of the texture (including mip 0).
+    srcLevel : u32,                     // The mip that is downsampled (0 in the first dispatch, 6 in the second).
+    bufferOffsets : array<vec4u, 2>,    // The offset (in texels) of mips 5-12 in the mip buffer.
+};
+
+@group(0) @binding(0) var<uniform> params : SinglePassMipParams;
+
+@group(0) @binding(1) var srcMip : texture_2d<f32>;
+
+@group(0) @binding(2) var dstMip1 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(3) var dstMip2 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(4) var dstMip3 : texture_storage_2d<rgba8unorm, write>;
+@group(0) @binding(5) var dstMip4 : texture_storage_2d<rgba8unorm, write>;
+
+// Mips 5-12 packed as rgba8unorm. Each row is aligned to 256 bytes (64 texels)
+// so that the buffer can be copied directly to the texture.
+@group(0) @binding(6) var<storage, read_write> mipBuffer : array<u32>;
+
+var<workgroup> gs_Color : array<vec4f, 256>;
+
+fn mipSize( mip : u32 ) -> vec2u
+{
+    return max( vec2u( params.width, params.height ) >> vec2u( mip ), vec2u( 1u ) );
+}
+
+fn bufferIndex( mip : u32, coord : vec2u ) -> u32
+{
+    let i = mip - 5u;
+    let rowPitch = ( mipSize( mip ).x + 63u ) & ~63u;
+    return params.bufferOffsets[i / 4u][i % 4u] + coord.y * rowPitch + coord.x;
+}
+
+// Load a texel of the source mip (mip 0 or mip 6).
+// Coordinates outside of the mip are clamped to the edge.
+fn loadColor( mip : u32, coord : vec2u ) -> vec4f
+{
+    let c = min( coord, mipSize( mip ) - 1u );
+
+    if ( mip == 0u )
+    {
+        return textureLoad( srcMip, c, 0 );
+    }
+
+    return unpack4x8unorm( mipBuffer[bufferIndex( mip, c )] );
+}
+
+fn storeColor( mip : u32, coord : vec2u, color : vec4f )
+{
+    if ( mip >= params.numMips || any( coord >= mipSize( mip ) ) )
+    {
+        return;
+    }
+
+    switch mip {
+        case 1u: { textureStore( dstMip1, coord, color ); }
+        case 2u: { textureStore( dstMip2, coord, color ); }
+        case 3u: { textureStore( dstMip3, coord, color ); }
+        case 4u: { textureStore( dstMip4, coord, color ); }
+        default: { mipBuffer[bufferIndex( mip, coord )] = pack4x8unorm( color ); }
+    }
+}
+
+// Downsample a 64x64 tile of srcLevel to the next 6 mips.
+// Reads outside of a mip are clamped to the edge of the mip (like the source texels in loadColor)
+// so texels outside of a mip never contribute to the next mip (for example, in non-square textures).
+fn downsampleTile( srcLevel : u32, tile : vec2u, localIndex : u32 )
+{
+    // Each thread computes a 2x2 quad of the first mip (32x32 texels per tile)
+    // and a single texel of the second mip (16x16 texels per tile).
+    let quad = vec2u( localIndex % 16u, localIndex / 16u );
+
+    var sum = vec4f( 0.0f );
+    for ( var i = 0u; i < 4u; i++ )
+    {
+        let dst = tile * 32u + quad * 2u + vec2u( i % 2u, i / 2u );
+        let src = min( dst, mipSize( srcLevel + 1u ) - 1u ) * 2u;
+
+        let color = 0.25f * ( loadColor( srcLevel, src ) +
+                              loadColor( srcLevel, src + vec2u( 1u, 0u ) ) +
+                              loadColor( srcLevel, src + vec2u( 0u, 1u ) ) +
+                              loadColor( srcLevel, src + vec2u( 1u, 1u ) ) );
+
+        storeColor( srcLevel + 1u, dst, color );
+        sum += color;
+    }
+
+    let color = 0.25f * sum;
+    storeColor( srcLevel + 2u, tile * 16u + quad, color );
+    gs_Color[localIndex] = color;
+
+    // Reduce the 16x16 texels in workgroup memory to 8x8, 4x4, 2x2 and 1x1 texels.
+    // The texel of each level is stored in the top-left corner of the quad it was computed from.
+    for ( var level = 1u; level <= 4u; level++ )
+    {
+        workgroupBarrier();
+
+        let n = 16u >> level;
+        let stride = 1u << level;
+        let offset = stride / 2u;
+        let texel = vec2u( localIndex % n, localIndex / n );
+
+        var reduced = vec4f( 0.0f );
+        if ( localIndex < n * n )
+        {
+            // The number of valid texels of the previous level in this tile.
+            let tileOrigin = tile * n * 2u;
+            let extent = max( mipSize( srcLevel + 1u + level ), tileOrigin + 1u ) - tileOrigin;
+
+            let s0 = min( texel * 2u, extent - 1u ) * offset;
+            let s1 = min( texel * 2u + 1u, extent - 1u ) * offset;
+
+            reduced = 0.25f * ( gs_Color[s0.y * 16u + s0.x] +
+                                gs_Color[s0.y * 16u + s1.x] +
+                                gs_Color[s1.y * 16u + s0.x] +
+                                gs_Color[s1.y * 16u + s1.x] );
+
+            storeColor( srcLevel + 2u + level, tile * n + texel, reduced );
+        }
+
+        // The clamped texels may be overwritten by other threads.
+        workgroupBarrier();
+
+        if ( localIndex < n * n )
+        {
+            gs_Color[texel.y * stride * 16u + texel.x * stride] = reduced;
+        }
+    }
+}
+
+@compute @workgroup_size(256, 1, 1)
+fn main( IN : ComputeShaderInput )
+{
+    downsampleTile( params.srcLevel, IN.groupId.xy, IN.localIndex );
+}
+)"
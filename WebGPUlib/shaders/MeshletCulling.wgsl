@@ -0,0 +1,112 @@
+R"(
+
+// Cull the meshlets of a mesh against the view frustum and the normal cone of
+// the meshlet and write the indices of the visible meshlets to a compacted index
+// buffer that is drawn with drawIndexedIndirect.
+// Each workgroup processes a single meshlet. Large meshes are dispatched as a 2D grid
+// of workgroups, since the number of workgroups in each dimension is limited.
+
+struct ComputeShaderInput
+{
+    @builtin(workgroup_id) groupId : vec3u,             // Workgroup index in the dispatch.
+    @builtin(num_workgroups) numGroups : vec3u,         // Number of workgroups in the dispatch.
+    @builtin(local_invocation_index) localIndex : u32,  // Local index of the thread in the workgroup.
+};
+
+struct Meshlet
+{
+    center : vec3f,     // Object-space bounding sphere.
+    radius : f32,
+    coneAxis : vec3f,   // Object-space normal cone.
+    coneCutoff : f32,
+    firstIndex : u32,   // First index of the meshlet in the meshlet index buffer.
+    indexCount : u32,   // Number of indices in the meshlet.
+};
+
+struct CullParams
+{
+    frustumPlanes : array<vec4f, 6>, // Object-space frustum planes (normalized, pointing inwards).
+    cameraPosition : vec4f,          // Object-space camera position.
+    meshletCount : u32,              // The number of meshlets of the mesh.
+    drawIndex : u32,                 // The index of the draw arguments to write.
+    firstIndex : u32,                // The first index in the output index buffer for this draw.
+};
+
+// Matches the layout of the arguments of drawIndexedIndirect.
+struct DrawIndexedIndirectArgs
+{
+    indexCount : atomic<u32>,
+    instanceCount : u32,
+    firstIndex : u32,
+    baseVertex : i32,
+    firstInstance : u32,
+};
+
+@group(0) @binding(0) var<uniform> params : CullParams;
+@group(0) @binding(1) var<storage, read> meshlets : array<Meshlet>;
+@group(0) @binding(2) var<storage, read> meshletIndices : array<u32>;
+@group(0) @binding(3) var<storage, read_write> outputIndices : array<u32>;
+@group(0) @binding(4) var<storage, read_write> drawArgs : array<DrawIndexedIndirectArgs>;
+
+const WORKGROUP_SIZE = 64u;
+
+var<workgroup> isVisible : u32;
+var<workgroup> outputOffset : u32;
+
+fn isMeshletVisible( meshlet : Meshlet ) -> bool
+{
+    // Frustum culling.
+    for ( var i = 0u; i < 6u; i++ )
+    {
+        let plane = params.frustumPlanes[i];
+        if ( dot( plane.xyz, meshlet.center ) + plane.w < -meshlet.radius )
+        {
+            return false;
+        }
+    }
+
+    // Back-face culling using the normal cone of the meshlet.
+    let v = meshlet.center - params.cameraPosition.xyz;
+    if ( dot( v, meshlet.coneAxis ) >= meshlet.coneCutoff * length( v ) + meshlet.radius )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+@compute @workgroup_size( WORKGROUP_SIZE )
+fn main( IN : ComputeShaderInput )
+{
+    let meshletIndex = IN.groupId.y * IN.numGroups.x + IN.groupId.x;
+    if ( meshletIndex >= params.meshletCount )
+    {
+        return;
+    }
+
+    let meshlet = meshlets[meshletIndex];
+
+    // The first thread of the workgroup culls the meshlet and allocates space in the output index buffer.
+    if ( IN.localIndex == 0u )
+    {
+        isVisible = 0u;
+        if ( isMeshletVisible( meshlet ) )
+        {
+            isVisible = 1u;
+            outputOffset = atomicAdd( &drawArgs[params.drawIndex].indexCount, meshlet.indexCount );
+        }
+    }
+
+    if ( workgroupUniformLoad( &isVisible ) == 0u )
+    {
+        return;
+    }
+
+    // Copy the indices of the meshlet to the output index buffer.
+    let dst = params.firstIndex + outputOffset;
+    for ( var i = IN.localIndex; i < meshlet.indexCount; i += WORKGROUP_SIZE )
+    {
+        outputIndices[dst + i] = meshletIndices[meshlet.firstIndex + i];
+    }
+}
+)"
@@ -0,0 +1,44 @@
+R"(
+
+// Helper functions to decode the compact vertex layouts that are defined in Vertex.hpp.
+// This file can be prepended to the shader code of a pipeline that uses
+// the compact vertex layouts:
+//
+// const char* shaderCode = {
+// #include <VertexDecode.wgsl>
+// #include "MyShader.wgsl"
+// };
+
+struct TangentFrame
+{
+    tangent   : vec3f,
+    bitangent : vec3f,
+    normal    : vec3f,
+};
+
+// Decode a tangent frame that is stored as a quaternion (VertexPositionQTangentTexture::qTangent).
+// The sign of the w component is used to store the handedness of the bitangent.
+fn decodeQTangent( qTangent : vec4f ) -> TangentFrame
+{
+    let q = normalize( qTangent );
+
+    var frame : TangentFrame;
+    frame.tangent = vec3f( 1.0f - 2.0f * ( q.y * q.y + q.z * q.z ),
+                           2.0f * ( q.x * q.y + q.w * q.z ),
+                           2.0f * ( q.x * q.z - q.w * q.y ) );
+    frame.bitangent = vec3f( 2.0f * ( q.x * q.y - q.w * q.z ),
+                             1.0f - 2.0f * ( q.x * q.x + q.z * q.z ),
+                             2.0f * ( q.y * q.z + q.w * q.x ) );
+    frame.normal = vec3f( 2.0f * ( q.x * q.z + q.w * q.y ),
+                          2.0f * ( q.y * q.z - q.w * q.x ),
+                          1.0f - 2.0f * ( q.x * q.x + q.y * q.y ) );
+
+    // Reflected tangent frames are stored with a negative w component.
+    if ( qTangent.w < 0.0f )
+    {
+        frame.bitangent = -frame.bitangent;
+    }
+
+    return frame;
+}
+)"
@@ -0,0 +1,598 @@
+#include <WebGPUlib/AssetArchive.hpp>
+#include <WebGPUlib/FileReader.hpp>
+#include <WebGPUlib/ThreadPool.hpp>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+using namespace WebGPUlib;
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr uint32_t ARCHIVE_MAGIC   = 0x41504757;  // "WGPA"
+constexpr uint32_t ARCHIVE_VERSION = 2;  // Version 2 stores the modification time of the files.
+
+// Uncompressed files are aligned to the page size. Compressed files only need to be read byte by byte.
+constexpr uint64_t UNCOMPRESSED_ALIGNMENT = 4096;
+constexpr uint64_t COMPRESSED_ALIGNMENT   = 16;
+
+// Only files smaller than 4 GB are compressed (the LZ4 hash table stores 32-bit positions).
+constexpr uint64_t MAX_COMPRESSED_FILE_SIZE = UINT32_MAX;
+// A byte of LZ4 data decompresses to at most 255 bytes.
+constexpr uint64_t MAX_LZ4_RATIO = 255;
+
+struct ArchiveHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t numEntries;
+    uint64_t tocOffset;      // The offset of the table of contents.
+    uint64_t stringsOffset;  // The offset of the string table (the paths of the files).
+    uint64_t stringsSize;
+};
+
+// 64-bit FNV-1a hash of a path.
+uint64_t hashPath( std::string_view path )
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for ( char c: path )
+    {
+        hash ^= static_cast<uint8_t>( c );
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+// Get the path of a file relative to the root of an archive (empty if the file is not inside the root).
+std::string getRelativePath( const fs::path& filePath, const fs::path& rootPath )
+{
+    fs::path relativePath = filePath.lexically_normal().lexically_relative( rootPath );
+    if ( relativePath.empty() || *relativePath.begin() == ".." || *relativePath.begin() == "." )
+        return {};
+
+    return relativePath.generic_string();
+}
+
+uint32_t read32( const uint8_t* ptr )
+{
+    uint32_t value;
+    std::memcpy( &value, ptr, sizeof( value ) );
+    return value;
+}
+
+// Write a literal or match length that does not fit in the 4 bits of the token.
+void writeLength( std::vector<uint8_t>& dst, std::size_t length )
+{
+    for ( ; length >= 255; length -= 255 )
+        dst.push_back( 255 );
+
+    dst.push_back( static_cast<uint8_t>( length ) );
+}
+
+void writeSequence( std::vector<uint8_t>& dst, const uint8_t* literals, std::size_t literalLength,
+                    std::size_t offset, std::size_t matchLength )
+{
+    const std::size_t matchCode = matchLength > 0 ? matchLength - 4 : 0;
+
+    const auto token = static_cast<uint8_t>( ( std::min<std::size_t>( literalLength, 15 ) << 4 ) |
+                                             std::min<std::size_t>( matchCode, 15 ) );
+    dst.push_back( token );
+
+    if ( literalLength >= 15 )
+        writeLength( dst, literalLength - 15 );
+
+    dst.insert( dst.end(), literals, literals + literalLength );
+
+    // The last sequence only has literals.
+    if ( matchLength == 0 )
+        return;
+
+    dst.push_back( static_cast<uint8_t>( offset & 0xff ) );
+    dst.push_back( static_cast<uint8_t>( offset >> 8 ) );
+
+    if ( matchCode >= 15 )
+        writeLength( dst, matchCode - 15 );
+}
+
+// Compress data with the LZ4 block format (greedy matching with a hash table of the last positions).
+std::vector<uint8_t> compressLZ4( const uint8_t* src, std::size_t size )
+{
+    // The last match must start at least 12 bytes before the end of the block
+    // and the last 5 bytes of the block are always literals.
+    constexpr std::size_t MIN_MATCH        = 4;
+    constexpr std::size_t MATCH_LIMIT      = 12;
+    constexpr std::size_t LAST_LITERALS    = 5;
+    constexpr std::size_t MAX_OFFSET       = 65535;
+    constexpr uint32_t    HASH_BITS        = 16;
+    constexpr uint32_t    INVALID_POSITION = UINT32_MAX;
+
+    std::vector<uint8_t> dst;
+    dst.reserve( size + size / 255 + 16 );
+
+    std::vector<uint32_t> hashTable( std::size_t { 1 } << HASH_BITS, INVALID_POSITION );
+
+    std::size_t anchor = 0;
+    std::size_t pos    = 0;
+
+    if ( size > MATCH_LIMIT )
+    {
+        const std::size_t matchLimit = size - MATCH_LIMIT;
+        const std::size_t matchEnd   = size - LAST_LITERALS;
+
+        while ( pos < matchLimit )
+        {
+            const uint32_t sequence = read32( src + pos );
+            const uint32_t hash     = ( sequence * 2654435761u ) >> ( 32 - HASH_BITS );
+            const uint32_t ref      = hashTable[hash];
+            hashTable[hash]         = static_cast<uint32_t>( pos );
+
+            if ( ref == INVALID_POSITION || pos - ref > MAX_OFFSET || read32( src + ref ) != sequence )
+            {
+                ++pos;
+                continue;
+            }
+
+            std::size_t matchLength = MIN_MATCH;
+            while ( pos + matchLength < matchEnd && src[ref + matchLength] == src[pos + matchLength] )
+                ++matchLength;
+
+            writeSequence( dst, src + anchor, pos - anchor, pos - ref, matchLength );
+
+            pos += matchLength;
+            anchor = pos;
+        }
+    }
+
+    writeSequence( dst, src + anchor, size - anchor, 0, 0 );
+
+    return dst;
+}
+
+// Read a literal or match length that does not fit in the 4 bits of the token.
+bool readLength( const uint8_t*& src, const uint8_t* srcEnd, std::size_t& length )
+{
+    uint8_t value;
+    do
+    {
+        if ( src == srcEnd )
+            return false;
+
+        value = *src++;
+        length += value;
+    } while ( value == 255 );
+
+    return true;
+}
+
+// Decompress a LZ4 block. Returns false if the block is not valid or does not decompress to exactly size bytes.
+bool decompressLZ4( const uint8_t* src, std::size_t srcSize, uint8_t* dst, std::size_t size )
+{
+    const uint8_t* srcEnd = src + srcSize;
+    uint8_t*       out    = dst;
+    uint8_t*       outEnd = dst + size;
+
+    while ( src < srcEnd )
+    {
+        const uint8_t token = *src++;
+
+        std::size_t literalLength = token >> 4;
+        if ( literalLength == 15 && !readLength( src, srcEnd, literalLength ) )
+            return false;
+
+        if ( literalLength > static_cast<std::size_t>( srcEnd - src ) ||
+             literalLength > static_cast<std::size_t>( outEnd - out ) )
+            return false;
+
+        std::memcpy( out, src, literalLength );
+        src += literalLength;
+        out += literalLength;
+
+        // The last sequence only has literals.
+        if ( src == srcEnd )
+            break;
+
+        if ( srcEnd - src < 2 )
+            return false;
+
+        const std::size_t offset = src[0] | ( src[1] << 8 );
+        src += 2;
+
+        if ( offset == 0 || offset > static_cast<std::size_t>( out - dst ) )
+            return false;
+
+        std::size_t matchLength = token & 15;
+        if ( matchLength == 15 && !readLength( src, srcEnd, matchLength ) )
+            return false;
+
+        matchLength += 4;
+        if ( matchLength > static_cast<std::size_t>( outEnd - out ) )
+            return false;
+
+        // The match may overlap the output (repeated patterns), so it is copied byte by byte.
+        const uint8_t* match = out - offset;
+        if ( offset >= matchLength )
+        {
+            std::memcpy( out, match, matchLength );
+            out += matchLength;
+        }
+        else
+        {
+            for ( std::size_t i = 0; i < matchLength; ++i )
+                *out++ = match[i];
+        }
+    }
+
+    return out == outEnd;
+}
+
+// A file that is added to an archive.
+struct ArchiveFile
+{
+    std::string          path;
+    uint64_t             pathHash     = 0;
+    uint64_t             size         = 0;
+    int64_t              modifiedTime = 0;
+    bool                 compress     = true;
+    ArchiveCompression   compression  = ArchiveCompression::None;
+    std::vector<uint8_t> data;
+};
+
+void loadArchiveFile( ArchiveFile& file, const fs::path& directory )
+{
+    auto data = FileReader::readFile( directory / file.path );
+    file.size = data.size();
+
+    std::error_code error;
+    file.modifiedTime = fs::last_write_time( directory / file.path, error ).time_since_epoch().count();
+
+    // Only keep the compressed data if it is smaller (block compressed textures hardly compress).
+    // The LZ4 hash table stores 32-bit positions.
+    if ( file.compress && !data.empty() && data.size() < MAX_COMPRESSED_FILE_SIZE )
+    {
+        auto compressed = compressLZ4( data.data(), data.size() );
+        if ( compressed.size() < data.size() - data.size() / 16 )
+        {
+            file.compression = ArchiveCompression::LZ4;
+            file.data        = std::move( compressed );
+            return;
+        }
+    }
+
+    file.data = std::move( data );
+}
+
+void writePadding( std::ofstream& file, uint64_t& offset, uint64_t alignment )
+{
+    static constexpr char zeros[UNCOMPRESSED_ALIGNMENT] {};
+
+    const uint64_t padding = ( alignment - offset % alignment ) % alignment;
+    file.write( zeros, static_cast<std::streamsize>( padding ) );
+    offset += padding;
+}
+}  // namespace
+
+std::unique_ptr<AssetArchive> AssetArchive::open( const fs::path& archivePath, const fs::path& rootPath )
+{
+    std::unique_ptr<AssetArchive> archive( new AssetArchive() );
+    archive->rootPath = rootPath.lexically_normal();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW( archivePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( file == INVALID_HANDLE_VALUE )
+    {
+        std::cerr << "ERROR: Failed to open archive: " << archivePath << std::endl;
+        return nullptr;
+    }
+    archive->fileHandle = file;
+
+    LARGE_INTEGER fileSize {};
+    GetFileSizeEx( file, &fileSize );
+    archive->size = static_cast<std::size_t>( fileSize.QuadPart );
+
+    if ( archive->size >= sizeof( ArchiveHeader ) )
+    {
+        archive->mappingHandle = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+        if ( archive->mappingHandle )
+            archive->data = static_cast<const uint8_t*>(
+                MapViewOfFile( archive->mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+    }
+#else
+    const int file = ::open( archivePath.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( file < 0 )
+    {
+        std::cerr << "ERROR: Failed to open archive: " << archivePath << std::endl;
+        return nullptr;
+    }
+
+    struct stat fileStat {};
+    if ( fstat( file, &fileStat ) == 0 && static_cast<std::size_t>( fileStat.st_size ) >= sizeof( ArchiveHeader ) )
+    {
+        void* ptr = mmap( nullptr, static_cast<std::size_t>( fileStat.st_size ), PROT_READ, MAP_PRIVATE, file, 0 );
+        if ( ptr != MAP_FAILED )
+        {
+            archive->data = static_cast<const uint8_t*>( ptr );
+            archive->size = static_cast<std::size_t>( fileStat.st_size );
+        }
+    }
+
+    // The mapping stays valid after the file is closed.
+    close( file );
+#endif
+
+    if ( !archive->data )
+    {
+        std::cerr << "ERROR: Failed to map archive: " << archivePath << std::endl;
+        return nullptr;
+    }
+
+    // Validate the header and the table of contents.
+    ArchiveHeader header {};
+    std::memcpy( &header, archive->data, sizeof( header ) );
+
+    const uint64_t size = archive->size;
+    if ( header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION || header.tocOffset > size ||
+         header.numEntries > ( size - header.tocOffset ) / sizeof( Entry ) || header.tocOffset % alignof( Entry ) ||
+         header.stringsOffset > size || header.stringsSize > size - header.stringsOffset )
+    {
+        std::cerr << "ERROR: Invalid archive: " << archivePath << std::endl;
+        return nullptr;
+    }
+
+    archive->entries    = reinterpret_cast<const Entry*>( archive->data + header.tocOffset );
+    archive->numEntries = static_cast<std::size_t>( header.numEntries );
+    archive->strings    = reinterpret_cast<const char*>( archive->data + header.stringsOffset );
+
+    for ( std::size_t i = 0; i < archive->numEntries; ++i )
+    {
+        const Entry& entry = archive->entries[i];
+        if ( entry.offset > size || entry.storedSize > size - entry.offset ||
+             static_cast<uint64_t>( entry.pathOffset ) + entry.pathLength > header.stringsSize ||
+             entry.compression > static_cast<uint32_t>( ArchiveCompression::LZ4 ) ||
+             ( entry.compression == static_cast<uint32_t>( ArchiveCompression::None ) &&
+               entry.storedSize != entry.size ) ||
+             // The decompressed size is allocated before decompressing, so it must be plausible.
+             ( entry.compression == static_cast<uint32_t>( ArchiveCompression::LZ4 ) &&
+               ( entry.size >= MAX_COMPRESSED_FILE_SIZE || entry.size > entry.storedSize * MAX_LZ4_RATIO ) ) ||
+             ( i > 0 && archive->entries[i - 1].pathHash > entry.pathHash ) )
+        {
+            std::cerr << "ERROR: Invalid archive: " << archivePath << std::endl;
+            return nullptr;
+        }
+    }
+
+    std::cout << "INFO: Opened archive: " << archivePath.string() << " (" << archive->numEntries << " files)"
+              << std::endl;
+
+    return archive;
+}
+
+bool AssetArchive::create( const fs::path& archivePath, const fs::path& directory,
+                           const std::function<bool( const fs::path& )>& filter, bool compress,
+                           ThreadPool* threadPool, const std::function<bool( const fs::path& )>& compressFilter )
+{
+    std::error_code error;
+
+    std::vector<ArchiveFile> files;
+    for ( const auto& directoryEntry: fs::recursive_directory_iterator( directory, error ) )
+    {
+        if ( !directoryEntry.is_regular_file() || ( filter && !filter( directoryEntry.path() ) ) )
+            continue;
+
+        // Don't add the archive to itself.
+        std::error_code equivalentError;
+        if ( fs::equivalent( directoryEntry.path(), archivePath, equivalentError ) )
+            continue;
+
+        ArchiveFile file;
+        file.path     = directoryEntry.path().lexically_relative( directory ).generic_string();
+        file.pathHash = hashPath( file.path );
+        file.compress = compress && ( !compressFilter || compressFilter( directoryEntry.path() ) );
+        files.push_back( std::move( file ) );
+    }
+
+    if ( error )
+    {
+        std::cerr << "ERROR: Failed to read directory: " << directory << " (" << error.message() << ")" << std::endl;
+        return false;
+    }
+
+    std::sort( files.begin(), files.end(), []( const ArchiveFile& a, const ArchiveFile& b ) {
+        return a.pathHash != b.pathHash ? a.pathHash < b.pathHash : a.path < b.path;
+    } );
+
+    std::ofstream file( archivePath, std::ios::binary | std::ios::trunc );
+    if ( !file )
+    {
+        std::cerr << "ERROR: Failed to create archive: " << archivePath << std::endl;
+        return false;
+    }
+
+    // The header is written again when the offsets of the table of contents are known.
+    ArchiveHeader header {};
+    header.magic      = ARCHIVE_MAGIC;
+    header.version    = ARCHIVE_VERSION;
+    header.numEntries = files.size();
+    file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+    std::vector<Entry> entries( files.size() );
+    std::string        strings;
+    uint64_t           offset     = sizeof( header );
+    uint64_t           storedSize = 0;
+    uint64_t           totalSize  = 0;
+
+    // The files are loaded (and compressed) in batches so only a batch of files is kept in memory.
+    constexpr std::size_t batchSize = 64;
+    for ( std::size_t first = 0; first < files.size(); first += batchSize )
+    {
+        const std::size_t count = std::min( batchSize, files.size() - first );
+        if ( threadPool )
+        {
+            threadPool->parallelFor(
+                count, [&]( std::size_t i ) { loadArchiveFile( files[first + i], directory ); } );
+        }
+        else
+        {
+            for ( std::size_t i = 0; i < count; ++i )
+                loadArchiveFile( files[first + i], directory );
+        }
+
+        for ( std::size_t i = first; i < first + count; ++i )
+        {
+            auto& archiveFile = files[i];
+            writePadding( file, offset, archiveFile.compression == ArchiveCompression::None ? UNCOMPRESSED_ALIGNMENT
+                                                                                            : COMPRESSED_ALIGNMENT );
+
+            Entry& entry       = entries[i];
+            entry.pathHash     = archiveFile.pathHash;
+            entry.offset       = offset;
+            entry.size         = archiveFile.size;
+            entry.storedSize   = archiveFile.data.size();
+            entry.modifiedTime = archiveFile.modifiedTime;
+            entry.compression  = static_cast<uint32_t>( archiveFile.compression );
+            entry.pathOffset   = static_cast<uint32_t>( strings.size() );
+            entry.pathLength   = static_cast<uint32_t>( archiveFile.path.size() );
+            entry.reserved     = 0;
+
+            file.write( reinterpret_cast<const char*>( archiveFile.data.data() ),
+                        static_cast<std::streamsize>( archiveFile.data.size() ) );
+            offset += archiveFile.data.size();
+
+            strings += archiveFile.path;
+            storedSize += archiveFile.data.size();
+            totalSize += archiveFile.size;
+
+            archiveFile.data = {};
+        }
+    }
+
+    writePadding( file, offset, alignof( Entry ) );
+    header.tocOffset = offset;
+    file.write( reinterpret_cast<const char*>( entries.data() ),
+                static_cast<std::streamsize>( entries.size() * sizeof( Entry ) ) );
+    offset += entries.size() * sizeof( Entry );
+
+    header.stringsOffset = offset;
+    header.stringsSize   = strings.size();
+    file.write( strings.data(), static_cast<std::streamsize>( strings.size() ) );
+
+    file.seekp( 0 );
+    file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+    if ( !file )
+    {
+        std::cerr << "ERROR: Failed to write archive: " << archivePath << std::endl;
+        return false;
+    }
+
+    std::cout << "INFO: Created archive: " << archivePath.string() << " (" << files.size() << " files, "
+              << totalSize / 1024 << " KB -> " << storedSize / 1024 << " KB)" << std::endl;
+
+    return true;
+}
+
+AssetArchive::~AssetArchive()
+{
+#ifdef _WIN32
+    if ( data )
+        UnmapViewOfFile( data );
+    if ( mappingHandle )
+        CloseHandle( mappingHandle );
+    if ( fileHandle )
+        CloseHandle( fileHandle );
+#else
+    if ( data )
+        munmap( const_cast<uint8_t*>( data ), size );
+#endif
+}
+
+const AssetArchive::Entry* AssetArchive::find( const fs::path& filePath ) const
+{
+    const std::string path = getRelativePath( filePath, rootPath );
+    if ( path.empty() )
+        return nullptr;
+
+    const uint64_t pathHash = hashPath( path );
+
+    const Entry* end  = entries + numEntries;
+    const Entry* iter = std::lower_bound( entries, end, pathHash,
+                                          []( const Entry& entry, uint64_t hash ) { return entry.pathHash < hash; } );
+
+    // Compare the paths of the entries with the same hash.
+    for ( ; iter != end && iter->pathHash == pathHash; ++iter )
+    {
+        if ( std::string_view( strings + iter->pathOffset, iter->pathLength ) == path )
+            return iter;
+    }
+
+    return nullptr;
+}
+
+bool AssetArchive::contains( const fs::path& filePath ) const
+{
+    return find( filePath ) != nullptr;
+}
+
+std::vector<uint8_t> AssetArchive::read( const fs::path& filePath ) const
+{
+    const Entry* entry = find( filePath );
+    if ( !entry )
+        return {};
+
+    const uint8_t* storedData = data + entry->offset;
+
+    if ( entry->compression == static_cast<uint32_t>( ArchiveCompression::None ) )
+        return { storedData, storedData + entry->size };
+
+    std::vector<uint8_t> fileData( static_cast<std::size_t>( entry->size ) );
+    if ( !decompressLZ4( storedData, static_cast<std::size_t>( entry->storedSize ), fileData.data(),
+                         fileData.size() ) )
+    {
+        std::cerr << "ERROR: Failed to decompress file: " << filePath << std::endl;
+        return {};
+    }
+
+    return fileData;
+}
+
+const uint8_t* AssetArchive::getMappedData( const fs::path& filePath, std::size_t& fileSize ) const
+{
+    const Entry* entry = find( filePath );
+    if ( !entry || entry->compression != static_cast<uint32_t>( ArchiveCompression::None ) )
+        return nullptr;
+
+    fileSize = static_cast<std::size_t>( entry->size );
+
+    return data + entry->offset;
+}
+
+bool AssetArchive::getModifiedTime( const fs::path& filePath, fs::file_time_type& time ) const
+{
+    const Entry* entry = find( filePath );
+    if ( !entry )
+        return false;
+
+    time = fs::file_time_type( fs::file_time_type::duration( entry->modifiedTime ) );
+
+    return true;
+}
@@ -25,11 +25,12 @@ void BindGroup::bind( uint32_t binding, WGPUBuffer buffer, uint64_t offset, uint
     entry.size    = size;
 
     bindings[binding] = entry;
+    dirty             = true;
 }
 
 void BindGroup::bind( uint32_t binding, const Buffer& buffer, uint64_t offset, std::optional<uint64_t> size )
 {
-    bind( binding, buffer.getWGPUBuffer(), offset, size ? *size : buffer.getSize() );
+    bind( binding, buffer.getWGPUBuffer(), buffer.getOffset() + offset, size ? *size : buffer.getSize() );
 }
 
 void BindGroup::bind( uint32_t binding, const Sampler& sampler )
@@ -42,6 +43,7 @@ void BindGroup::bind( uint32_t binding, const Sampler& sampler )
     entry.sampler = sampler.getWGPUSampler();
 
     bindings[binding] = entry;
+    dirty             = true;
 }
 
 void BindGroup::bind( uint32_t binding, const TextureView& textureView )
@@ -54,10 +56,15 @@ void BindGroup::bind( uint32_t binding, const TextureView& textureView )
     entry.textureView = textureView.getWGPUTextureView();
 
     bindings[binding] = entry;
+    dirty             = true;
 }
 
 WGPUBindGroup BindGroup::getWGPUBindGroup( WGPUBindGroupLayout layout ) const
 {
+    // Reuse the bind group if nothing changed.
+    if ( bindGroup && !dirty && layout == bindGroupLayout )
+        return bindGroup;
+
     if ( bindGroup )
         wgpuBindGroupRelease( bindGroup );
 
@@ -68,7 +75,9 @@ WGPUBindGroup BindGroup::getWGPUBindGroup( WGPUBindGroupLayout layout ) const
 
     auto device = Device::get().getWGPUDevice();
 
-    bindGroup = wgpuDeviceCreateBindGroup( device, &bindGroupDescriptor );
+    bindGroup       = wgpuDeviceCreateBindGroup( device, &bindGroupDescriptor );
+    bindGroupLayout = layout;
+    dirty           = false;
 
     return bindGroup;
 }
\ No newline at end of file
@@ -2,8 +2,9 @@
 
 using namespace WebGPUlib;
 
-Buffer::Buffer( WGPUBuffer&& _buffer )  // NOLINT(cppcoreguidelines-rvalue-reference-param-not-moved)
+Buffer::Buffer( WGPUBuffer&& _buffer, std::size_t _offset )  // NOLINT(cppcoreguidelines-rvalue-reference-param-not-moved)
 : buffer( _buffer )
+, offset( _offset )
 {}
 
 Buffer::~Buffer()
@@ -6,6 +6,8 @@
 #include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/UploadBuffer.hpp>
 
+#include <utility>
+
 #ifdef WEBGPU_BACKEND_DAWN
 void wgpuCommandEncoderReference( WGPUCommandEncoder encoder )
 {
@@ -30,15 +32,24 @@ struct MakeUploadBuffer : UploadBuffer
 std::shared_ptr<BindGroup> CommandBuffer::getBindGroup( uint32_t groupIndex )
 {
     if ( bindGroups.size() <= groupIndex )
+    {
         bindGroups.resize( groupIndex + 1, nullptr );
+        bindGroupOffsets.resize( groupIndex + 1 );
+    }
+    if ( dynamicBindGroups.size() <= groupIndex )
+        dynamicBindGroups.resize( groupIndex + 1, nullptr );
 
-    auto bindGroup = bindGroups[groupIndex];
+    auto bindGroup = dynamicBindGroups[groupIndex];
     if ( !bindGroup )
     {
-        bindGroup              = std::make_shared<MakeBindGroup>();
-        bindGroups[groupIndex] = bindGroup;
+        bindGroup                     = std::make_shared<MakeBindGroup>();
+        dynamicBindGroups[groupIndex] = bindGroup;
     }
 
+    // Replace a prebuilt bind group that was bound to this group index.
+    bindGroups[groupIndex] = bindGroup;
+    bindGroupOffsets[groupIndex].clear();
+
     return bindGroup;
 }
 
@@ -47,7 +58,7 @@ void CommandBuffer::commitBindGroups()
     for ( uint32_t i = 0; i < bindGroups.size(); ++i )
     {
         if ( auto& bindGroup = bindGroups[i] )
-            setBindGroup( i, *bindGroup );
+            setBindGroup( i, *bindGroup, bindGroupOffsets[i] );
     }
 }
 
@@ -70,6 +81,30 @@ void CommandBuffer::bindTexture( uint32_t groupIndex, uint32_t binding, const Te
     bindGroup->bind( binding, texture );
 }
 
+void CommandBuffer::bindBindGroup( uint32_t groupIndex, std::shared_ptr<BindGroup> bindGroup,
+                                   std::vector<uint32_t> dynamicOffsets )
+{
+    if ( bindGroups.size() <= groupIndex )
+    {
+        bindGroups.resize( groupIndex + 1, nullptr );
+        bindGroupOffsets.resize( groupIndex + 1 );
+    }
+
+    bindGroups[groupIndex]       = std::move( bindGroup );
+    bindGroupOffsets[groupIndex] = std::move( dynamicOffsets );
+}
+
+void CommandBuffer::resetBindGroup( uint32_t groupIndex )
+{
+    if ( groupIndex < bindGroups.size() )
+    {
+        bindGroups[groupIndex] = nullptr;
+        bindGroupOffsets[groupIndex].clear();
+    }
+    if ( groupIndex < dynamicBindGroups.size() )
+        dynamicBindGroups[groupIndex] = nullptr;
+}
+
 void CommandBuffer::bindDynamicUniformBuffer( uint32_t groupIndex, uint32_t binding, const void* data,
                                               std::size_t sizeInBytes )
 {
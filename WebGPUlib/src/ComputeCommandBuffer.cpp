@@ -1,8 +1,12 @@
 #include <WebGPUlib/BindGroup.hpp>
+#include <WebGPUlib/Buffer.hpp>
 #include <WebGPUlib/ComputeCommandBuffer.hpp>
 #include <WebGPUlib/ComputePipelineState.hpp>
+#include <WebGPUlib/Texture.hpp>
+#include <WebGPUlib/TextureData.hpp>
 #include <WebGPUlib/UploadBuffer.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace WebGPUlib;
@@ -12,16 +16,74 @@ void ComputeCommandBuffer::setComputePipeline( ComputePipelineState& pipeline )
     // Keep track of the currently bound pipeline
     currentPipelineState = &pipeline;
 
-    pipeline.bind( *this );
+    // The dispatches are skipped until the pipeline is ready.
+    if ( pipeline.isReady() )
+        pipeline.bind( *this );
 }
 
 void ComputeCommandBuffer::dispatch( uint32_t x, uint32_t y, uint32_t z )
 {
+    if ( currentPipelineState && !currentPipelineState->isReady() )
+        return;
+
     commitBindGroups();
 
     wgpuComputePassEncoderDispatchWorkgroups( passEncoder, x, y, z );
 }
 
+void ComputeCommandBuffer::copyBufferToTexture( const Buffer& buffer, uint64_t offset, uint32_t bytesPerRow,
+                                                const Texture& texture, uint32_t mip )
+{
+    auto desc = texture.getWGPUTextureDescriptor();
+
+    BufferToTextureCopy copy {};
+    copy.source.buffer              = buffer.getWGPUBuffer();
+    copy.source.layout.offset       = buffer.getOffset() + offset;
+    copy.source.layout.bytesPerRow  = bytesPerRow;
+    copy.source.layout.rowsPerImage = std::max( desc.size.height >> mip, 1u );
+    copy.destination.texture        = texture.getWGPUTexture();
+    copy.destination.mipLevel       = mip;
+    copy.destination.origin         = { 0, 0, 0 };
+    copy.destination.aspect         = WGPUTextureAspect_All;
+    copy.size                       = { std::max( desc.size.width >> mip, 1u ), copy.source.layout.rowsPerImage, 1 };
+
+    pendingCopies.push_back( copy );
+}
+
+void ComputeCommandBuffer::copyTextureToTexture( const Texture& source, const Texture& destination, uint32_t mip,
+                                                 uint32_t destinationLayer )
+{
+    copyTextureToTexture( source, mip, destination, mip, destinationLayer );
+}
+
+void ComputeCommandBuffer::copyTextureToTexture( const Texture& source, uint32_t sourceMip, const Texture& destination,
+                                                 uint32_t destinationMip, uint32_t destinationLayer )
+{
+    auto desc = source.getWGPUTextureDescriptor();
+
+    // Block compressed textures are copied in whole blocks (even if the mip is smaller than a block).
+    uint32_t width  = std::max( desc.size.width >> sourceMip, 1u );
+    uint32_t height = std::max( desc.size.height >> sourceMip, 1u );
+    if ( isBlockCompressed( desc.format ) )
+    {
+        width  = ( width + 3 ) & ~3u;
+        height = ( height + 3 ) & ~3u;
+    }
+
+    TextureToTextureCopy copy {};
+    copy.source.texture       = source.getWGPUTexture();
+    copy.source.mipLevel      = sourceMip;
+    copy.source.origin        = { 0, 0, 0 };
+    copy.source.aspect        = WGPUTextureAspect_All;
+    copy.destination.texture  = destination.getWGPUTexture();
+    copy.destination.mipLevel = destinationMip;
+    copy.destination.origin   = { 0, 0, destinationLayer };
+    copy.destination.aspect   = WGPUTextureAspect_All;
+    copy.size                 = { width, height, 1 };
+
+    pendingTextureCopies.push_back( copy );
+}
+
 ComputeCommandBuffer::ComputeCommandBuffer( WGPUCommandEncoder&& encoder, WGPUComputePassEncoder&& passEncoder )
 : CommandBuffer { std::move( encoder ) }  // NOLINT(performance-move-const-arg)
 , passEncoder { passEncoder }
@@ -33,13 +95,15 @@ ComputeCommandBuffer::~ComputeCommandBuffer()
         wgpuComputePassEncoderRelease( passEncoder );
 }
 
-void ComputeCommandBuffer::setBindGroup( uint32_t groupIndex, const BindGroup& _bindGroup )
+void ComputeCommandBuffer::setBindGroup( uint32_t groupIndex, const BindGroup& _bindGroup,
+                                         const std::vector<uint32_t>& dynamicOffsets )
 {
     if ( currentPipelineState )
     {
         auto bindGroupLayout = currentPipelineState->getWGPUBindGroupLayout( groupIndex );
         auto bindGroup       = _bindGroup.getWGPUBindGroup( bindGroupLayout );
-        wgpuComputePassEncoderSetBindGroup( passEncoder, groupIndex, bindGroup, 0, nullptr );
+        wgpuComputePassEncoderSetBindGroup( passEncoder, groupIndex, bindGroup, dynamicOffsets.size(),
+                                            dynamicOffsets.data() );
     }
     else
     {
@@ -53,6 +117,15 @@ WGPUCommandBuffer ComputeCommandBuffer::finish()
 {
     wgpuComputePassEncoderEnd( passEncoder );
 
+    for ( auto& copy: pendingCopies )
+        wgpuCommandEncoderCopyBufferToTexture( commandEncoder, &copy.source, &copy.destination, &copy.size );
+
+    for ( auto& copy: pendingTextureCopies )
+        wgpuCommandEncoderCopyTextureToTexture( commandEncoder, &copy.source, &copy.destination, &copy.size );
+
+    pendingCopies.clear();
+    pendingTextureCopies.clear();
+
     currentPipelineState = nullptr;
  
     WGPUCommandBufferDescriptor commandBufferDesc {};
@@ -1,9 +1,16 @@
+#include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/ComputePipelineState.hpp>
 
 using namespace WebGPUlib;
 
-ComputePipelineState::~ComputePipelineState()
+// The pipeline is owned by the device.
+ComputePipelineState::~ComputePipelineState() = default;
+
+bool ComputePipelineState::isReady()
 {
-    if ( pipeline )
-        wgpuComputePipelineRelease( pipeline );
+    // Look up the pipeline that is created in the background until it is ready.
+    if ( !pipeline && !pipelineKey.empty() )
+        pipeline = Device::get().findComputePipeline( pipelineKey );
+
+    return pipeline != nullptr;
 }
\ No newline at end of file
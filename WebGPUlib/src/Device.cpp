@@ -1,17 +1,34 @@
+#include <WebGPUlib/AssetArchive.hpp>
 #include <WebGPUlib/BindGroup.hpp>
 #include <WebGPUlib/ComputeCommandBuffer.hpp>
 #include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/FileReader.hpp>
+#include <WebGPUlib/GenerateMipsBlitPipelineState.hpp>
 #include <WebGPUlib/GenerateMipsPipelineState.hpp>
+#include <WebGPUlib/GenerateMipsSinglePassPipelineState.hpp>
+#include <WebGPUlib/GeometryStreamer.hpp>
+#include <WebGPUlib/Hash.hpp>
+#include <WebGPUlib/GraphicsCommandBuffer.hpp>
+#include <WebGPUlib/Helpers.hpp>
 #include <WebGPUlib/IndexBuffer.hpp>
 #include <WebGPUlib/Material.hpp>
+#include <WebGPUlib/MaterialTable.hpp>
 #include <WebGPUlib/Mesh.hpp>
+#include <WebGPUlib/Meshlet.hpp>
+#include <WebGPUlib/MeshSimplifier.hpp>
+#include <WebGPUlib/PipelineCache.hpp>
 #include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/RenderTarget.hpp>
 #include <WebGPUlib/Sampler.hpp>
 #include <WebGPUlib/Scene.hpp>
 #include <WebGPUlib/SceneNode.hpp>
+#include <WebGPUlib/ShaderReflection.hpp>
 #include <WebGPUlib/StorageBuffer.hpp>
 #include <WebGPUlib/Surface.hpp>
 #include <WebGPUlib/Texture.hpp>
+#include <WebGPUlib/TextureData.hpp>
+#include <WebGPUlib/TextureStreamer.hpp>
+#include <WebGPUlib/ThreadPool.hpp>
 #include <WebGPUlib/UniformBuffer.hpp>
 #include <WebGPUlib/Vertex.hpp>
 #include <WebGPUlib/VertexBuffer.hpp>
@@ -22,22 +39,41 @@
 #ifdef WEBGPU_BACKEND_WGPU
     #include <webgpu/wgpu.h>  // Include non-standard functions.
 #endif
+#ifdef WEBGPU_BACKEND_DAWN
+void wgpuBufferReference( WGPUBuffer buffer )
+{
+    wgpuBufferAddRef( buffer );
+}
+#endif
 
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/Exporter.hpp>
+#include <assimp/IOStream.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/mesh.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 #include <glm/trigonometric.hpp>
 #include <glm/vec3.hpp>
 
 #include <sdl2webgpu.h>
 #include <stb_image.h>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
 
 constexpr float _PI     = 3.141592654f;
 constexpr float _2PI    = 6.283185307f;
@@ -67,6 +103,19 @@ int bitScanForward( uint64_t bb )
     return index64[( ( bb ^ ( bb - 1 ) ) * debruijn64 ) >> 58];
 }
 
+// Get the linear format of an sRGB format whose mips can be generated in a linear intermediate texture.
+// Other formats are returned unchanged.
+static WGPUTextureFormat getLinearFormat( WGPUTextureFormat format )
+{
+    switch ( format )
+    {
+    case WGPUTextureFormat_RGBA8UnormSrgb:
+        return WGPUTextureFormat_RGBA8Unorm;
+    default:
+        return format;
+    }
+}
+
 template<typename T>
 constexpr T DivideByMultiple( T value, size_t alignment )
 {
@@ -91,15 +140,15 @@ struct MakeSurface : Surface
 
 struct MakeVertexBuffer : VertexBuffer
 {
-    MakeVertexBuffer( WGPUBuffer&& buffer, std::size_t vertexCount, std::size_t vertexStride )
-    : VertexBuffer( std::move( buffer ), vertexCount, vertexStride )  // NOLINT(performance-move-const-arg)
+    MakeVertexBuffer( WGPUBuffer&& buffer, std::size_t vertexCount, std::size_t vertexStride, std::size_t offset = 0 )
+    : VertexBuffer( std::move( buffer ), vertexCount, vertexStride, offset )  // NOLINT(performance-move-const-arg)
     {}
 };
 
 struct MakeIndexBuffer : IndexBuffer
 {
-    MakeIndexBuffer( WGPUBuffer&& buffer, std::size_t indexCount, std::size_t indexStride )
-    : IndexBuffer( std::move( buffer ), indexCount, indexStride )  // NOLINT(performance-move-const-arg)
+    MakeIndexBuffer( WGPUBuffer&& buffer, std::size_t indexCount, std::size_t indexStride, std::size_t offset = 0 )
+    : IndexBuffer( std::move( buffer ), indexCount, indexStride, offset )  // NOLINT(performance-move-const-arg)
     {}
 };
 
@@ -131,10 +180,10 @@ struct MakeTexture : Texture
     {}
 };
 
-void Device::create( SDL_Window* window )
+void Device::create( SDL_Window* window, const DeviceOptions& options )
 {
     assert( !pDevice );
-    pDevice = std::unique_ptr<Device>( new Device( window ) );
+    pDevice = std::unique_ptr<Device>( new Device( window, options ) );
 }
 
 void Device::destroy()
@@ -148,7 +197,7 @@ Device& Device::get()
     return *pDevice;
 }
 
-Device::Device( SDL_Window* window )
+Device::Device( SDL_Window* window, const DeviceOptions& options )
 {
 #ifdef WEBGPU_BACKEND_EMSCRIPTEN
     // For some reason, the instance descriptor must be null when using emscripten.
@@ -220,16 +269,69 @@ Device::Device( SDL_Window* window )
     assert( adapterData.done );
     adapter = adapterData.adapter;
 
-    // Create a minimal device with no special features and default limits.
+    // Enable optional features if they are supported by the adapter.
+    std::vector<WGPUFeatureName> requiredFeatures;
+    if ( wgpuAdapterHasFeature( adapter, WGPUFeatureName_TextureCompressionBC ) )
+        requiredFeatures.push_back( WGPUFeatureName_TextureCompressionBC );
+
+    // Create a device with default limits.
     WGPUDeviceDescriptor deviceDescriptor {};
     deviceDescriptor.label                    = "WebGPUlib";  // You can use anything here.
-    deviceDescriptor.requiredFeatureCount     = 0;            // We don't require any extra features.
-    deviceDescriptor.requiredFeatures         = nullptr;
+    deviceDescriptor.requiredFeatureCount     = requiredFeatures.size();
+    deviceDescriptor.requiredFeatures         = requiredFeatures.data();
     deviceDescriptor.requiredLimits           = nullptr;  // We don't require any specific limits.
     deviceDescriptor.defaultQueue.nextInChain = nullptr;
     deviceDescriptor.defaultQueue.label       = "Queue";  // You can use anything here.
     deviceDescriptor.deviceLostCallback       = onDeviceLostCallback;
 
+#ifdef WEBGPU_BACKEND_DAWN
+    // The device descriptor points to the cache descriptor (and the cache descriptor to the isolation key),
+    // so they must stay alive until the device is requested.
+    std::string                   isolationKey;
+    WGPUDawnCacheDeviceDescriptor cacheDescriptor {};
+#endif
+
+    if ( !options.pipelineCachePath.empty() )
+    {
+#ifdef WEBGPU_BACKEND_DAWN
+        // The cached blobs are only valid for the adapter (and driver) they were compiled for.
+        WGPUAdapterProperties adapterProperties {};
+        wgpuAdapterGetProperties( adapter, &adapterProperties );
+
+        const auto toString = []( const char* str ) { return str ? std::string { str } : std::string {}; };
+
+        isolationKey =
+            toString( adapterProperties.vendorName ) + "|" + toString( adapterProperties.architecture ) + "|" +
+            toString( adapterProperties.name ) + "|" + toString( adapterProperties.driverDescription ) + "|" +
+            std::to_string( adapterProperties.vendorID ) + "|" + std::to_string( adapterProperties.deviceID ) + "|" +
+            std::to_string( adapterProperties.backendType );
+
+        wgpuAdapterPropertiesFreeMembers( adapterProperties );
+
+        pipelineCache = std::make_unique<PipelineCache>( options.pipelineCachePath, isolationKey );
+
+        cacheDescriptor.chain.next        = nullptr;
+        cacheDescriptor.chain.sType       = WGPUSType_DawnCacheDeviceDescriptor;
+        cacheDescriptor.isolationKey      = isolationKey.c_str();
+        cacheDescriptor.loadDataFunction  = []( const void* key, size_t keySize, void* value, size_t valueSize,
+                                               void* userdata ) -> size_t {
+            return static_cast<PipelineCache*>( userdata )->load( key, keySize, value, valueSize );
+        };
+        cacheDescriptor.storeDataFunction = []( const void* key, size_t keySize, const void* value, size_t valueSize,
+                                                void* userdata ) {
+            static_cast<PipelineCache*>( userdata )->store( key, keySize, value, valueSize );
+        };
+        cacheDescriptor.functionUserdata  = pipelineCache.get();
+
+        deviceDescriptor.nextInChain = &cacheDescriptor.chain;
+
+        std::cout << "INFO: Pipeline cache: " << pipelineCache->getDirectory()
+                  << ( pipelineCache->isWarm() ? " (warm)" : " (cold)" ) << std::endl;
+#else
+        std::cout << "INFO: The pipeline cache is not supported by this backend." << std::endl;
+#endif
+    }
+
     struct DeviceData
     {
         WGPUDevice device = nullptr;
@@ -320,6 +422,12 @@ Device::Device( SDL_Window* window )
     }
     queue = std::make_shared<MakeQueue>( std::move( _queue ) );  // NOLINT(performance-move-const-arg)
 
+    // Worker threads for loading and processing assets.
+    threadPool = std::make_unique<ThreadPool>();
+    fileReader = std::make_unique<FileReader>( *threadPool );
+
+    materialTable = std::make_unique<MaterialTable>();
+
     WGPUTextureDescriptor defaultTextureDesc {};
     defaultTextureDesc.label           = "Default White Texture";
     defaultTextureDesc.usage           = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
@@ -340,10 +448,75 @@ Device::Device( SDL_Window* window )
 
     uint32_t magenta = 0xffff00ff;
     queue->writeTexture( *magentaTexture, 0, &magenta, sizeof( magenta ) );
+
+    // The layout of the material bind groups.
+    constexpr uint32_t                    numTextureSlots = static_cast<uint32_t>( TextureSlot::NumTextureSlots );
+    std::vector<WGPUBindGroupLayoutEntry> materialBindGroupLayoutEntries( numTextureSlots + 2 );
+
+    materialBindGroupLayoutEntries[0].binding               = 0;
+    materialBindGroupLayoutEntries[0].visibility            = WGPUShaderStage_Fragment;
+    materialBindGroupLayoutEntries[0].buffer.type             = WGPUBufferBindingType_Uniform;
+    materialBindGroupLayoutEntries[0].buffer.hasDynamicOffset = true;
+    materialBindGroupLayoutEntries[0].buffer.minBindingSize   = sizeof( MaterialProperties );
+
+    for ( uint32_t binding = 1; binding <= numTextureSlots; ++binding )
+    {
+        materialBindGroupLayoutEntries[binding].binding               = binding;
+        materialBindGroupLayoutEntries[binding].visibility            = WGPUShaderStage_Fragment;
+        materialBindGroupLayoutEntries[binding].texture.sampleType    = WGPUTextureSampleType_Float;
+        materialBindGroupLayoutEntries[binding].texture.viewDimension = WGPUTextureViewDimension_2DArray;
+    }
+
+    materialBindGroupLayoutEntries[numTextureSlots + 1].binding      = numTextureSlots + 1;
+    materialBindGroupLayoutEntries[numTextureSlots + 1].visibility   = WGPUShaderStage_Fragment;
+    materialBindGroupLayoutEntries[numTextureSlots + 1].sampler.type = WGPUSamplerBindingType_Filtering;
+
+    // The layout is cached, so pipelines that declare the same bindings in their shaders use the same layout.
+    materialBindGroupLayout = getBindGroupLayout( materialBindGroupLayoutEntries );
+
+    WGPUSamplerDescriptor materialSamplerDesc {};
+    materialSamplerDesc.label         = "Material Sampler";
+    materialSamplerDesc.addressModeU  = WGPUAddressMode_Repeat;
+    materialSamplerDesc.addressModeV  = WGPUAddressMode_Repeat;
+    materialSamplerDesc.addressModeW  = WGPUAddressMode_Repeat;
+    materialSamplerDesc.magFilter     = WGPUFilterMode_Linear;
+    materialSamplerDesc.minFilter     = WGPUFilterMode_Linear;
+    materialSamplerDesc.mipmapFilter  = WGPUMipmapFilterMode_Linear;
+    materialSamplerDesc.lodMinClamp   = 0.0f;
+    materialSamplerDesc.lodMaxClamp   = FLT_MAX;
+    materialSamplerDesc.compare       = WGPUCompareFunction_Undefined;
+    materialSamplerDesc.maxAnisotropy = 8;
+    materialSampler                   = createSampler( materialSamplerDesc );
 }
 
 Device::~Device()
 {
+    // The pipelines that are created in the background must be done before the device is released.
+    waitForPipelines();
+
+    materialTable.reset();
+    materialSampler.reset();
+
+    // The pipeline states (like the mip generation pipelines) don't own their pipelines.
+    for ( auto& [key, pipeline]: renderPipelines )
+        wgpuRenderPipelineRelease( pipeline );
+    renderPipelines.clear();
+    for ( auto& [key, pipeline]: computePipelines )
+        wgpuComputePipelineRelease( pipeline );
+    computePipelines.clear();
+    for ( auto& [code, shaderModule]: shaderModules )
+        wgpuShaderModuleRelease( shaderModule );
+    shaderModules.clear();
+    for ( auto& [layouts, pipelineLayout]: pipelineLayouts )
+        wgpuPipelineLayoutRelease( pipelineLayout );
+    pipelineLayouts.clear();
+    for ( auto& [entries, bindGroupLayout]: bindGroupLayouts )
+        wgpuBindGroupLayoutRelease( bindGroupLayout );
+    bindGroupLayouts.clear();
+    prefetchedFiles.clear();
+    fileReader.reset();
+    threadPool.reset();
+    archives.clear();
     surface.reset();
     queue.reset();
 
@@ -357,6 +530,307 @@ Device::~Device()
         wgpuInstanceRelease( instance );
 }
 
+WGPUBindGroupLayout Device::getBindGroupLayout( const std::vector<WGPUBindGroupLayoutEntry>& entries )
+{
+    auto& bindGroupLayout = bindGroupLayouts[entries];
+    if ( !bindGroupLayout )
+    {
+        WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc {};
+        bindGroupLayoutDesc.entryCount = entries.size();
+        bindGroupLayoutDesc.entries    = entries.data();
+        bindGroupLayout                = wgpuDeviceCreateBindGroupLayout( device, &bindGroupLayoutDesc );
+    }
+
+    return bindGroupLayout;
+}
+
+WGPUPipelineLayout Device::getPipelineLayout( const ShaderReflection&           reflection,
+                                              std::vector<WGPUBindGroupLayout>& _bindGroupLayouts,
+                                              const char*                       label )
+{
+    _bindGroupLayouts.resize( reflection.getNumBindGroups() );
+    for ( uint32_t i = 0; i < reflection.getNumBindGroups(); ++i )
+        _bindGroupLayouts[i] = getBindGroupLayout( reflection.getBindGroupLayoutEntries( i ) );
+
+    auto& pipelineLayout = pipelineLayouts[_bindGroupLayouts];
+    if ( !pipelineLayout )
+    {
+        WGPUPipelineLayoutDescriptor pipelineLayoutDesc {};
+        pipelineLayoutDesc.label                = label;
+        pipelineLayoutDesc.bindGroupLayoutCount = _bindGroupLayouts.size();
+        pipelineLayoutDesc.bindGroupLayouts     = _bindGroupLayouts.data();
+        pipelineLayout                          = wgpuDeviceCreatePipelineLayout( device, &pipelineLayoutDesc );
+    }
+
+    return pipelineLayout;
+}
+
+WGPUShaderModule Device::getShaderModule( const char* shaderCode, const char* label )
+{
+    auto& shaderModule = shaderModules[shaderCode];
+    if ( !shaderModule )
+    {
+        WGPUShaderModuleWGSLDescriptor shaderCodeDesc {};
+        shaderCodeDesc.chain.next  = nullptr;
+        shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+        shaderCodeDesc.code        = shaderCode;
+
+        WGPUShaderModuleDescriptor shaderModuleDesc {};
+        shaderModuleDesc.nextInChain = &shaderCodeDesc.chain;
+        shaderModuleDesc.label       = label;
+        shaderModule                 = wgpuDeviceCreateShaderModule( device, &shaderModuleDesc );
+    }
+
+    return shaderModule;
+}
+
+// Append the bytes of a field of a pipeline descriptor to a pipeline key.
+// Only used for scalars (enums, numbers and handles), so the key doesn't contain padding bytes.
+template<typename T>
+static void appendField( std::string& fields, const T& value )
+{
+    fields.append( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+static void appendString( std::string& fields, const char* string )
+{
+    const std::string_view value { string ? string : "" };
+    appendField( fields, value.size() );
+    fields.append( value );
+}
+
+static void appendStage( std::string& fields, WGPUShaderModule module, const char* entryPoint,
+                         std::size_t constantCount, const WGPUConstantEntry* constants )
+{
+    appendField( fields, module );
+    appendString( fields, entryPoint );
+    appendField( fields, constantCount );
+    for ( std::size_t i = 0; i < constantCount; ++i )
+    {
+        appendString( fields, constants[i].key );
+        appendField( fields, constants[i].value );
+    }
+}
+
+static void appendStencilFace( std::string& fields, const WGPUStencilFaceState& stencilFace )
+{
+    appendField( fields, stencilFace.compare );
+    appendField( fields, stencilFace.failOp );
+    appendField( fields, stencilFace.depthFailOp );
+    appendField( fields, stencilFace.passOp );
+}
+
+static void appendBlendComponent( std::string& fields, const WGPUBlendComponent& blendComponent )
+{
+    appendField( fields, blendComponent.operation );
+    appendField( fields, blendComponent.srcFactor );
+    appendField( fields, blendComponent.dstFactor );
+}
+
+// Get the key of a render pipeline descriptor (see PipelineKey in Hash.hpp).
+static PipelineKey getPipelineKey( const WGPURenderPipelineDescriptor& pipelineDesc )
+{
+    PipelineKey key;
+    auto&       fields = key.fields;
+    appendField( fields, pipelineDesc.layout );
+
+    const auto& vertex = pipelineDesc.vertex;
+    appendStage( fields, vertex.module, vertex.entryPoint, vertex.constantCount, vertex.constants );
+    appendField( fields, vertex.bufferCount );
+    for ( std::size_t i = 0; i < vertex.bufferCount; ++i )
+    {
+        const auto& buffer = vertex.buffers[i];
+        appendField( fields, buffer.arrayStride );
+        appendField( fields, buffer.stepMode );
+        appendField( fields, buffer.attributeCount );
+        for ( std::size_t j = 0; j < buffer.attributeCount; ++j )
+        {
+            appendField( fields, buffer.attributes[j].format );
+            appendField( fields, buffer.attributes[j].offset );
+            appendField( fields, buffer.attributes[j].shaderLocation );
+        }
+    }
+
+    appendField( fields, pipelineDesc.primitive.topology );
+    appendField( fields, pipelineDesc.primitive.stripIndexFormat );
+    appendField( fields, pipelineDesc.primitive.frontFace );
+    appendField( fields, pipelineDesc.primitive.cullMode );
+
+    appendField( fields, pipelineDesc.depthStencil != nullptr );
+    if ( const auto* depthStencil = pipelineDesc.depthStencil )
+    {
+        appendField( fields, depthStencil->format );
+        appendField( fields, depthStencil->depthWriteEnabled );
+        appendField( fields, depthStencil->depthCompare );
+        appendStencilFace( fields, depthStencil->stencilFront );
+        appendStencilFace( fields, depthStencil->stencilBack );
+        appendField( fields, depthStencil->stencilReadMask );
+        appendField( fields, depthStencil->stencilWriteMask );
+        appendField( fields, depthStencil->depthBias );
+        appendField( fields, depthStencil->depthBiasSlopeScale );
+        appendField( fields, depthStencil->depthBiasClamp );
+    }
+
+    appendField( fields, pipelineDesc.multisample.count );
+    appendField( fields, pipelineDesc.multisample.mask );
+    appendField( fields, pipelineDesc.multisample.alphaToCoverageEnabled );
+
+    appendField( fields, pipelineDesc.fragment != nullptr );
+    if ( const auto* fragment = pipelineDesc.fragment )
+    {
+        appendStage( fields, fragment->module, fragment->entryPoint, fragment->constantCount, fragment->constants );
+        appendField( fields, fragment->targetCount );
+        for ( std::size_t i = 0; i < fragment->targetCount; ++i )
+        {
+            const auto& target = fragment->targets[i];
+            appendField( fields, target.format );
+            appendField( fields, target.writeMask );
+            appendField( fields, target.blend != nullptr );
+            if ( target.blend )
+            {
+                appendBlendComponent( fields, target.blend->color );
+                appendBlendComponent( fields, target.blend->alpha );
+            }
+        }
+    }
+
+    key.hash = std::hash<std::string> {}( fields );
+    return key;
+}
+
+// Get the key of a compute pipeline descriptor (see PipelineKey in Hash.hpp).
+static PipelineKey getPipelineKey( const WGPUComputePipelineDescriptor& pipelineDesc )
+{
+    PipelineKey key;
+
+    const auto& compute = pipelineDesc.compute;
+    appendField( key.fields, pipelineDesc.layout );
+    appendStage( key.fields, compute.module, compute.entryPoint, compute.constantCount, compute.constants );
+
+    key.hash = std::hash<std::string> {}( key.fields );
+    return key;
+}
+
+WGPURenderPipeline Device::getRenderPipeline( const WGPURenderPipelineDescriptor& pipelineDesc )
+{
+    // If the pipeline is still being created in the background, it is created again (synchronously).
+    // The pipeline that is created in the background is released when it is done.
+    auto& pipeline = renderPipelines[getPipelineKey( pipelineDesc )];
+    if ( !pipeline )
+        pipeline = wgpuDeviceCreateRenderPipeline( device, &pipelineDesc );
+
+    return pipeline;
+}
+
+WGPUComputePipeline Device::getComputePipeline( const WGPUComputePipelineDescriptor& pipelineDesc )
+{
+    auto& pipeline = computePipelines[getPipelineKey( pipelineDesc )];
+    if ( !pipeline )
+        pipeline = wgpuDeviceCreateComputePipeline( device, &pipelineDesc );
+
+    return pipeline;
+}
+
+PipelineKey Device::getRenderPipelineAsync( const WGPURenderPipelineDescriptor& pipelineDesc )
+{
+    PipelineKey pipelineKey = getPipelineKey( pipelineDesc );
+    if ( findRenderPipeline( pipelineKey ) || pendingRenderPipelines.count( pipelineKey ) )
+        return pipelineKey;
+
+#ifdef WEBGPU_BACKEND_WGPU
+    renderPipelines[pipelineKey] = wgpuDeviceCreateRenderPipeline( device, &pipelineDesc );
+#else
+    pendingRenderPipelines.insert( pipelineKey );
+    wgpuDeviceCreateRenderPipelineAsync( device, &pipelineDesc, onRenderPipelineCreated,
+                                         new PipelineRequest { this, pipelineKey } );
+#endif
+
+    return pipelineKey;
+}
+
+PipelineKey Device::getComputePipelineAsync( const WGPUComputePipelineDescriptor& pipelineDesc )
+{
+    PipelineKey pipelineKey = getPipelineKey( pipelineDesc );
+    if ( findComputePipeline( pipelineKey ) || pendingComputePipelines.count( pipelineKey ) )
+        return pipelineKey;
+
+#ifdef WEBGPU_BACKEND_WGPU
+    computePipelines[pipelineKey] = wgpuDeviceCreateComputePipeline( device, &pipelineDesc );
+#else
+    pendingComputePipelines.insert( pipelineKey );
+    wgpuDeviceCreateComputePipelineAsync( device, &pipelineDesc, onComputePipelineCreated,
+                                          new PipelineRequest { this, pipelineKey } );
+#endif
+
+    return pipelineKey;
+}
+
+WGPURenderPipeline Device::findRenderPipeline( const PipelineKey& pipelineKey ) const
+{
+    auto iter = renderPipelines.find( pipelineKey );
+    return iter != renderPipelines.end() ? iter->second : nullptr;
+}
+
+WGPUComputePipeline Device::findComputePipeline( const PipelineKey& pipelineKey ) const
+{
+    auto iter = computePipelines.find( pipelineKey );
+    return iter != computePipelines.end() ? iter->second : nullptr;
+}
+
+void Device::waitForPipelines()
+{
+    while ( getNumPendingPipelines() > 0 )
+        poll( true );
+}
+
+void Device::onRenderPipelineCreated( WGPUCreatePipelineAsyncStatus status, WGPURenderPipeline pipeline,
+                                      const char* message, void* userdata )
+{
+    const std::unique_ptr<PipelineRequest> request { static_cast<PipelineRequest*>( userdata ) };
+    Device&                                self = *request->device;
+
+    self.pendingRenderPipelines.erase( request->pipelineKey );
+
+    if ( status != WGPUCreatePipelineAsyncStatus_Success )
+    {
+        std::cerr << "ERROR: Failed to create render pipeline: " << ( message ? message : "" ) << std::endl;
+        if ( pipeline )
+            wgpuRenderPipelineRelease( pipeline );
+        return;
+    }
+
+    // The pipeline may have been created synchronously in the meantime (see getRenderPipeline).
+    auto& cachedPipeline = self.renderPipelines[request->pipelineKey];
+    if ( cachedPipeline )
+        wgpuRenderPipelineRelease( pipeline );
+    else
+        cachedPipeline = pipeline;
+}
+
+void Device::onComputePipelineCreated( WGPUCreatePipelineAsyncStatus status, WGPUComputePipeline pipeline,
+                                       const char* message, void* userdata )
+{
+    const std::unique_ptr<PipelineRequest> request { static_cast<PipelineRequest*>( userdata ) };
+    Device&                                self = *request->device;
+
+    self.pendingComputePipelines.erase( request->pipelineKey );
+
+    if ( status != WGPUCreatePipelineAsyncStatus_Success )
+    {
+        std::cerr << "ERROR: Failed to create compute pipeline: " << ( message ? message : "" ) << std::endl;
+        if ( pipeline )
+            wgpuComputePipelineRelease( pipeline );
+        return;
+    }
+
+    // The pipeline may have been created synchronously in the meantime (see getComputePipeline).
+    auto& cachedPipeline = self.computePipelines[request->pipelineKey];
+    if ( cachedPipeline )
+        wgpuComputePipelineRelease( pipeline );
+    else
+        cachedPipeline = pipeline;
+}
+
 std::shared_ptr<Queue> Device::getQueue() const
 {
     return queue;
@@ -367,8 +841,9 @@ std::shared_ptr<Surface> Device::getSurface() const
     return surface;
 }
 
+template<typename IndexType>
 static void reverseWinding( std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
-                            std::vector<uint16_t>&                                    indices )
+                            std::vector<IndexType>&                                   indices )
 {
     assert( ( indices.size() % 3 ) == 0 );
     for ( auto it = indices.begin(); it != indices.end(); it += 3 )
@@ -443,7 +918,7 @@ std::shared_ptr<Mesh> Device::createSphere( float radius, uint32_t tessellation,
         throw std::out_of_range( "tessellation parameter out of range" );
 
     std::vector<VertexPositionNormalTangentBitangentTexture> vertices;
-    std::vector<uint16_t>                                    indices;
+    std::vector<uint32_t>                                    indices;
 
     size_t verticalSegments   = tessellation;
     size_t horizontalSegments = static_cast<size_t>( tessellation ) * 2;
@@ -487,21 +962,22 @@ std::shared_ptr<Mesh> Device::createSphere( float radius, uint32_t tessellation,
             size_t nextI = i + 1;
             size_t nextJ = ( j + 1 ) % stride;
 
-            indices.push_back( i * stride + nextJ );
-            indices.push_back( nextI * stride + j );
-            indices.push_back( i * stride + j );
+            indices.push_back( static_cast<uint32_t>( i * stride + nextJ ) );
+            indices.push_back( static_cast<uint32_t>( nextI * stride + j ) );
+            indices.push_back( static_cast<uint32_t>( i * stride + j ) );
 
-            indices.push_back( nextI * stride + nextJ );
-            indices.push_back( nextI * stride + j );
-            indices.push_back( i * stride + nextJ );
+            indices.push_back( static_cast<uint32_t>( nextI * stride + nextJ ) );
+            indices.push_back( static_cast<uint32_t>( nextI * stride + j ) );
+            indices.push_back( static_cast<uint32_t>( i * stride + nextJ ) );
         }
     }
 
     if ( _reverseWinding )
         reverseWinding( vertices, indices );
 
+    // Use 16-bit indices unless the tessellation is too high.
     auto vertexBuffer = createVertexBuffer( vertices );
-    auto indexBuffer  = createIndexBuffer( indices );
+    auto indexBuffer  = createCompactIndexBuffer( indices, vertices.size() );
 
     return std::make_shared<Mesh>( vertexBuffer, indexBuffer );
 }
@@ -514,257 +990,1482 @@ std::shared_ptr<Texture> Device::createTexture( const WGPUTextureDescriptor& tex
                                           textureDescriptor );
 }
 
-std::shared_ptr<Texture> Device::loadTexture( const std::filesystem::path& _filePath )
+std::shared_ptr<Texture> Device::createTexture( const TextureData& textureData, const char* label )
 {
-    auto filePath = _filePath.string();
-    // Replace double backslashes in the file path.
-    // This is required on POSIX systems (like Emscripten).
-    std::replace( filePath.begin(), filePath.end(), '\\', '/' );
+    assert( !textureData.mips.empty() );
+
+    WGPUTextureDescriptor textureDesc {};
+    textureDesc.label         = label;
+    textureDesc.dimension     = WGPUTextureDimension_2D;
+    textureDesc.format        = textureData.format;
+    textureDesc.size          = { textureData.width, textureData.height, 1u };
+    textureDesc.sampleCount   = 1;
+    textureDesc.mipLevelCount = static_cast<uint32_t>( textureData.mips.size() );
+    textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst | WGPUTextureUsage_CopySrc;
+
+    auto texture = createTexture( textureDesc );
 
-    if ( !std::filesystem::exists( filePath ) || !std::filesystem::is_regular_file( filePath ) )
+    for ( uint32_t mip = 0; mip < textureData.mips.size(); ++mip )
     {
-        std::cerr << "ERROR: File not found or is not a regular file: " << filePath << std::endl;
-        return nullptr;
+        const auto& data = textureData.mips[mip];
+        queue->writeTexture( *texture, mip, data.data(), data.size() );
     }
 
-    // Load the texture
-    int            width, height, channels;
-    unsigned char* data = stbi_load( filePath.c_str(), &width, &height, &channels, STBI_rgb_alpha );
+    return texture;
+}
 
-    if ( !data )
+// Find the mounted archive that contains a file (the archive that was mounted last is searched first).
+// A file in an archive is stale (and ignored) if the file on disk was modified after it was added to the archive.
+static const AssetArchive* findArchive( const std::vector<std::unique_ptr<AssetArchive>>& archives,
+                                        const fs::path&                                   filePath )
+{
+    for ( auto iter = archives.rbegin(); iter != archives.rend(); ++iter )
     {
-        std::cerr << "ERROR: Failed to load texture: " << filePath << std::endl;
-        return nullptr;
+        fs::file_time_type archivedTime;
+        if ( !( *iter )->getModifiedTime( filePath, archivedTime ) )
+            continue;
+
+        std::error_code error;
+        const auto      diskTime = fs::last_write_time( filePath, error );
+        if ( error || diskTime <= archivedTime )
+            return iter->get();
     }
 
-    const WGPUExtent3D textureSize { static_cast<uint32_t>( width ), static_cast<uint32_t>( height ), 1u };
+    return nullptr;
+}
 
-    std::string label = _filePath.filename().string();
+// Get the options that a texture is cooked with (see Device::loadTexture).
+static TextureCookOptions getCookOptions( const TextureLoadOptions& options )
+{
+    TextureCookOptions cookOptions;
+    cookOptions.mipFilter = options.mipFilter;
+    cookOptions.sRGB      = options.sRGB;
+    cookOptions.normalMap = options.normalMap;
 
-    // Create the texture object.
-    WGPUTextureDescriptor textureDesc {};
-    textureDesc.label       = label.c_str();
-    textureDesc.dimension   = WGPUTextureDimension_2D;
-    textureDesc.format      = WGPUTextureFormat_RGBA8Unorm;
-    textureDesc.size        = textureSize;
-    textureDesc.sampleCount = 1;
-    textureDesc.mipLevelCount =
-        static_cast<uint32_t>(
-            std::floor( std::log2( std::max( static_cast<float>( width ), static_cast<float>( height ) ) ) ) ) +
-        1u;
-    textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_StorageBinding | WGPUTextureUsage_CopyDst;
+    return cookOptions;
+}
 
-    WGPUTexture texture = wgpuDeviceCreateTexture( device, &textureDesc );
+// Check if a cooked texture (only the header is needed) was cooked with the load options.
+// Normal maps must be cooked to BC5. Textures that could not be compressed are cooked to RGBA8.
+static bool isCookedTextureValid( const TextureData& textureData, const TextureLoadOptions& options )
+{
+    return textureData.cookKey == getCookKey( getCookOptions( options ) ) &&
+           ( ( options.compress && isBlockCompressed( textureData.format ) &&
+               ( textureData.format == WGPUTextureFormat_BC5RGUnorm ) == options.normalMap ) ||
+             ( options.precomputeMips && !isBlockCompressed( textureData.format ) &&
+               ( textureData.format == WGPUTextureFormat_RGBA8Unorm || options.keepChannelCount ) ) );
+}
 
-    auto tex =
-        std::make_shared<MakeTexture>( std::move( texture ), textureDesc );  // NOLINT(performance-move-const-arg)
+// Get the modification time of a file in a mounted archive or on disk.
+static bool getModifiedTime( const std::vector<std::unique_ptr<AssetArchive>>& archives, const fs::path& filePath,
+                             fs::file_time_type& time )
+{
+    if ( auto archive = findArchive( archives, filePath ) )
+        return archive->getModifiedTime( filePath, time );
 
-    // Copy mip level 0.
-    queue->writeTexture( *tex, 0, data, ( static_cast<std::size_t>( width ) * height * 4u ) );
+    std::error_code error;
+    time = fs::last_write_time( filePath, error );
 
-    stbi_image_free( data );
+    return !error;
+}
 
-    generateMips( *tex );
+bool Device::mountArchive( const std::filesystem::path& archivePath, const std::filesystem::path& rootPath )
+{
+    auto archive = AssetArchive::open( archivePath, rootPath );
+    if ( !archive )
+        return false;
 
-    std::cout << "INFO: Loaded texture: " << filePath << std::endl;
+    archives.push_back( std::move( archive ) );
 
-    return tex;
+    return true;
 }
 
-void Device::generateMips( Texture& texture )
+const uint8_t* Device::getMappedFile( const std::filesystem::path& filePath, std::size_t& size ) const
 {
-    if ( !generateMipsPipelineState )
-        generateMipsPipelineState = std::make_unique<GenerateMipsPipelineState>();
+    auto archive = findArchive( archives, filePath );
 
-    auto desc = texture.getWGPUTextureDescriptor();
+    return archive ? archive->getMappedData( filePath, size ) : nullptr;
+}
 
-    auto commandBuffer = queue->createComputeCommandBuffer();
+void Device::prefetchFile( const std::filesystem::path& filePath )
+{
+    auto key = filePath.string();
+    if ( prefetchedFiles.find( key ) != prefetchedFiles.end() )
+        return;
 
-    commandBuffer->setComputePipeline( *generateMipsPipelineState );
-
-    // Setup a temporary uniform buffer for uploading the mip info.
-    auto uniformBuffer = createUniformBuffer( nullptr, 4096u );  // 4k should be more than enough?
-
-    // Create a dummy texture to pad any unused mips.
-    // Create a placeholder texture to use during mipmap generation.
-    WGPUTextureDescriptor dummyTextureDesc {};
-    dummyTextureDesc.label         = "Mip map placeholder texture";
-    dummyTextureDesc.usage         = WGPUTextureUsage_StorageBinding;
-    dummyTextureDesc.dimension     = WGPUTextureDimension_2D;
-    dummyTextureDesc.size          = { 16, 16, 1 };
-    dummyTextureDesc.format        = WGPUTextureFormat_RGBA8Unorm;
-    dummyTextureDesc.mipLevelCount = 4;
-    dummyTextureDesc.sampleCount   = 1;
-    auto dummyTexture              = createTexture( dummyTextureDesc );
-
-    // Create a sampler
-    WGPUSamplerDescriptor linearClampSamplerDesc {};
-    linearClampSamplerDesc.label         = "Linear Clamp Sampler";
-    linearClampSamplerDesc.addressModeU  = WGPUAddressMode_ClampToEdge;
-    linearClampSamplerDesc.addressModeV  = WGPUAddressMode_ClampToEdge;
-    linearClampSamplerDesc.addressModeW  = WGPUAddressMode_ClampToEdge;
-    linearClampSamplerDesc.magFilter     = WGPUFilterMode_Linear;
-    linearClampSamplerDesc.minFilter     = WGPUFilterMode_Linear;
-    linearClampSamplerDesc.mipmapFilter  = WGPUMipmapFilterMode_Linear;
-    linearClampSamplerDesc.lodMinClamp   = 0.0f;
-    linearClampSamplerDesc.lodMaxClamp   = FLT_MAX;
-    linearClampSamplerDesc.compare       = WGPUCompareFunction_Undefined;
-    linearClampSamplerDesc.maxAnisotropy = 1;
-    auto sampler                         = createSampler( linearClampSamplerDesc );
-
-    // Bind the sampler
-    commandBuffer->bindSampler( 0, 6, *sampler );
-
-    for ( uint32_t srcMip = 0, pass = 0; srcMip < desc.mipLevelCount - 1; ++pass )
-    {
-        uint32_t srcWidth  = desc.size.width >> srcMip;
-        uint32_t srcHeight = desc.size.height >> srcMip;
-        uint32_t dstWidth  = srcWidth >> 1u;
-        uint32_t dstHeight = srcHeight >> 1u;
-
-        Mip mip {};
-        // 0b00(0): Both width and height are even.
-        // 0b01(1): Width is odd, height is even.
-        // 0b10(2): Width is even, height is odd.
-        // 0b11(3): Both width and height are odd.
-        mip.dimensions = ( srcHeight & 1 ) << 1 | ( srcWidth & 1 );
-
-        // The number of times we can half the size of the texture and get
-        // exactly a 50% reduction in size.
-        // A 1 bit in the width or height indicates an odd dimension.
-        // The case where either the width or the height is exactly 1 is handled
-        // as a special case (as the dimension does not require reduction).
-        int mipCount =
-            bitScanForward( ( dstWidth == 1 ? dstHeight : dstWidth ) | ( dstHeight == 1 ? dstWidth : dstHeight ) );
-
-        // Maximum number of mips to generate is 4.
-        mipCount = std::min( mipCount + 1, 4 );
-
-        // Clamp to total number of mips left over.
-        mipCount = ( srcMip + mipCount ) >= desc.mipLevelCount ? static_cast<int>( desc.mipLevelCount - srcMip ) - 1 :
-                                                                 mipCount;
-
-        // Dimensions should not reduce to 0.
-        // This can happen if the width and height are not the same.
-        dstWidth  = std::max( 1u, dstWidth );
-        dstHeight = std::max( 1u, dstHeight );
-
-        mip.srcMipLevel = srcMip;
-        mip.numMips     = mipCount;
-        mip.texelSize   = { 1.0f / static_cast<float>( dstWidth ), 1.0f / static_cast<float>( dstHeight ) };
-
-        // Write the mip info to the buffer.
-        uint32_t bufferOffset = 256 * pass;
-        queue->writeBuffer( *uniformBuffer, &mip, sizeof( Mip ), bufferOffset );
-
-        commandBuffer->bindBuffer( 0, 0, *uniformBuffer, bufferOffset, sizeof( Mip ) );
+    prefetchedFiles.emplace( std::move( key ), readFileAsync( filePath ) );
+}
 
-        // Setup a texture view for the source texture.
-        WGPUTextureViewDescriptor srcTextureViewDesc {};
-        srcTextureViewDesc.label           = "Generate Mip Source Texture";
-        srcTextureViewDesc.format          = desc.format;
-        srcTextureViewDesc.dimension       = WGPUTextureViewDimension_2D;
-        srcTextureViewDesc.baseMipLevel    = srcMip;
-        srcTextureViewDesc.mipLevelCount   = 1;
-        srcTextureViewDesc.baseArrayLayer  = 0;
-        srcTextureViewDesc.arrayLayerCount = 1;
-        srcTextureViewDesc.aspect          = WGPUTextureAspect_All;
-        auto srcTextureView                = texture.getView( &srcTextureViewDesc );
+std::future<std::vector<uint8_t>> Device::readFileAsync( const std::filesystem::path& filePath ) const
+{
+    if ( auto archive = findArchive( archives, filePath ) )
+        return threadPool->submit( [archive, filePath] { return archive->read( filePath ); } );
 
-        commandBuffer->bindTexture( 0, 1, *srcTextureView );
+    return fileReader->read( filePath );
+}
 
-        uint32_t dstMip = 0;
-        for ( ; dstMip < mipCount; ++dstMip )
-        {
-            WGPUTextureViewDescriptor dstMipViewDesc {};
-            dstMipViewDesc.label           = "Generate Mip Destination Texture";
-            dstMipViewDesc.format          = desc.format;
-            dstMipViewDesc.dimension       = WGPUTextureViewDimension_2D;
-            dstMipViewDesc.baseMipLevel    = srcMip + dstMip + 1;
-            dstMipViewDesc.mipLevelCount   = 1;
-            dstMipViewDesc.baseArrayLayer  = 0;
-            dstMipViewDesc.arrayLayerCount = 1;
-            dstMipViewDesc.aspect          = WGPUTextureAspect_All;
-            auto dstMipView                = texture.getView( &dstMipViewDesc );
-
-            commandBuffer->bindTexture( 0, 2 + dstMip, *dstMipView );
-        }
+std::vector<uint8_t> Device::readFile( const std::filesystem::path& filePath )
+{
+    auto iter = prefetchedFiles.find( filePath.string() );
+    if ( iter == prefetchedFiles.end() )
+    {
+        if ( auto archive = findArchive( archives, filePath ) )
+            return archive->read( filePath );
 
-        // Pad any unused mips with a dummy texture view.
-        for ( ; dstMip < 4; ++dstMip )
-        {
-            WGPUTextureViewDescriptor dstMipViewDesc {};
-            dstMipViewDesc.label           = "Generate Mip Dummy Texture";
-            dstMipViewDesc.format          = desc.format;
-            dstMipViewDesc.dimension       = WGPUTextureViewDimension_2D;
-            dstMipViewDesc.baseMipLevel    = dstMip;
-            dstMipViewDesc.mipLevelCount   = 1;
-            dstMipViewDesc.baseArrayLayer  = 0;
-            dstMipViewDesc.arrayLayerCount = 1;
-            dstMipViewDesc.aspect          = WGPUTextureAspect_All;
-            auto dstMipView                = dummyTexture->getView( &dstMipViewDesc );
-
-            commandBuffer->bindTexture( 0, 2 + dstMip, *dstMipView );
-        }
+        return fileReader->read( filePath ).get();
+    }
 
-        commandBuffer->dispatch( DivideByMultiple( dstWidth, 8 ), DivideByMultiple( dstHeight, 8 ) );
+    auto data = iter->second.get();
+    prefetchedFiles.erase( iter );
 
-        srcMip += mipCount;
-    }
+    return data;
+}
 
-    queue->submit( *commandBuffer );
+bool Device::fileExists( const std::filesystem::path& filePath ) const
+{
+    return findArchive( archives, filePath ) || ( fs::exists( filePath ) && fs::is_regular_file( filePath ) );
 }
 
-std::shared_ptr<SceneNode> importSceneNode( const aiNode* aiNode, std::shared_ptr<SceneNode> parent,
-                                            const std::vector<std::shared_ptr<Mesh>>& meshes )
+bool Device::isUpToDate( const std::filesystem::path& cachePath, const std::filesystem::path& sourcePath ) const
 {
-    if ( !aiNode )
+    // The archives store the modification time of their files, so archived files are compared like files on disk.
+    fs::file_time_type cacheTime, sourceTime;
+
+    return getModifiedTime( archives, cachePath, cacheTime ) && getModifiedTime( archives, sourcePath, sourceTime ) &&
+           cacheTime >= sourceTime;
+}
+
+std::shared_ptr<Texture> Device::loadTexture( const std::filesystem::path& _filePath,
+                                              const TextureLoadOptions&    options )
+{
+    auto filePath = _filePath.string();
+    // Replace double backslashes in the file path.
+    // This is required on POSIX systems (like Emscripten).
+    std::replace( filePath.begin(), filePath.end(), '\\', '/' );
+
+    if ( !fileExists( filePath ) )
     {
+        std::cerr << "ERROR: File not found or is not a regular file: " << filePath << std::endl;
         return nullptr;
     }
 
-    glm::mat4 transform {
-        aiNode->mTransformation.a1, aiNode->mTransformation.a2, aiNode->mTransformation.a3, aiNode->mTransformation.a4,
-        aiNode->mTransformation.b1, aiNode->mTransformation.b2, aiNode->mTransformation.b3, aiNode->mTransformation.b4,
-        aiNode->mTransformation.c1, aiNode->mTransformation.c2, aiNode->mTransformation.c3, aiNode->mTransformation.c4,
-        aiNode->mTransformation.d1, aiNode->mTransformation.d2, aiNode->mTransformation.d3, aiNode->mTransformation.d4,
-    };
+    std::string label = _filePath.filename().string();
 
-    auto node = std::make_shared<SceneNode>( transform );
-    node->setParent( parent );
+    // Upload a block compressed texture. If the device does not support block compressed
+    // textures, the texture is transcoded to RGBA8 on the worker threads.
+    auto createCompressedTexture = [&]( TextureData& textureData ) {
+        if ( isBlockCompressed( textureData.format ) && !hasFeature( WGPUFeatureName_TextureCompressionBC ) )
+        {
+            textureData = decompressTexture( textureData, threadPool.get() );
+        }
 
-    for ( unsigned int i = 0; i < aiNode->mNumMeshes; ++i )
-    {
-        node->addMesh( meshes[aiNode->mMeshes[i]] );
-    }
+        return createTexture( textureData, label.c_str() );
+    };
 
-    // Import children.
-    for ( unsigned int i = 0; i < aiNode->mNumChildren; ++i )
+    // DDS files are uploaded as-is.
+    if ( fs::path( filePath ).extension() == ".dds" )
     {
-        auto child = importSceneNode( aiNode->mChildren[i], node, meshes );
-        node->addChild( child );
-    }
+        TextureData textureData;
+        auto        fileData = readFile( filePath );
+        if ( !loadDDS( fileData.data(), fileData.size(), filePath, textureData ) )
+            return nullptr;
 
-    return node;
-}
+        std::cout << "INFO: Loaded texture: " << filePath << std::endl;
 
-std::shared_ptr<Scene> Device::loadScene( const std::filesystem::path& filePath )
-{
-    fs::path parentPath = filePath.parent_path();
+        return createCompressedTexture( textureData );
+    }
 
-    fs::path exportPath = filePath;
-    exportPath.replace_extension( "assbin" );
+    // The cooked texture is used on every device, so it does not depend on the features of the device.
+    const bool cook = options.compress || options.precomputeMips;
 
-    Assimp::Importer importer;
-    const aiScene*   scene = nullptr;
+    fs::path cachePath = filePath;
+    cachePath.replace_extension( "dds" );
 
-    if ( exists( exportPath ) && is_regular_file( exportPath ) )
+    const TextureCookOptions cookOptions = getCookOptions( options );
+
+    // Check if the texture was cooked before (with the same options).
+    if ( cook && isUpToDate( cachePath, filePath ) )
     {
-        scene = importer.ReadFile( exportPath.string(), aiProcess_GenBoundingBoxes );
+        TextureData textureData;
+        auto        fileData = readFile( cachePath );
+        if ( loadDDS( fileData.data(), fileData.size(), cachePath.string(), textureData ) &&
+             isCookedTextureValid( textureData, options ) )
+        {
+            std::cout << "INFO: Loaded texture: " << cachePath.string() << std::endl;
+
+            return createCompressedTexture( textureData );
+        }
     }
-    else
-    {
+
+    // Load the texture
+    auto           fileData = readFile( filePath );
+    int            width, height, channels;
+    unsigned char* data = stbi_load_from_memory( fileData.data(), static_cast<int>( fileData.size() ), &width, &height,
+                                                 &channels, STBI_rgb_alpha );
+
+    if ( !data )
+    {
+        std::cerr << "ERROR: Failed to load texture: " << filePath << std::endl;
+        return nullptr;
+    }
+
+    // stb_image expands the image to 4 channels. Grayscale images are packed back to 1 or 2 channels.
+    const bool              keepChannels  = options.keepChannelCount && !options.normalMap;
+    const uint32_t          numChannels   = keepChannels ? static_cast<uint32_t>( channels ) : 4u;
+    const WGPUTextureFormat format        = getChannelFormat( numChannels );
+    const bool              packed        = format != WGPUTextureFormat_RGBA8Unorm;
+    const uint32_t          bytesPerPixel = packed ? numChannels : 4u;
+
+    // The size of block compressed textures must be a multiple of the block size (4x4).
+    if ( options.compress && ( width % 4 ) == 0 && ( height % 4 ) == 0 )
+    {
+        TextureData textureData =
+            compressTexture( data, static_cast<uint32_t>( width ), static_cast<uint32_t>( height ), cookOptions );
+
+        stbi_image_free( data );
+
+        // Cache the compressed texture for faster loading next time.
+        textureData.cookKey = getCookKey( cookOptions );
+        saveDDS( cachePath, textureData );
+
+        std::cout << "INFO: Loaded texture: " << filePath << std::endl;
+
+        return createCompressedTexture( textureData );
+    }
+
+    if ( options.precomputeMips )
+    {
+        TextureData textureData;
+        textureData.format = format;
+        textureData.width  = static_cast<uint32_t>( width );
+        textureData.height = static_cast<uint32_t>( height );
+        textureData.mips   = generateMips( data, textureData.width, textureData.height, cookOptions );
+
+        stbi_image_free( data );
+
+        if ( packed )
+        {
+            for ( uint32_t mip = 0; mip < textureData.mips.size(); ++mip )
+            {
+                textureData.mips[mip] = packChannels( textureData.mips[mip].data(),
+                                                      std::max( textureData.width >> mip, 1u ),
+                                                      std::max( textureData.height >> mip, 1u ), numChannels );
+            }
+        }
+
+        // Cache the texture and its mips for faster loading next time.
+        textureData.cookKey = getCookKey( cookOptions );
+        saveDDS( cachePath, textureData );
+
+        std::cout << "INFO: Loaded texture: " << filePath << std::endl;
+
+        return createTexture( textureData, label.c_str() );
+    }
+
+    const WGPUExtent3D textureSize { static_cast<uint32_t>( width ), static_cast<uint32_t>( height ), 1u };
+
+    // Create the texture object.
+    WGPUTextureDescriptor textureDesc {};
+    textureDesc.label       = label.c_str();
+    textureDesc.dimension   = WGPUTextureDimension_2D;
+    textureDesc.format      = format;
+    textureDesc.size        = textureSize;
+    textureDesc.sampleCount = 1;
+    textureDesc.mipLevelCount =
+        static_cast<uint32_t>(
+            std::floor( std::log2( std::max( static_cast<float>( width ), static_cast<float>( height ) ) ) ) ) +
+        1u;
+    textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst | WGPUTextureUsage_CopySrc;
+
+    // R8Unorm and RG8Unorm cannot be used as storage textures. Their mips are generated with render passes.
+    if ( packed )
+        textureDesc.usage |= WGPUTextureUsage_RenderAttachment;
+    else
+        textureDesc.usage |= WGPUTextureUsage_StorageBinding;
+
+    auto tex = createTexture( textureDesc );
+
+    // Copy mip level 0.
+    const std::size_t mipSize = static_cast<std::size_t>( width ) * height * bytesPerPixel;
+    if ( packed )
+    {
+        auto pixels = packChannels( data, textureSize.width, textureSize.height, numChannels );
+        queue->writeTexture( *tex, 0, pixels.data(), mipSize );
+    }
+    else
+    {
+        queue->writeTexture( *tex, 0, data, mipSize );
+    }
+
+    stbi_image_free( data );
+
+    if ( options.deferMips )
+        enqueueGenerateMips( tex );
+    else
+        generateMips( *tex );
+
+    std::cout << "INFO: Loaded texture: " << filePath << std::endl;
+
+    return tex;
+}
+
+std::shared_ptr<Texture> Device::loadPackedTexture( const std::array<std::filesystem::path, 4>& _filePaths,
+                                                    const TextureLoadOptions&                    options )
+{
+    std::array<std::string, 4> filePaths;
+    std::string                label = "Packed";
+    std::size_t                hash  = 0;
+    fs::path                   cachePath;
+
+    for ( uint32_t c = 0; c < 4; ++c )
+    {
+        if ( _filePaths[c].empty() )
+            continue;
+
+        auto& filePath = filePaths[c];
+        filePath       = _filePaths[c].string();
+        std::replace( filePath.begin(), filePath.end(), '\\', '/' );
+
+        if ( !fileExists( filePath ) )
+        {
+            std::cerr << "ERROR: File not found or is not a regular file: " << filePath << std::endl;
+            return nullptr;
+        }
+
+        label += " " + _filePaths[c].filename().string();
+        std::hash_combine( hash, c );
+        std::hash_combine( hash, filePath );
+
+        if ( cachePath.empty() )
+            cachePath = fs::path( filePath ).parent_path();
+    }
+
+    // The cached texture is named after the hash of the source paths (and their channels)
+    // and the filter that is used to generate its mips.
+    std::hash_combine( hash, options.mipFilter );
+
+    char hashString[17];
+    std::snprintf( hashString, sizeof( hashString ), "%016llx", static_cast<unsigned long long>( hash ) );
+    cachePath /= std::string( "Packed_" ) + hashString + ".dds";
+
+    // The channels store unrelated linear values.
+    TextureCookOptions cookOptions;
+    cookOptions.mipFilter      = options.mipFilter;
+    cookOptions.packedChannels = true;
+
+    if ( options.precomputeMips && fileExists( cachePath ) )
+    {
+        // The cache is valid if it is newer than all of the source images.
+        bool upToDate = true;
+        for ( const auto& filePath: filePaths )
+        {
+            if ( !filePath.empty() && !isUpToDate( cachePath, filePath ) )
+                upToDate = false;
+        }
+
+        TextureData          textureData;
+        std::vector<uint8_t> fileData;
+        if ( upToDate )
+            fileData = readFile( cachePath );
+
+        if ( upToDate && loadDDS( fileData.data(), fileData.size(), cachePath.string(), textureData ) &&
+             textureData.format == WGPUTextureFormat_RGBA8Unorm && textureData.cookKey == getCookKey( cookOptions ) )
+        {
+            std::cout << "INFO: Loaded texture: " << cachePath.string() << std::endl;
+
+            return createTexture( textureData, label.c_str() );
+        }
+    }
+
+    // Load the images. Only grayscale images can be packed.
+    std::array<unsigned char*, 4> data {};
+    std::array<ImageRGBA8, 4>     images {};
+    uint32_t                      width  = 0;
+    uint32_t                      height = 0;
+    bool                          valid  = true;
+
+    for ( uint32_t c = 0; c < 4 && valid; ++c )
+    {
+        if ( filePaths[c].empty() )
+            continue;
+
+        auto fileData = readFile( filePaths[c] );
+        int  w, h, channels;
+        data[c] = stbi_load_from_memory( fileData.data(), static_cast<int>( fileData.size() ), &w, &h, &channels,
+                                         STBI_rgb_alpha );
+
+        if ( !data[c] )
+        {
+            std::cerr << "ERROR: Failed to load texture: " << filePaths[c] << std::endl;
+            valid = false;
+            break;
+        }
+
+        images[c] = { data[c], static_cast<uint32_t>( w ), static_cast<uint32_t>( h ) };
+        valid     = channels <= 2 || isGrayscale( images[c].pixels, images[c].width, images[c].height );
+
+        // The packed texture has the size of the largest image.
+        width  = std::max( width, images[c].width );
+        height = std::max( height, images[c].height );
+    }
+
+    std::vector<uint8_t> pixels;
+    if ( valid )
+        pixels = packTextureChannels( images, width, height );
+
+    for ( auto d: data )
+    {
+        if ( d )
+            stbi_image_free( d );
+    }
+
+    if ( !valid )
+        return nullptr;
+
+    if ( options.precomputeMips )
+    {
+        TextureData textureData;
+        textureData.format  = WGPUTextureFormat_RGBA8Unorm;
+        textureData.width   = width;
+        textureData.height  = height;
+        textureData.mips    = generateMips( pixels.data(), width, height, cookOptions );
+        textureData.cookKey = getCookKey( cookOptions );
+
+        saveDDS( cachePath, textureData );
+
+        std::cout << "INFO: Loaded texture: " << label << std::endl;
+
+        return createTexture( textureData, label.c_str() );
+    }
+
+    WGPUTextureDescriptor textureDesc {};
+    textureDesc.label       = label.c_str();
+    textureDesc.dimension   = WGPUTextureDimension_2D;
+    textureDesc.format      = WGPUTextureFormat_RGBA8Unorm;
+    textureDesc.size        = { width, height, 1u };
+    textureDesc.sampleCount = 1;
+    textureDesc.mipLevelCount =
+        static_cast<uint32_t>( std::floor( std::log2( static_cast<float>( std::max( width, height ) ) ) ) ) + 1u;
+    textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_StorageBinding | WGPUTextureUsage_CopyDst |
+                        WGPUTextureUsage_CopySrc;
+
+    auto tex = createTexture( textureDesc );
+
+    queue->writeTexture( *tex, 0, pixels.data(), pixels.size() );
+
+    if ( options.deferMips )
+        enqueueGenerateMips( tex );
+    else
+        generateMips( *tex );
+
+    std::cout << "INFO: Loaded texture: " << label << std::endl;
+
+    return tex;
+}
+
+void Device::createTextureArrays( const std::vector<std::shared_ptr<Material>>& materials,
+                                  const TextureStreamer*                        textureStreamer )
+{
+    // WebGPU guarantees at least 256 array layers.
+    constexpr uint32_t maxArrayLayers = 256;
+
+    // Textures with the same size, format and mip count can share a texture array.
+    using TextureArrayKey = std::tuple<uint32_t, uint32_t, WGPUTextureFormat, uint32_t>;
+    std::map<TextureArrayKey, std::vector<std::shared_ptr<Texture>>> groups;
+
+    // The texture array and the layer of each texture that is moved to a texture array.
+    std::unordered_map<const Texture*, std::pair<std::shared_ptr<Texture>, uint32_t>> layers;
+
+    for ( const auto& material: materials )
+    {
+        for ( int i = 0; i < static_cast<int>( TextureSlot::NumTextureSlots ); ++i )
+        {
+            auto texture = material->getTexture( static_cast<TextureSlot>( i ) );
+            if ( !texture || layers.find( texture.get() ) != layers.end() ||
+                 ( textureStreamer && textureStreamer->isStreamed( *texture ) ) )
+                continue;
+
+            // The textures are copied to the texture array.
+            auto desc = texture->getWGPUTextureDescriptor();
+            if ( desc.size.depthOrArrayLayers != 1 || ( desc.usage & WGPUTextureUsage_CopySrc ) == 0 )
+                continue;
+
+            auto& group = groups[{ desc.size.width, desc.size.height, desc.format, desc.mipLevelCount }];
+            layers[texture.get()] = { nullptr, static_cast<uint32_t>( group.size() % maxArrayLayers ) };
+            group.push_back( texture );
+        }
+    }
+
+    auto commandBuffer = queue->createComputeCommandBuffer();
+
+    uint32_t numTextureArrays = 0;
+    uint32_t numTextures      = 0;
+    for ( auto& [key, textures]: groups )
+    {
+        // A single texture does not need a texture array.
+        if ( textures.size() < 2 )
+            continue;
+
+        for ( std::size_t first = 0; first < textures.size(); first += maxArrayLayers )
+        {
+            const auto numLayers =
+                static_cast<uint32_t>( std::min<std::size_t>( textures.size() - first, maxArrayLayers ) );
+
+            WGPUTextureDescriptor textureArrayDesc   = textures[first]->getWGPUTextureDescriptor();
+            textureArrayDesc.label                   = "Material Texture Array";
+            textureArrayDesc.size.depthOrArrayLayers = numLayers;
+            textureArrayDesc.usage                   = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
+            textureArrayDesc.viewFormatCount         = 0;
+            textureArrayDesc.viewFormats             = nullptr;
+
+            auto textureArray = createTexture( textureArrayDesc );
+
+            for ( uint32_t layer = 0; layer < numLayers; ++layer )
+            {
+                const auto& texture = textures[first + layer];
+                for ( uint32_t mip = 0; mip < textureArrayDesc.mipLevelCount; ++mip )
+                    commandBuffer->copyTextureToTexture( *texture, *textureArray, mip, layer );
+
+                layers[texture.get()].first = textureArray;
+            }
+
+            ++numTextureArrays;
+            numTextures += numLayers;
+        }
+    }
+
+    // The source textures are kept alive by the materials until the copies are submitted.
+    queue->submit( *commandBuffer );
+
+    // Replace the textures of the materials with the texture arrays.
+    for ( const auto& material: materials )
+    {
+        for ( int i = 0; i < static_cast<int>( TextureSlot::NumTextureSlots ); ++i )
+        {
+            const auto slot    = static_cast<TextureSlot>( i );
+            auto       texture = material->getTexture( slot );
+            if ( !texture )
+                continue;
+
+            auto iter = layers.find( texture.get() );
+            if ( iter != layers.end() && iter->second.first )
+            {
+                const auto& [textureArray, layer] = iter->second;
+                material->setTexture( slot, textureArray, material->getTextureSwizzle( slot ), layer );
+            }
+        }
+    }
+
+    std::cout << "INFO: Combined " << numTextures << " textures into " << numTextureArrays << " texture arrays."
+              << std::endl;
+}
+
+void Device::generateMips( Texture& texture )
+{
+    generateMips( std::vector<Texture*> { &texture } );
+}
+
+void Device::enqueueGenerateMips( std::shared_ptr<Texture> texture )
+{
+    pendingMips.push_back( std::move( texture ) );
+}
+
+void Device::flushGenerateMips()
+{
+    if ( pendingMips.empty() )
+        return;
+
+    std::vector<Texture*> textures;
+    textures.reserve( pendingMips.size() );
+    for ( auto& texture: pendingMips )
+        textures.push_back( texture.get() );
+
+    generateMips( textures );
+
+    std::cout << "INFO: Generated mips for " << pendingMips.size() << " textures." << std::endl;
+
+    pendingMips.clear();
+}
+
+void Device::generateMips( const std::vector<Texture*>& textures )
+{
+    // Select the generator for each texture based on its format and usage.
+    std::vector<Texture*> singlePassTextures;
+    std::vector<Texture*> multiPassTextures;
+    std::vector<Texture*> blitTextures;
+    for ( auto texture: textures )
+    {
+        auto desc = texture->getWGPUTextureDescriptor();
+        if ( desc.mipLevelCount <= 1 )
+            continue;
+
+        const bool storage = ( desc.usage & WGPUTextureUsage_StorageBinding ) != 0;
+        const bool copyDst = ( desc.usage & WGPUTextureUsage_CopyDst ) != 0;
+
+        // The single pass generator copies mips 5 and up from the mip buffer to the texture,
+        // which requires the WGPUTextureUsage_CopyDst usage flag.
+        if ( mipGenerator == MipGenerator::SinglePass && desc.format == WGPUTextureFormat_RGBA8Unorm && storage &&
+             std::max( desc.size.width, desc.size.height ) <= GenerateMipsSinglePassPipelineState::MaxSize &&
+             ( desc.mipLevelCount <= 5 || copyDst ) )
+            singlePassTextures.push_back( texture );
+        // sRGB textures cannot be written with storage textures. Their mips are generated
+        // in a linear intermediate texture and copied to the texture.
+        else if ( ( GenerateMipsPipelineState::isStorageFormat( desc.format ) && storage ) ||
+                  ( getLinearFormat( desc.format ) != desc.format && copyDst ) )
+            multiPassTextures.push_back( texture );
+        else if ( ( desc.usage & WGPUTextureUsage_RenderAttachment ) != 0 )
+            blitTextures.push_back( texture );
+        else
+            std::cerr << "ERROR (Device::generateMips): The texture format (" << desc.format
+                      << ") does not support storage textures and the texture does not have the "
+                         "WGPUTextureUsage_RenderAttachment usage flag."
+                      << std::endl;
+    }
+
+    if ( !singlePassTextures.empty() )
+        generateMipsSinglePass( singlePassTextures );
+
+    if ( !multiPassTextures.empty() )
+        generateMipsMultiPass( multiPassTextures );
+
+    if ( !blitTextures.empty() )
+        generateMipsBlit( blitTextures );
+}
+
+GenerateMipsPipelineState& Device::getGenerateMipsPipelineState( WGPUTextureFormat format )
+{
+    auto& pipelineState = mipPipelineStates[format];
+    if ( !pipelineState )
+        pipelineState = std::make_unique<GenerateMipsPipelineState>( format );
+
+    return *pipelineState;
+}
+
+GenerateMipsBlitPipelineState& Device::getGenerateMipsBlitPipelineState( WGPUTextureFormat format )
+{
+    auto& pipelineState = mipBlitPipelineStates[format];
+    if ( !pipelineState )
+        pipelineState = std::make_unique<GenerateMipsBlitPipelineState>( format );
+
+    return *pipelineState;
+}
+
+std::shared_ptr<Sampler> Device::getMipSampler()
+{
+    if ( !mipSampler )
+    {
+        WGPUSamplerDescriptor linearClampSamplerDesc {};
+        linearClampSamplerDesc.label         = "Linear Clamp Sampler";
+        linearClampSamplerDesc.addressModeU  = WGPUAddressMode_ClampToEdge;
+        linearClampSamplerDesc.addressModeV  = WGPUAddressMode_ClampToEdge;
+        linearClampSamplerDesc.addressModeW  = WGPUAddressMode_ClampToEdge;
+        linearClampSamplerDesc.magFilter     = WGPUFilterMode_Linear;
+        linearClampSamplerDesc.minFilter     = WGPUFilterMode_Linear;
+        linearClampSamplerDesc.mipmapFilter  = WGPUMipmapFilterMode_Linear;
+        linearClampSamplerDesc.lodMinClamp   = 0.0f;
+        linearClampSamplerDesc.lodMaxClamp   = FLT_MAX;
+        linearClampSamplerDesc.compare       = WGPUCompareFunction_Undefined;
+        linearClampSamplerDesc.maxAnisotropy = 1;
+        mipSampler                           = createSampler( linearClampSamplerDesc );
+    }
+
+    return mipSampler;
+}
+
+std::shared_ptr<TextureView> Device::getMipPlaceholderView( WGPUTextureFormat format, uint32_t mip )
+{
+    auto& mipPlaceholderTexture = mipPlaceholderTextures[format];
+    if ( !mipPlaceholderTexture )
+    {
+        // Create a placeholder texture to pad any unused mips.
+        WGPUTextureDescriptor placeholderTextureDesc {};
+        placeholderTextureDesc.label         = "Mip map placeholder texture";
+        placeholderTextureDesc.usage         = WGPUTextureUsage_StorageBinding;
+        placeholderTextureDesc.dimension     = WGPUTextureDimension_2D;
+        placeholderTextureDesc.size          = { 16, 16, 1 };
+        placeholderTextureDesc.format        = format;
+        placeholderTextureDesc.mipLevelCount = 4;
+        placeholderTextureDesc.sampleCount   = 1;
+        mipPlaceholderTexture                = createTexture( placeholderTextureDesc );
+    }
+
+    WGPUTextureViewDescriptor dstMipViewDesc {};
+    dstMipViewDesc.label           = "Generate Mip Placeholder Texture";
+    dstMipViewDesc.format          = format;
+    dstMipViewDesc.dimension       = WGPUTextureViewDimension_2D;
+    dstMipViewDesc.baseMipLevel    = mip;
+    dstMipViewDesc.mipLevelCount   = 1;
+    dstMipViewDesc.baseArrayLayer  = 0;
+    dstMipViewDesc.arrayLayerCount = 1;
+    dstMipViewDesc.aspect          = WGPUTextureAspect_All;
+
+    return mipPlaceholderTexture->getView( &dstMipViewDesc );
+}
+
+void Device::generateMipsSinglePass( const std::vector<Texture*>& textures )
+{
+    if ( !generateMipsSinglePassPipelineState )
+        generateMipsSinglePassPipelineState = std::make_unique<GenerateMipsSinglePassPipelineState>();
+
+    // Each dispatch uses a 256 byte aligned slot in the parameter buffer.
+    // Every texture has two slots: one for mip 0 and one for mip 6.
+    constexpr std::size_t mipParamsStride = 256;
+
+    // Mips 5 and up of all textures are written to the mip buffer. Each row is aligned
+    // to 256 bytes (64 texels) as required to copy the buffer to the texture.
+    std::vector<SinglePassMipParams> params( textures.size() );
+    std::size_t                      mipBufferSize = 0;  // In texels.
+
+    for ( std::size_t i = 0; i < textures.size(); ++i )
+    {
+        auto desc = textures[i]->getWGPUTextureDescriptor();
+
+        params[i].width   = desc.size.width;
+        params[i].height  = desc.size.height;
+        params[i].numMips = desc.mipLevelCount;
+
+        for ( uint32_t mip = 5; mip < desc.mipLevelCount; ++mip )
+        {
+            params[i].bufferOffsets[mip - 5] = static_cast<uint32_t>( mipBufferSize );
+
+            mipBufferSize += AlignUp( std::max( desc.size.width >> mip, 1u ), 64 ) *
+                             static_cast<std::size_t>( std::max( desc.size.height >> mip, 1u ) );
+        }
+    }
+
+    // Grow the parameter buffer and the mip buffer if required.
+    if ( !singlePassMipParamsBuffer || singlePassMipParamsBuffer->getSize() < textures.size() * 2 * mipParamsStride )
+    {
+        singlePassMipParamsBuffer =
+            createUniformBuffer( nullptr, std::max<std::size_t>( textures.size() * 2, 16 ) * mipParamsStride );
+    }
+
+    if ( !mipBuffer || mipBuffer->getElementCount() < mipBufferSize )
+    {
+        mipBuffer = createStorageBuffer( nullptr, std::max<std::size_t>( mipBufferSize, 64 ), sizeof( uint32_t ),
+                                         WGPUBufferUsage_CopySrc );
+    }
+
+    std::vector<uint8_t> mipParams( textures.size() * 2 * mipParamsStride );
+
+    // Generate the mips of all textures in a single compute pass.
+    auto commandBuffer = queue->createComputeCommandBuffer();
+
+    commandBuffer->setComputePipeline( *generateMipsSinglePassPipelineState );
+
+    commandBuffer->bindBuffer( 0, 6, *mipBuffer );
+
+    for ( std::size_t i = 0; i < textures.size(); ++i )
+    {
+        auto texture = textures[i];
+        auto desc    = texture->getWGPUTextureDescriptor();
+
+        if ( desc.mipLevelCount <= 1 )
+            continue;
+
+        // Store the parameters in the parameter buffer. The buffer is uploaded before the submit.
+        uint32_t bufferOffset = static_cast<uint32_t>( mipParamsStride * 2 * i );
+        std::memcpy( &mipParams[bufferOffset], &params[i], sizeof( SinglePassMipParams ) );
+
+        commandBuffer->bindBuffer( 0, 0, *singlePassMipParamsBuffer, bufferOffset, sizeof( SinglePassMipParams ) );
+
+        // Setup a texture view for the source texture.
+        WGPUTextureViewDescriptor srcTextureViewDesc {};
+        srcTextureViewDesc.label           = "Generate Mip Source Texture";
+        srcTextureViewDesc.format          = desc.format;
+        srcTextureViewDesc.dimension       = WGPUTextureViewDimension_2D;
+        srcTextureViewDesc.baseMipLevel    = 0;
+        srcTextureViewDesc.mipLevelCount   = 1;
+        srcTextureViewDesc.baseArrayLayer  = 0;
+        srcTextureViewDesc.arrayLayerCount = 1;
+        srcTextureViewDesc.aspect          = WGPUTextureAspect_All;
+        auto srcTextureView                = texture->getView( &srcTextureViewDesc );
+
+        commandBuffer->bindTexture( 0, 1, *srcTextureView );
+
+        // Mips 1-4 are written directly to the texture. Unused mips are padded with the placeholder texture.
+        for ( uint32_t dstMip = 1; dstMip <= 4; ++dstMip )
+        {
+            if ( dstMip < desc.mipLevelCount )
+            {
+                WGPUTextureViewDescriptor dstMipViewDesc {};
+                dstMipViewDesc.label           = "Generate Mip Destination Texture";
+                dstMipViewDesc.format          = desc.format;
+                dstMipViewDesc.dimension       = WGPUTextureViewDimension_2D;
+                dstMipViewDesc.baseMipLevel    = dstMip;
+                dstMipViewDesc.mipLevelCount   = 1;
+                dstMipViewDesc.baseArrayLayer  = 0;
+                dstMipViewDesc.arrayLayerCount = 1;
+                dstMipViewDesc.aspect          = WGPUTextureAspect_All;
+                auto dstMipView                = texture->getView( &dstMipViewDesc );
+
+                commandBuffer->bindTexture( 0, 1 + dstMip, *dstMipView );
+            }
+            else
+            {
+                auto placeholderView = getMipPlaceholderView( WGPUTextureFormat_RGBA8Unorm, dstMip - 1 );
+                commandBuffer->bindTexture( 0, 1 + dstMip, *placeholderView );
+            }
+        }
+
+        commandBuffer->dispatch( DivideByMultiple( desc.size.width, 64 ), DivideByMultiple( desc.size.height, 64 ) );
+
+        // Mip 6 is downsampled to the remaining mips by a second dispatch, because the workgroups of a dispatch
+        // cannot wait for the writes of the other workgroups.
+        if ( desc.mipLevelCount > 7 )
+        {
+            params[i].srcLevel = 6;
+            bufferOffset += static_cast<uint32_t>( mipParamsStride );
+            std::memcpy( &mipParams[bufferOffset], &params[i], sizeof( SinglePassMipParams ) );
+
+            commandBuffer->bindBuffer( 0, 0, *singlePassMipParamsBuffer, bufferOffset, sizeof( SinglePassMipParams ) );
+            commandBuffer->dispatch( 1 );
+        }
+
+        // Copy mips 5 and up from the mip buffer to the texture (after the compute pass).
+        for ( uint32_t mip = 5; mip < desc.mipLevelCount; ++mip )
+        {
+            uint32_t bytesPerRow = AlignUp( std::max( desc.size.width >> mip, 1u ), 64 ) * 4u;
+            commandBuffer->copyBufferToTexture( *mipBuffer, params[i].bufferOffsets[mip - 5] * 4ull, bytesPerRow,
+                                                *texture, mip );
+        }
+    }
+
+    // Upload the parameters of all textures at once.
+    queue->writeBuffer( *singlePassMipParamsBuffer, mipParams.data(), mipParams.size() );
+
+    queue->submit( *commandBuffer );
+}
+
+void Device::generateMipsMultiPass( const std::vector<Texture*>& textures )
+{
+    // Each pass uses a 256 byte aligned slot in the parameter buffer.
+    // A texture never needs more passes than it has mips (excluding the first mip).
+    constexpr std::size_t mipParamsStride = 256;
+
+    std::size_t maxPasses = 0;
+    for ( auto texture: textures )
+        maxPasses += texture->getWGPUTextureDescriptor().mipLevelCount - 1;
+
+    if ( maxPasses == 0 )
+        return;
+
+    // Grow the parameter buffer if required.
+    if ( !mipParamsBuffer || mipParamsBuffer->getSize() < maxPasses * mipParamsStride )
+    {
+        mipParamsBuffer = createUniformBuffer( nullptr, std::max<std::size_t>( maxPasses, 16 ) * mipParamsStride );
+    }
+
+    std::vector<uint8_t> mipParams( maxPasses * mipParamsStride );
+    std::size_t          numPasses = 0;
+
+    // The intermediate textures of sRGB textures must stay alive until the command buffer is submitted.
+    std::vector<std::shared_ptr<Texture>> intermediateTextures;
+
+    // Generate the mips of all textures in a single compute pass.
+    auto commandBuffer = queue->createComputeCommandBuffer();
+
+    GenerateMipsPipelineState* currentPipelineState = nullptr;
+
+    for ( auto texture: textures )
+    {
+        auto desc = texture->getWGPUTextureDescriptor();
+
+        // Pipelines are created for each (linear) texture format.
+        const WGPUTextureFormat linearFormat  = getLinearFormat( desc.format );
+        auto&                   pipelineState = getGenerateMipsPipelineState( linearFormat );
+        if ( &pipelineState != currentPipelineState )
+        {
+            commandBuffer->setComputePipeline( pipelineState );
+            commandBuffer->bindSampler( 0, 6, *getMipSampler() );
+            currentPipelineState = &pipelineState;
+        }
+
+        // The mips of sRGB textures are written to a linear intermediate texture.
+        // The shader reads the source mip through an sRGB view (which converts the texels to linear space
+        // before filtering) and converts the result back to sRGB before writing it to the intermediate texture.
+        const bool isSRGB     = linearFormat != desc.format;
+        Texture*   dstTexture = texture;
+        if ( isSRGB )
+        {
+            WGPUTextureDescriptor intermediateDesc {};
+            intermediateDesc.label           = "Generate Mips Intermediate Texture";
+            intermediateDesc.usage           = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_StorageBinding |
+                                               WGPUTextureUsage_CopySrc;
+            intermediateDesc.dimension       = WGPUTextureDimension_2D;
+            intermediateDesc.size            = desc.size;
+            intermediateDesc.format          = linearFormat;
+            intermediateDesc.mipLevelCount   = desc.mipLevelCount;
+            intermediateDesc.sampleCount     = 1;
+            intermediateDesc.viewFormatCount = 1;
+            intermediateDesc.viewFormats     = &desc.format;  // Only used while the texture is created.
+
+            intermediateTextures.push_back( createTexture( intermediateDesc ) );
+            dstTexture = intermediateTextures.back().get();
+        }
+
+        for ( uint32_t srcMip = 0; srcMip < desc.mipLevelCount - 1; ++numPasses )
+        {
+            uint32_t srcWidth  = desc.size.width >> srcMip;
+            uint32_t srcHeight = desc.size.height >> srcMip;
+            uint32_t dstWidth  = srcWidth >> 1u;
+            uint32_t dstHeight = srcHeight >> 1u;
+
+            Mip mip {};
+            // 0b00(0): Both width and height are even.
+            // 0b01(1): Width is odd, height is even.
+            // 0b10(2): Width is even, height is odd.
+            // 0b11(3): Both width and height are odd.
+            mip.dimensions = ( srcHeight & 1 ) << 1 | ( srcWidth & 1 );
+
+            // The number of times we can half the size of the texture and get
+            // exactly a 50% reduction in size.
+            // A 1 bit in the width or height indicates an odd dimension.
+            // The case where either the width or the height is exactly 1 is handled
+            // as a special case (as the dimension does not require reduction).
+            int mipCount =
+                bitScanForward( ( dstWidth == 1 ? dstHeight : dstWidth ) | ( dstHeight == 1 ? dstWidth : dstHeight ) );
+
+            // Maximum number of mips to generate is 4.
+            mipCount = std::min( mipCount + 1, 4 );
+
+            // Clamp to total number of mips left over.
+            mipCount = ( srcMip + mipCount ) >= desc.mipLevelCount ?
+                           static_cast<int>( desc.mipLevelCount - srcMip ) - 1 :
+                           mipCount;
+
+            // Dimensions should not reduce to 0.
+            // This can happen if the width and height are not the same.
+            dstWidth  = std::max( 1u, dstWidth );
+            dstHeight = std::max( 1u, dstHeight );
+
+            mip.srcMipLevel = srcMip;
+            mip.numMips     = mipCount;
+            mip.isSRGB      = isSRGB ? 1u : 0u;
+            mip.texelSize   = { 1.0f / static_cast<float>( dstWidth ), 1.0f / static_cast<float>( dstHeight ) };
+
+            // Store the mip info in the parameter buffer. The buffer is uploaded before the submit.
+            uint32_t bufferOffset = static_cast<uint32_t>( mipParamsStride * numPasses );
+            std::memcpy( &mipParams[bufferOffset], &mip, sizeof( Mip ) );
+
+            commandBuffer->bindBuffer( 0, 0, *mipParamsBuffer, bufferOffset, sizeof( Mip ) );
+
+            // Setup a texture view for the source texture.
+            // Mip 0 of sRGB textures is read from the texture. All other mips are read from the intermediate texture.
+            WGPUTextureViewDescriptor srcTextureViewDesc {};
+            srcTextureViewDesc.label           = "Generate Mip Source Texture";
+            srcTextureViewDesc.format          = desc.format;
+            srcTextureViewDesc.dimension       = WGPUTextureViewDimension_2D;
+            srcTextureViewDesc.baseMipLevel    = srcMip;
+            srcTextureViewDesc.mipLevelCount   = 1;
+            srcTextureViewDesc.baseArrayLayer  = 0;
+            srcTextureViewDesc.arrayLayerCount = 1;
+            srcTextureViewDesc.aspect          = WGPUTextureAspect_All;
+            auto srcTextureView = ( srcMip == 0 ? texture : dstTexture )->getView( &srcTextureViewDesc );
+
+            commandBuffer->bindTexture( 0, 1, *srcTextureView );
+
+            uint32_t dstMip = 0;
+            for ( ; dstMip < mipCount; ++dstMip )
+            {
+                WGPUTextureViewDescriptor dstMipViewDesc {};
+                dstMipViewDesc.label           = "Generate Mip Destination Texture";
+                dstMipViewDesc.format          = linearFormat;
+                dstMipViewDesc.dimension       = WGPUTextureViewDimension_2D;
+                dstMipViewDesc.baseMipLevel    = srcMip + dstMip + 1;
+                dstMipViewDesc.mipLevelCount   = 1;
+                dstMipViewDesc.baseArrayLayer  = 0;
+                dstMipViewDesc.arrayLayerCount = 1;
+                dstMipViewDesc.aspect          = WGPUTextureAspect_All;
+                auto dstMipView                = dstTexture->getView( &dstMipViewDesc );
+
+                commandBuffer->bindTexture( 0, 2 + dstMip, *dstMipView );
+            }
+
+            // Pad any unused mips with the placeholder texture.
+            for ( ; dstMip < 4; ++dstMip )
+                commandBuffer->bindTexture( 0, 2 + dstMip, *getMipPlaceholderView( linearFormat, dstMip ) );
+
+            commandBuffer->dispatch( DivideByMultiple( dstWidth, 8 ), DivideByMultiple( dstHeight, 8 ) );
+
+            srcMip += mipCount;
+        }
+
+        // Copy the mips from the intermediate texture to the sRGB texture (after the compute pass).
+        if ( isSRGB )
+        {
+            for ( uint32_t mip = 1; mip < desc.mipLevelCount; ++mip )
+                commandBuffer->copyTextureToTexture( *dstTexture, *texture, mip );
+        }
+    }
+
+    // Upload the parameters of all passes at once.
+    queue->writeBuffer( *mipParamsBuffer, mipParams.data(), numPasses * mipParamsStride );
+
+    queue->submit( *commandBuffer );
+}
+
+void Device::generateMipsBlit( const std::vector<Texture*>& textures )
+{
+    // Each mip is rendered in a separate render pass. All passes are submitted at once.
+    std::vector<std::shared_ptr<CommandBuffer>> commandBuffers;
+
+    for ( auto texture: textures )
+    {
+        auto desc = texture->getWGPUTextureDescriptor();
+
+        for ( uint32_t mip = 1; mip < desc.mipLevelCount; ++mip )
+        {
+            WGPUTextureViewDescriptor mipViewDesc {};
+            mipViewDesc.label           = "Generate Mip Texture";
+            mipViewDesc.format          = desc.format;
+            mipViewDesc.dimension       = WGPUTextureViewDimension_2D;
+            mipViewDesc.baseMipLevel    = mip - 1;
+            mipViewDesc.mipLevelCount   = 1;
+            mipViewDesc.baseArrayLayer  = 0;
+            mipViewDesc.arrayLayerCount = 1;
+            mipViewDesc.aspect          = WGPUTextureAspect_All;
+            auto srcMipView             = texture->getView( &mipViewDesc );
+
+            mipViewDesc.baseMipLevel = mip;
+            auto dstMipView          = texture->getView( &mipViewDesc );
+
+            RenderTarget renderTarget;
+            renderTarget.attachTexture( AttachmentPoint::Color0, dstMipView );
+
+            auto commandBuffer = queue->createGraphicsCommandBuffer( renderTarget, ClearFlags::None );
+            commandBuffer->setGraphicsPipeline( getGenerateMipsBlitPipelineState( desc.format ) );
+            commandBuffer->bindTexture( 0, 0, *srcMipView );
+            commandBuffer->bindSampler( 0, 1, *getMipSampler() );
+            commandBuffer->draw( 3 );
+
+            commandBuffers.push_back( commandBuffer );
+        }
+    }
+
+    queue->submit( commandBuffers );
+}
+
+// Shares buffers between meshes with byte-identical vertex or index data.
+// The cache doesn't copy the data: it refers to the data of the first mesh that created a buffer,
+// so the data must stay alive (and unchanged) as long as the cache is used.
+template<typename BufferType>
+struct BufferCache
+{
+    template<typename T, typename CreateBuffer>
+    std::shared_ptr<BufferType> getOrCreate( const std::vector<T>& data, CreateBuffer&& createBuffer )
+    {
+        std::string_view bytes { reinterpret_cast<const char*>( data.data() ), data.size() * sizeof( T ) };
+
+        std::size_t hash = std::hash<std::string_view> {}( bytes );
+        std::hash_combine( hash, sizeof( T ) );
+
+        // Compare the data of all buffers with the same hash to rule out hash collisions.
+        auto range = entries.equal_range( hash );
+        for ( auto it = range.first; it != range.second; ++it )
+        {
+            if ( it->second.stride == sizeof( T ) && it->second.data == bytes )
+            {
+                bytesSaved += bytes.size();
+                ++numShared;
+                return it->second.buffer;
+            }
+        }
+
+        std::shared_ptr<BufferType> buffer = createBuffer();
+        entries.emplace( hash, Entry { sizeof( T ), bytes, buffer } );
+
+        return buffer;
+    }
+
+    struct Entry
+    {
+        std::size_t                 stride;
+        std::string_view            data;
+        std::shared_ptr<BufferType> buffer;
+    };
+
+    std::unordered_multimap<std::size_t, Entry> entries;
+    std::size_t                                 bytesSaved = 0;
+    unsigned int                                numShared  = 0;
+};
+
+// A part of a mesh that is uploaded to the GPU as a single Mesh.
+struct SubMesh
+{
+    std::vector<VertexPositionNormalTangentBitangentTexture> vertices;
+    // The indices of all levels of detail (see importMesh).
+    std::vector<uint32_t> indices;
+
+    // The data below is filled in by importMesh.
+    bool                                       compact = false;
+    std::vector<VertexPositionQTangentTexture> compactVertices;
+    std::vector<uint16_t>                      indices16;  // Empty if the mesh needs 32-bit indices.
+    std::vector<MeshLOD>                       lods;
+    std::vector<Meshlet>                       meshlets;
+    std::vector<uint32_t>                      meshletIndices;
+    glm::vec3                                  boundsCenter { 0 };
+    float                                      boundsRadius = 0.0f;
+};
+
+// Split a mesh into submeshes that have at most maxVertices vertices so they
+// can be addressed with 16-bit indices.
+static std::vector<SubMesh> splitMesh( const std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
+                                       const std::vector<uint32_t>& indices, std::size_t maxVertices )
+{
+    assert( ( indices.size() % 3 ) == 0 );
+    assert( maxVertices >= 3 );
+
+    std::vector<SubMesh> subMeshes;
+
+    // Maps vertices in the original mesh to vertices in the current submesh.
+    constexpr uint32_t    invalidIndex = ~0u;
+    std::vector<uint32_t> remap( vertices.size(), invalidIndex );
+    SubMesh               subMesh;
+
+    for ( std::size_t i = 0; i < indices.size(); i += 3 )
+    {
+        // Count the number of new vertices that this triangle adds to the submesh.
+        std::size_t newVertices = 0;
+        for ( std::size_t j = 0; j < 3; ++j )
+        {
+            if ( remap[indices[i + j]] == invalidIndex )
+                ++newVertices;
+        }
+
+        // Start a new submesh if this triangle does not fit.
+        if ( subMesh.vertices.size() + newVertices > maxVertices )
+        {
+            std::fill( remap.begin(), remap.end(), invalidIndex );
+            subMeshes.emplace_back( std::move( subMesh ) );
+            subMesh = {};
+        }
+
+        for ( std::size_t j = 0; j < 3; ++j )
+        {
+            uint32_t& index = remap[indices[i + j]];
+            if ( index == invalidIndex )
+            {
+                index = static_cast<uint32_t>( subMesh.vertices.size() );
+                subMesh.vertices.push_back( vertices[indices[i + j]] );
+            }
+            subMesh.indices.push_back( index );
+        }
+    }
+
+    if ( !subMesh.indices.empty() )
+        subMeshes.emplace_back( std::move( subMesh ) );
+
+    return subMeshes;
+}
+
+// Convert the vertices of an aiMesh in a single pass. Missing attributes are set to zero.
+static std::vector<VertexPositionNormalTangentBitangentTexture> convertVertices( const aiMesh& aiMesh )
+{
+    const bool        hasTangents = aiMesh.HasTangentsAndBitangents();
+    const aiVector3D* positions   = aiMesh.HasPositions() ? aiMesh.mVertices : nullptr;
+    const aiVector3D* normals     = aiMesh.HasNormals() ? aiMesh.mNormals : nullptr;
+    const aiVector3D* tangents    = hasTangents ? aiMesh.mTangents : nullptr;
+    const aiVector3D* bitangents  = hasTangents ? aiMesh.mBitangents : nullptr;
+    const aiVector3D* texCoords   = aiMesh.HasTextureCoords( 0 ) ? aiMesh.mTextureCoords[0] : nullptr;
+
+    auto toVec3 = []( const aiVector3D* v, unsigned int i ) {
+        return v ? glm::vec3 { v[i].x, v[i].y, v[i].z } : glm::vec3 { 0 };
+    };
+
+    std::vector<VertexPositionNormalTangentBitangentTexture> vertices;
+    vertices.reserve( aiMesh.mNumVertices );
+
+    for ( unsigned int v = 0; v < aiMesh.mNumVertices; ++v )
+    {
+        vertices.emplace_back( toVec3( positions, v ), toVec3( normals, v ), toVec3( texCoords, v ),
+                               toVec3( tangents, v ), toVec3( bitangents, v ) );
+    }
+
+    return vertices;
+}
+
+// The submeshes of an aiMesh that are ready to be uploaded to the GPU.
+struct ImportedMesh
+{
+    std::vector<SubMesh> subMeshes;
+    std::size_t          triangleCount    = 0;
+    std::size_t          lodTriangleCount = 0;
+    bool                 split            = false;
+};
+
+// Do the CPU work of importing an aiMesh: convert the vertices, split the mesh, quantize the vertices to
+// the compact layout, and generate the levels of detail, the meshlets and the bounding sphere.
+// Only reads the aiMesh, so the meshes of a scene are imported in parallel.
+static ImportedMesh importMesh( const aiMesh& aiMesh, const SceneImportOptions& options )
+{
+    ImportedMesh importedMesh;
+
+    std::vector<VertexPositionNormalTangentBitangentTexture> vertexData = convertVertices( aiMesh );
+
+    // Extract indices.
+    std::vector<uint32_t> indices;
+    if ( aiMesh.HasFaces() )
+    {
+        indices.reserve( static_cast<std::size_t>( aiMesh.mNumFaces ) * 3 );
+
+        for ( unsigned int f = 0; f < aiMesh.mNumFaces; ++f )
+        {
+            const aiFace& face = aiMesh.mFaces[f];
+
+            // We only care about triangular faces.
+            if ( face.mNumIndices == 3 )
+                indices.insert( indices.end(), face.mIndices, face.mIndices + 3 );
+        }
+    }
+
+    importedMesh.triangleCount = indices.size() / 3;
+
+    // Split large meshes into submeshes that can be addressed with 16-bit indices.
+    if ( options.splitLargeMeshes && vertexData.size() > 65536 && !indices.empty() )
+    {
+        importedMesh.subMeshes = splitMesh( vertexData, indices, 65536 );
+        importedMesh.split     = true;
+    }
+    else
+    {
+        SubMesh subMesh;
+        subMesh.vertices = std::move( vertexData );
+        subMesh.indices  = std::move( indices );
+        importedMesh.subMeshes.push_back( std::move( subMesh ) );
+    }
+
+    for ( auto& subMesh: importedMesh.subMeshes )
+    {
+        const auto& vertices = subMesh.vertices;
+
+        // Use the compact vertex layout if the texture coordinates can be stored with half-precision.
+        subMesh.compact = options.compactVertices &&
+                          std::all_of( vertices.begin(), vertices.end(), []( const auto& vertex ) {
+                              return VertexPositionQTangentTexture::canEncodeTexCoord( vertex.texCoord );
+                          } );
+
+        if ( subMesh.compact )
+            subMesh.compactVertices.assign( vertices.begin(), vertices.end() );
+
+        // Generate the levels of detail. All LODs are stored in the same index buffer.
+        auto& lods       = subMesh.lods;
+        auto& lodIndices = subMesh.indices;
+        if ( options.numLODs > 0 && !lodIndices.empty() )
+        {
+            lods.push_back( { 0, static_cast<uint32_t>( lodIndices.size() ), 0.0f } );
+            const std::vector<uint32_t> sourceIndices = lodIndices;
+
+            for ( uint32_t l = 0; l < options.numLODs; ++l )
+            {
+                const MeshLOD& previousLOD = lods.back();
+
+                // Each LOD is simplified from the source mesh, so the error is the deviation from the source.
+                float error             = 0.0f;
+                auto  targetIndexCount  = static_cast<std::size_t>( previousLOD.indexCount * options.lodReduction );
+                auto  simplifiedIndices = simplifyMesh( vertices, sourceIndices, targetIndexCount, FLT_MAX, &error );
+
+                // Stop if the mesh could not be simplified significantly (for example, because of locked seams).
+                if ( simplifiedIndices.size() > previousLOD.indexCount * 9 / 10 )
+                    break;
+
+                // The error of a coarser LOD is never smaller than the error of the previous LOD.
+                MeshLOD lod { static_cast<uint32_t>( lodIndices.size() ),
+                              static_cast<uint32_t>( simplifiedIndices.size() ),
+                              std::max( previousLOD.error, error ) };
+                lodIndices.insert( lodIndices.end(), simplifiedIndices.begin(), simplifiedIndices.end() );
+                lods.push_back( lod );
+            }
+
+            importedMesh.lodTriangleCount += ( lodIndices.size() - lods[0].indexCount ) / 3;
+        }
+
+        // Use 16-bit indices if all vertices can be addressed with 16-bit indices.
+        if ( !lodIndices.empty() && vertices.size() <= 65536 )
+            subMesh.indices16.assign( lodIndices.begin(), lodIndices.end() );
+
+        // Compute the bounding sphere of the mesh (used to select the LOD).
+        glm::vec3 boundsMin { FLT_MAX };
+        glm::vec3 boundsMax { -FLT_MAX };
+        for ( const auto& vertex: vertices )
+        {
+            boundsMin = glm::min( boundsMin, vertex.position );
+            boundsMax = glm::max( boundsMax, vertex.position );
+        }
+
+        subMesh.boundsCenter = ( boundsMin + boundsMax ) * 0.5f;
+        for ( const auto& vertex: vertices )
+        {
+            subMesh.boundsRadius =
+                std::max( subMesh.boundsRadius, glm::distance( subMesh.boundsCenter, vertex.position ) );
+        }
+
+        // Build the meshlets from the highest level of detail.
+        if ( options.buildMeshlets && !lodIndices.empty() )
+        {
+            std::size_t indexCount = lods.empty() ? lodIndices.size() : lods[0].indexCount;
+            subMesh.meshlets       = buildMeshlets( vertices, { lodIndices.begin(), lodIndices.begin() + indexCount },
+                                                    subMesh.meshletIndices );
+        }
+    }
+
+    return importedMesh;
+}
+
+std::shared_ptr<SceneNode> importSceneNode( const aiNode* aiNode, std::shared_ptr<SceneNode> parent,
+                                            const std::vector<std::vector<std::shared_ptr<Mesh>>>& meshes )
+{
+    if ( !aiNode )
+    {
+        return nullptr;
+    }
+
+    glm::mat4 transform {
+        aiNode->mTransformation.a1, aiNode->mTransformation.a2, aiNode->mTransformation.a3, aiNode->mTransformation.a4,
+        aiNode->mTransformation.b1, aiNode->mTransformation.b2, aiNode->mTransformation.b3, aiNode->mTransformation.b4,
+        aiNode->mTransformation.c1, aiNode->mTransformation.c2, aiNode->mTransformation.c3, aiNode->mTransformation.c4,
+        aiNode->mTransformation.d1, aiNode->mTransformation.d2, aiNode->mTransformation.d3, aiNode->mTransformation.d4,
+    };
+
+    auto node = std::make_shared<SceneNode>( transform );
+    node->setParent( parent );
+
+    for ( unsigned int i = 0; i < aiNode->mNumMeshes; ++i )
+    {
+        // A mesh may have been split into multiple submeshes.
+        for ( auto& mesh: meshes[aiNode->mMeshes[i]] )
+        {
+            node->addMesh( mesh );
+        }
+    }
+
+    // Import children.
+    for ( unsigned int i = 0; i < aiNode->mNumChildren; ++i )
+    {
+        auto child = importSceneNode( aiNode->mChildren[i], node, meshes );
+        node->addChild( child );
+    }
+
+    return node;
+}
+
+// An Assimp stream that reads a file that was read into memory.
+class MemoryIOStream : public Assimp::IOStream
+{
+public:
+    explicit MemoryIOStream( std::vector<uint8_t>&& _data )
+    : data { std::move( _data ) }
+    {}
+
+    std::size_t Read( void* buffer, std::size_t size, std::size_t count ) override
+    {
+        if ( size == 0 )
+            return 0;
+
+        count = std::min( count, ( data.size() - position ) / size );
+        std::memcpy( buffer, data.data() + position, size * count );
+        position += size * count;
+
+        return count;
+    }
+
+    std::size_t Write( const void*, std::size_t, std::size_t ) override
+    {
+        return 0;
+    }
+
+    aiReturn Seek( std::size_t offset, aiOrigin origin ) override
+    {
+        std::size_t newPosition = offset;
+        if ( origin == aiOrigin_CUR )
+            newPosition += position;
+        else if ( origin == aiOrigin_END )
+            newPosition = data.size() - offset;
+
+        if ( newPosition > data.size() )
+            return aiReturn_FAILURE;
+
+        position = newPosition;
+
+        return aiReturn_SUCCESS;
+    }
+
+    std::size_t Tell() const override
+    {
+        return position;
+    }
+
+    std::size_t FileSize() const override
+    {
+        return data.size();
+    }
+
+    void Flush() override {}
+
+private:
+    std::vector<uint8_t> data;
+    std::size_t          position = 0;
+};
+
+// An Assimp file system that reads the files in the mounted archives (and all other files from disk),
+// so the files that are referenced by a scene (like the material library of an OBJ file) are found in the archives.
+class ArchiveIOSystem : public Assimp::DefaultIOSystem
+{
+public:
+    explicit ArchiveIOSystem( const std::vector<std::unique_ptr<AssetArchive>>& _archives )
+    : archives { _archives }
+    {}
+
+    bool Exists( const char* filePath ) const override
+    {
+        return findArchive( archives, getPath( filePath ) ) || DefaultIOSystem::Exists( filePath );
+    }
+
+    Assimp::IOStream* Open( const char* filePath, const char* mode ) override
+    {
+        const auto path = getPath( filePath );
+        if ( auto archive = findArchive( archives, path ); archive && mode[0] == 'r' )
+            return new MemoryIOStream( archive->read( path ) );
+
+        return DefaultIOSystem::Open( filePath, mode );
+    }
+
+private:
+    static std::string getPath( const char* filePath )
+    {
+        std::string path = filePath;
+        std::replace( path.begin(), path.end(), '\\', '/' );
+        return path;
+    }
+
+    const std::vector<std::unique_ptr<AssetArchive>>& archives;
+};
+
+std::shared_ptr<Scene> Device::loadScene( const std::filesystem::path& filePath, const SceneImportOptions& options )
+{
+    fs::path parentPath = filePath.parent_path();
+
+    fs::path exportPath = filePath;
+    exportPath.replace_extension( "assbin" );
+
+    Assimp::Importer     importer;
+    const aiScene*       scene = nullptr;
+    std::vector<uint8_t> sceneData;
+
+    if ( fileExists( exportPath ) )
+    {
+        // The preprocessed scene is read with the file reader and parsed from memory.
+        sceneData = readFile( exportPath );
+        if ( !sceneData.empty() )
+            scene = importer.ReadFileFromMemory( sceneData.data(), sceneData.size(), aiProcess_GenBoundingBoxes,
+                                                 "assbin" );
+    }
+    else
+    {
         // File has not been preprocessed yet. Import and processes the file.
+        if ( !archives.empty() )
+            importer.SetIOHandler( new ArchiveIOSystem( archives ) );
+
         importer.SetPropertyFloat( AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 80.0f );
         importer.SetPropertyInteger( AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE );
 
@@ -786,9 +2487,86 @@ std::shared_ptr<Scene> Device::loadScene( const std::filesystem::path& filePath
     }
 
     // Import materials.
+    // The GPU mips of all textures are generated with a single submission after the materials are imported.
+    TextureLoadOptions textureOptions;
+    textureOptions.compress       = options.compressTextures;
+    textureOptions.precomputeMips = options.precomputeMips;
+    textureOptions.deferMips      = true;
+
+    // Color textures are sRGB encoded.
+    TextureLoadOptions colorOptions = textureOptions;
+    colorOptions.sRGB               = true;
+
+    TextureLoadOptions normalMapOptions = textureOptions;
+    normalMapOptions.normalMap          = true;
+
     std::vector<std::shared_ptr<Material>> materials;
     materials.reserve( scene->mNumMaterials );
 
+    // Load a texture of a material. Cooked textures are streamed if a texture streamer is used
+    // (the texture streamer reads the cooked textures from disk, not from the mounted archives).
+    // Like loadTexture, a cooked texture is only used if it was cooked with the load options
+    // (source DDS files are used as-is).
+    auto loadMaterialTexture = [&]( const fs::path& filePath, const TextureLoadOptions& loadOptions,
+                                    const std::shared_ptr<Material>& material, TextureSlot slot ) {
+        const bool isDDS = filePath.extension() == ".dds";
+        if ( options.textureStreamer && ( loadOptions.compress || loadOptions.precomputeMips || isDDS ) )
+        {
+            fs::path cachePath = filePath;
+            cachePath.replace_extension( "dds" );
+
+            TextureData header;
+            if ( fs::exists( cachePath ) && fs::exists( filePath ) &&
+                 fs::last_write_time( cachePath ) >= fs::last_write_time( filePath ) &&
+                 loadDDSHeader( cachePath, header ) && ( isDDS || isCookedTextureValid( header, loadOptions ) ) )
+            {
+                if ( auto texture = options.textureStreamer->load( cachePath ) )
+                {
+                    options.textureStreamer->addMaterial( texture, material, slot );
+                    return;
+                }
+            }
+        }
+
+        material->setTexture( slot, loadTexture( filePath, loadOptions ) );
+    };
+
+    // Start reading the textures of all materials, so the files are read while the textures are decoded.
+    // The cooked texture is read instead of the source image if it is up to date (streamed textures are
+    // read by the texture streamer).
+    const bool cook = options.compressTextures || options.precomputeMips;
+    for ( unsigned int i = 0; i < scene->mNumMaterials; ++i )
+    {
+        const aiMaterial* aiMaterial = scene->mMaterials[i];
+
+        for ( auto textureType: { aiTextureType_AMBIENT, aiTextureType_EMISSIVE, aiTextureType_DIFFUSE,
+                                  aiTextureType_SPECULAR, aiTextureType_SHININESS, aiTextureType_OPACITY,
+                                  aiTextureType_NORMALS, aiTextureType_HEIGHT } )
+        {
+            aiString texturePath;
+            if ( aiMaterial->GetTextureCount( textureType ) == 0 ||
+                 aiMaterial->GetTexture( textureType, 0, &texturePath ) != aiReturn_SUCCESS )
+                continue;
+
+            // Use the same file path as loadTexture.
+            auto prefetchPath = ( parentPath / texturePath.C_Str() ).string();
+            std::replace( prefetchPath.begin(), prefetchPath.end(), '\\', '/' );
+
+            if ( !fileExists( prefetchPath ) )
+                continue;
+
+            fs::path cachePath = prefetchPath;
+            cachePath.replace_extension( "dds" );
+
+            const bool upToDate = isUpToDate( cachePath, prefetchPath );
+            if ( options.textureStreamer && ( cook || fs::path( prefetchPath ).extension() == ".dds" ) && upToDate &&
+                 fs::exists( cachePath ) )
+                continue;
+
+            prefetchFile( cook && upToDate ? cachePath : fs::path( prefetchPath ) );
+        }
+    }
+
     for ( unsigned int i = 0; i < scene->mNumMaterials; ++i )
     {
         const aiMaterial*         aiMaterial = scene->mMaterials[i];
@@ -844,135 +2622,291 @@ std::shared_ptr<Scene> Device::loadScene( const std::filesystem::path& filePath
         if ( aiMaterial->GetTextureCount( aiTextureType_AMBIENT ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_AMBIENT, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Ambient, texture );
+            loadMaterialTexture( parentPath / texturePath.C_Str(), colorOptions, material, TextureSlot::Ambient );
         }
         if ( aiMaterial->GetTextureCount( aiTextureType_EMISSIVE ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_EMISSIVE, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Emissive, texture );
+            loadMaterialTexture( parentPath / texturePath.C_Str(), colorOptions, material, TextureSlot::Emissive );
         }
         if ( aiMaterial->GetTextureCount( aiTextureType_DIFFUSE ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_DIFFUSE, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Diffuse, texture );
-        }
-        if ( aiMaterial->GetTextureCount( aiTextureType_SPECULAR ) > 0 &&
-             aiMaterial->GetTexture( aiTextureType_SPECULAR, 0, &texturePath ) == aiReturn_SUCCESS )
-        {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Specular, texture );
+            loadMaterialTexture( parentPath / texturePath.C_Str(), colorOptions, material, TextureSlot::Diffuse );
         }
-        if ( aiMaterial->GetTextureCount( aiTextureType_SHININESS ) > 0 &&
-             aiMaterial->GetTexture( aiTextureType_SHININESS, 0, &texturePath ) == aiReturn_SUCCESS )
+
+        // Pack the grayscale specular, specular power and opacity textures into a single texture
+        // (in the channel order of TextureSlot::Packed).
+        constexpr std::array<std::pair<aiTextureType, TextureSlot>, 3> packedSlots { {
+            { aiTextureType_SPECULAR, TextureSlot::Specular },
+            { aiTextureType_SHININESS, TextureSlot::SpecularPower },
+            { aiTextureType_OPACITY, TextureSlot::Opacity },
+        } };
+
+        std::array<fs::path, 4> packedPaths;
+        uint32_t                numPackedTextures = 0;
+        for ( uint32_t c = 0; c < packedSlots.size(); ++c )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::SpecularPower, texture );
+            if ( aiMaterial->GetTextureCount( packedSlots[c].first ) > 0 &&
+                 aiMaterial->GetTexture( packedSlots[c].first, 0, &texturePath ) == aiReturn_SUCCESS )
+            {
+                packedPaths[c] = parentPath / texturePath.C_Str();
+                ++numPackedTextures;
+            }
         }
-        if ( aiMaterial->GetTextureCount( aiTextureType_OPACITY ) > 0 &&
-             aiMaterial->GetTexture( aiTextureType_OPACITY, 0, &texturePath ) == aiReturn_SUCCESS )
+
+        // The channels of the packed texture are stored as-is (all material textures use Unorm formats,
+        // so the shader reads the same values from the packed texture as from the separate textures).
+        std::shared_ptr<Texture> packedTexture;
+        if ( options.packTextures && numPackedTextures > 1 )
+            packedTexture = loadPackedTexture( packedPaths, textureOptions );
+
+        if ( packedTexture )
+            material->setTexture( TextureSlot::Packed, packedTexture );
+
+        for ( uint32_t c = 0; c < packedSlots.size(); ++c )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Opacity, texture );
+            if ( packedPaths[c].empty() )
+                continue;
+
+            if ( packedTexture )
+            {
+                material->setPackedSlot( packedSlots[c].second );
+            }
+            else
+            {
+                // Specular textures are sRGB encoded.
+                const bool sRGB = packedSlots[c].second == TextureSlot::Specular;
+                loadMaterialTexture( packedPaths[c], sRGB ? colorOptions : textureOptions, material,
+                                     packedSlots[c].second );
+            }
         }
+
         if ( aiMaterial->GetTextureCount( aiTextureType_NORMALS ) > 0 &&
              aiMaterial->GetTexture( aiTextureType_NORMALS, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Normal, texture );
+            loadMaterialTexture( parentPath / texturePath.C_Str(), normalMapOptions, material, TextureSlot::Normal );
         }
         else if ( aiMaterial->GetTextureCount( aiTextureType_HEIGHT ) > 0 &&
                   aiMaterial->GetTexture( aiTextureType_HEIGHT, 0, &texturePath ) == aiReturn_SUCCESS )
         {
-            auto texture = loadTexture( parentPath / texturePath.C_Str() );
-            material->setTexture( TextureSlot::Normal, texture );  // Assume height maps are actually normal maps.
+            // Assume height maps are actually normal maps.
+            loadMaterialTexture( parentPath / texturePath.C_Str(), normalMapOptions, material, TextureSlot::Normal );
         }
 
+        materialTable->add( *material );
         materials.emplace_back( std::move( material ) );
     }
 
-    // Import meshes.
-    std::vector<std::shared_ptr<Mesh>> meshes;
+    // Drop the files that were prefetched but not used (for example, the images of packed textures).
+    prefetchedFiles.clear();
+
+    flushGenerateMips();
+
+    if ( options.textureArrays )
+        createTextureArrays( materials, options.textureStreamer );
+
+    // Import meshes. Each aiMesh is imported as one or more submeshes.
+    std::vector<std::vector<std::shared_ptr<Mesh>>> meshes;
     meshes.reserve( scene->mNumMeshes );
 
+    // Keep track of the size of the vertex and index data to report the savings of the compact layouts.
+    std::size_t  vertexDataSize     = 0;
+    std::size_t  fullVertexDataSize = 0;
+    std::size_t  indexDataSize      = 0;
+    std::size_t  fullIndexDataSize  = 0;
+    unsigned int numCompactMeshes   = 0;
+    unsigned int numSplitMeshes     = 0;
+    unsigned int numSharedMeshes    = 0;
+    std::size_t  triangleCount      = 0;
+    std::size_t  lodTriangleCount   = 0;
+    std::size_t  meshletCount       = 0;
+
+    // Used to share the buffers of meshes with identical geometry.
+    BufferCache<VertexBuffer> vertexBufferCache;
+    BufferCache<IndexBuffer>  indexBufferCache;
+    std::map<std::tuple<const VertexBuffer*, const IndexBuffer*, const Material*>, std::shared_ptr<Mesh>> meshCache;
+
+    // Prepare the meshes on the worker threads. Only the GPU buffers are created on this thread.
+    const auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<ImportedMesh> importedMeshes( scene->mNumMeshes );
+    threadPool->parallelFor( scene->mNumMeshes, [&]( std::size_t m ) {
+        importedMeshes[m] = importMesh( *scene->mMeshes[m], options );
+    } );
+
+    const auto prepareTime = std::chrono::steady_clock::now();
+
     for ( unsigned int m = 0; m < scene->mNumMeshes; ++m )
     {
-        const aiMesh* aiMesh = scene->mMeshes[m];
-
-        std::shared_ptr<Mesh>                                    mesh = std::make_shared<Mesh>();
-        std::vector<VertexPositionNormalTangentBitangentTexture> vertexData { aiMesh->mNumVertices };
+        const aiMesh* aiMesh       = scene->mMeshes[m];
+        auto&         importedMesh = importedMeshes[m];
 
         assert( aiMesh->mMaterialIndex < materials.size() );
-        mesh->setMaterial( materials[aiMesh->mMaterialIndex] );
+        auto material = materials[aiMesh->mMaterialIndex];
+
+        triangleCount += importedMesh.triangleCount;
+        lodTriangleCount += importedMesh.lodTriangleCount;
+        if ( importedMesh.split )
+            ++numSplitMeshes;
+
+        std::vector<std::shared_ptr<Mesh>> subMeshList;
+        subMeshList.reserve( importedMesh.subMeshes.size() );
 
-        if ( aiMesh->HasPositions() )
+        for ( auto& subMesh: importedMesh.subMeshes )
         {
-            for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+            const auto& vertices          = subMesh.vertices;
+            const auto& compactVertexData = subMesh.compactVertices;
+            const auto& lodIndices        = subMesh.indices;
+            const auto& indices16         = subMesh.indices16;
+
+            // The buffers of streamed meshes are created by the geometry streamer.
+            // The size of the geometry is only counted once for buffers that are shared (see BufferCache).
+            std::shared_ptr<VertexBuffer> vertexBuffer;
+            VertexLayout                  vertexLayout;
+            bool                          createdVertexBuffer = options.geometryStreamer != nullptr;
+            if ( subMesh.compact )
             {
-                aiVector3D p           = aiMesh->mVertices[v];
-                vertexData[v].position = { p.x, p.y, p.z };
+                if ( !options.geometryStreamer )
+                {
+                    vertexBuffer = vertexBufferCache.getOrCreate( compactVertexData, [&] {
+                        createdVertexBuffer = true;
+                        return createVertexBuffer( compactVertexData );
+                    } );
+                }
+                vertexLayout = VertexLayout::PositionQTangentTexture;
+                if ( createdVertexBuffer )
+                    ++numCompactMeshes;
             }
-        }
-        if ( aiMesh->HasNormals() )
-        {
-            for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+            else
             {
-                aiVector3D n         = aiMesh->mNormals[v];
-                vertexData[v].normal = { n.x, n.y, n.z };
+                if ( !options.geometryStreamer )
+                {
+                    vertexBuffer = vertexBufferCache.getOrCreate( vertices, [&] {
+                        createdVertexBuffer = true;
+                        return createVertexBuffer( vertices );
+                    } );
+                }
+                vertexLayout = VertexLayout::PositionNormalTangentBitangentTexture;
             }
-        }
-        if ( aiMesh->HasTangentsAndBitangents() )
-        {
-            for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+
+            const void*       meshVertexData = subMesh.compact ? static_cast<const void*>( compactVertexData.data() )
+                                                               : static_cast<const void*>( vertices.data() );
+            const std::size_t vertexStride   = subMesh.compact ? sizeof( VertexPositionQTangentTexture )
+                                                               : sizeof( VertexPositionNormalTangentBitangentTexture );
+
+            if ( createdVertexBuffer )
             {
-                aiVector3D t            = aiMesh->mTangents[v];
-                aiVector3D b            = aiMesh->mBitangents[v];
-                vertexData[v].tangent   = { t.x, t.y, t.z };
-                vertexData[v].bitangent = { b.x, b.y, b.z };
+                vertexDataSize += vertices.size() * vertexStride;
+                fullVertexDataSize += vertices.size() * sizeof( VertexPositionNormalTangentBitangentTexture );
             }
-        }
-        if ( aiMesh->HasTextureCoords( 0 ) )
-        {
-            for ( unsigned int v = 0; v < aiMesh->mNumVertices; ++v )
+
+            // Use 16-bit indices if all vertices can be addressed with 16-bit indices.
+            std::shared_ptr<IndexBuffer> indexBuffer;
+            bool                         createdIndexBuffer = options.geometryStreamer != nullptr;
+            if ( lodIndices.empty() || options.geometryStreamer )
             {
-                aiVector3D uv          = aiMesh->mTextureCoords[0][v];
-                vertexData[v].texCoord = { uv.x, uv.y, uv.z };
+                // Non-indexed or streamed mesh.
+            }
+            else if ( !indices16.empty() )
+            {
+                indexBuffer = indexBufferCache.getOrCreate( indices16, [&] {
+                    createdIndexBuffer = true;
+                    return createIndexBuffer( indices16 );
+                } );
+            }
+            else
+            {
+                indexBuffer = indexBufferCache.getOrCreate( lodIndices, [&] {
+                    createdIndexBuffer = true;
+                    return createIndexBuffer( lodIndices );
+                } );
             }
-        }
 
-        auto vertexBuffer = createVertexBuffer( vertexData );
-        mesh->setVertexBuffer( 0, vertexBuffer );
+            const void*       meshIndexData = indices16.empty() ? static_cast<const void*>( lodIndices.data() )
+                                                                : static_cast<const void*>( indices16.data() );
+            const std::size_t indexStride   = indices16.empty() ? sizeof( uint32_t ) : sizeof( uint16_t );
 
-        // Extract index buffer.
-        if ( aiMesh->HasFaces() )
-        {
-            std::vector<unsigned int> indices;
-            indices.reserve( aiMesh->mNumFaces * 3 );
+            if ( !lodIndices.empty() && createdIndexBuffer )
+            {
+                indexDataSize += lodIndices.size() * indexStride;
+                fullIndexDataSize += lodIndices.size() * sizeof( uint32_t );
+            }
+
+            // Meshes with the same geometry and material are shared so they can be drawn with instancing.
+            // Streamed meshes don't have buffers yet, so they are only shared by the nodes that reference them.
+            std::shared_ptr<Mesh> streamedMesh;
 
-            for ( unsigned int f = 0; f < aiMesh->mNumFaces; ++f )
+            auto  meshKey = std::make_tuple( vertexBuffer.get(), indexBuffer.get(), material.get() );
+            auto& mesh    = options.geometryStreamer ? streamedMesh : meshCache[meshKey];
+            if ( mesh )
             {
-                const aiFace& face = aiMesh->mFaces[f];
+                ++numSharedMeshes;
+            }
+            else
+            {
+                mesh = std::make_shared<Mesh>( vertexBuffer, indexBuffer, material );
+                mesh->setVertexLayout( vertexLayout );
+                if ( !subMesh.meshlets.empty() )
+                {
+                    mesh->setMeshlets( createStorageBuffer( subMesh.meshlets ),
+                                       createStorageBuffer( subMesh.meshletIndices ) );
+                    meshletCount += subMesh.meshlets.size();
+                }
+
+                mesh->setLODs( std::move( subMesh.lods ) );
+                mesh->setBoundingSphere( subMesh.boundsCenter, subMesh.boundsRadius );
 
-                // We only care about triangular faces.
-                if ( face.mNumIndices == 3 )
+                // Only the proxy of a streamed mesh is uploaded. Meshes that can't be streamed are always resident.
+                if ( options.geometryStreamer &&
+                     !options.geometryStreamer->addMesh( mesh, meshVertexData, vertices.size(), vertexStride,
+                                                         meshIndexData, lodIndices.size(), indexStride ) )
                 {
-                    indices.push_back( face.mIndices[0] );
-                    indices.push_back( face.mIndices[1] );
-                    indices.push_back( face.mIndices[2] );
+                    mesh->setVertexBuffer( 0, createVertexBuffer( meshVertexData, vertices.size(), vertexStride ) );
+                    if ( !lodIndices.empty() )
+                        mesh->setIndexBuffer( createIndexBuffer( meshIndexData, lodIndices.size(), indexStride ) );
                 }
             }
 
-            if ( !indices.empty() )
-            {
-                auto indexBuffer = createIndexBuffer( indices );
-                mesh->setIndexBuffer( indexBuffer );
-            }
+            subMeshList.push_back( mesh );
         }
 
-        meshes.emplace_back( std::move( mesh ) );
+        meshes.emplace_back( std::move( subMeshList ) );
+
+        // Release the CPU copy of the geometry. The buffer cache compares new meshes with the geometry
+        // of the meshes that created its buffers, so it is only released early if the cache is not used.
+        if ( options.geometryStreamer )
+            importedMesh = {};
+    }
+
+    importedMeshes.clear();
+
+    const auto endTime = std::chrono::steady_clock::now();
+
+    std::cout << "INFO: Prepared " << scene->mNumMeshes << " meshes in "
+              << std::chrono::duration<double, std::milli>( prepareTime - startTime ).count()
+              << " ms and created their buffers in "
+              << std::chrono::duration<double, std::milli>( endTime - prepareTime ).count() << " ms." << std::endl;
+
+    std::cout << "INFO: Vertex data: " << vertexDataSize / 1024 << " KB (" << fullVertexDataSize / 1024
+              << " KB without compact vertices). " << numCompactMeshes
+              << " vertex buffers use the compact vertex layout." << std::endl;
+    std::cout << "INFO: Index data: " << indexDataSize / 1024 << " KB (" << fullIndexDataSize / 1024
+              << " KB with 32-bit indices). " << numSplitMeshes << " of " << scene->mNumMeshes
+              << " meshes were split into 16-bit submeshes." << std::endl;
+    if ( options.numLODs > 0 )
+    {
+        std::cout << "INFO: Generated " << lodTriangleCount << " LOD triangles for " << triangleCount
+                  << " triangles." << std::endl;
+    }
+    if ( options.buildMeshlets )
+    {
+        std::cout << "INFO: Built " << meshletCount << " meshlets." << std::endl;
     }
+    std::cout << "INFO: Geometry deduplication saved "
+              << ( vertexBufferCache.bytesSaved + indexBufferCache.bytesSaved ) / 1024 << " KB ("
+              << vertexBufferCache.numShared << " vertex buffers, " << indexBufferCache.numShared
+              << " index buffers and " << numSharedMeshes << " meshes shared)." << std::endl;
 
     auto rootNode = importSceneNode( scene->mRootNode, nullptr, meshes );
 
@@ -998,23 +2932,68 @@ std::shared_ptr<VertexBuffer> Device::createVertexBuffer( const void* vertexData
 }
 
 std::shared_ptr<IndexBuffer> Device::createIndexBuffer( const void* indexData, std::size_t indexCount,
-                                                        std::size_t indexStride ) const
+                                                        std::size_t indexStride, WGPUBufferUsageFlags extraUsage ) const
 {
-    std::size_t          size = indexCount * indexStride;
+    std::size_t size = indexCount * indexStride;
+    // Buffer sizes and writes must be a multiple of 4 bytes (which is not the case for an odd number of 16-bit indices).
+    std::size_t          alignedSize = AlignUp( size, 4 );
     WGPUBufferDescriptor bufferDescriptor {};
-    bufferDescriptor.size  = size;
-    bufferDescriptor.usage = WGPUBufferUsage_Index | WGPUBufferUsage_CopyDst;
+    bufferDescriptor.size  = alignedSize;
+    bufferDescriptor.usage = WGPUBufferUsage_Index | WGPUBufferUsage_CopyDst | extraUsage;
     WGPUBuffer buffer      = wgpuDeviceCreateBuffer( device, &bufferDescriptor );
 
     auto indexBuffer = std::make_shared<MakeIndexBuffer>( std::move( buffer ),  // NOLINT(performance-move-const-arg)
                                                           indexCount, indexStride );
 
     if ( indexData )
-        queue->writeBuffer( *indexBuffer, indexData, size );
+    {
+        if ( alignedSize != size )
+        {
+            std::vector<uint8_t> paddedData( alignedSize, 0 );
+            std::memcpy( paddedData.data(), indexData, size );
+            queue->writeBuffer( *indexBuffer, paddedData.data(), alignedSize );
+        }
+        else
+        {
+            queue->writeBuffer( *indexBuffer, indexData, size );
+        }
+    }
 
     return indexBuffer;
 }
 
+std::shared_ptr<IndexBuffer> Device::createCompactIndexBuffer( const std::vector<uint32_t>& indices,
+                                                               std::size_t                  vertexCount ) const
+{
+    if ( vertexCount > 65536 )
+        return createIndexBuffer( indices );
+
+    std::vector<uint16_t> indices16 { indices.begin(), indices.end() };
+
+    return createIndexBuffer( indices16 );
+}
+
+std::shared_ptr<VertexBuffer> Device::createVertexBufferRange( WGPUBuffer buffer, std::size_t offset,
+                                                               std::size_t vertexCount,
+                                                               std::size_t vertexStride ) const
+{
+    // The vertex buffer releases its reference when it is destroyed.
+    wgpuBufferReference( buffer );
+
+    return std::make_shared<MakeVertexBuffer>( std::move( buffer ),  // NOLINT(performance-move-const-arg)
+                                               vertexCount, vertexStride, offset );
+}
+
+std::shared_ptr<IndexBuffer> Device::createIndexBufferRange( WGPUBuffer buffer, std::size_t offset,
+                                                             std::size_t indexCount, std::size_t indexStride ) const
+{
+    // The index buffer releases its reference when it is destroyed.
+    wgpuBufferReference( buffer );
+
+    return std::make_shared<MakeIndexBuffer>( std::move( buffer ),  // NOLINT(performance-move-const-arg)
+                                              indexCount, indexStride, offset );
+}
+
 std::shared_ptr<UniformBuffer> Device::createUniformBuffer( const void* data, std::size_t size ) const
 {
     WGPUBufferDescriptor bufferDescriptor {};
@@ -1033,12 +3012,12 @@ std::shared_ptr<UniformBuffer> Device::createUniformBuffer( const void* data, st
 }
 
 std::shared_ptr<StorageBuffer> Device::createStorageBuffer( const void* data, std::size_t elementCount,
-                                                            std::size_t elementSize ) const
+                                                            std::size_t elementSize, WGPUBufferUsageFlags extraUsage ) const
 {
     std::size_t          size = elementCount * elementSize;
     WGPUBufferDescriptor bufferDescriptor {};
     bufferDescriptor.size             = size;
-    bufferDescriptor.usage            = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst;
+    bufferDescriptor.usage            = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst | extraUsage;
     bufferDescriptor.mappedAtCreation = false;
     WGPUBuffer buffer                 = wgpuDeviceCreateBuffer( device, &bufferDescriptor );
 
@@ -1083,6 +3062,22 @@ void Device::poll( bool sleep )
 #endif
 }
 
+void Device::waitIdle()
+{
+    bool done = false;
+    wgpuQueueOnSubmittedWorkDone(
+        queue->getWGPUQueue(),
+        []( WGPUQueueWorkDoneStatus status, void* userData ) { *static_cast<bool*>( userData ) = true; }, &done );
+
+    while ( !done )
+        poll( true );
+}
+
+bool Device::hasFeature( WGPUFeatureName feature ) const
+{
+    return wgpuDeviceHasFeature( device, feature );
+}
+
 void Device::onDeviceLostCallback( WGPUDeviceLostReason reason, char const* message, void* userdata )
 {
     std::cerr << "Device lost: " << std::hex << reason << std::dec;
@@ -0,0 +1,364 @@
+#include <WebGPUlib/FileReader.hpp>
+#include <WebGPUlib/ThreadPool.hpp>
+
+#if defined( __linux__ ) && !defined( __EMSCRIPTEN__ ) && __has_include( <linux/io_uring.h> )
+    #define WEBGPULIB_IO_URING
+#endif
+
+#ifdef WEBGPULIB_IO_URING
+    #include <fcntl.h>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+    #include <cerrno>
+    #include <cstring>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+using namespace WebGPUlib;
+
+#ifdef WEBGPULIB_IO_URING
+
+// A minimal io_uring instance that is set up with the raw system calls (liburing is not required).
+// Only used by the I/O thread.
+struct FileReader::IoUring
+{
+    // A read that has been submitted to the ring.
+    struct Read
+    {
+        Request              request;
+        int                  fd = -1;
+        std::vector<uint8_t> data;
+        std::size_t          offset = 0;
+    };
+
+    ~IoUring()
+    {
+        if ( sqes )
+            munmap( sqes, sqesSize );
+        if ( cqRing && cqRing != sqRing )
+            munmap( cqRing, cqRingSize );
+        if ( sqRing )
+            munmap( sqRing, sqRingSize );
+        if ( ringFd >= 0 )
+            close( ringFd );
+    }
+
+    bool init( uint32_t entries )
+    {
+        io_uring_params params {};
+        ringFd = static_cast<int>( syscall( __NR_io_uring_setup, entries, &params ) );
+        if ( ringFd < 0 )
+            return false;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof( uint32_t );
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+        sqesSize   = params.sq_entries * sizeof( io_uring_sqe );
+
+        // Newer kernels map the submission and completion rings with a single mmap.
+        const bool singleMap = ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0;
+        if ( singleMap )
+            sqRingSize = cqRingSize = std::max( sqRingSize, cqRingSize );
+
+        sqRing = mapRing( sqRingSize, IORING_OFF_SQ_RING );
+        if ( !sqRing )
+            return false;
+
+        cqRing = singleMap ? sqRing : mapRing( cqRingSize, IORING_OFF_CQ_RING );
+        if ( !cqRing )
+            return false;
+
+        sqes = static_cast<io_uring_sqe*>( mapRing( sqesSize, IORING_OFF_SQES ) );
+        if ( !sqes )
+            return false;
+
+        auto* sq = static_cast<uint8_t*>( sqRing );
+        sqHead   = reinterpret_cast<uint32_t*>( sq + params.sq_off.head );
+        sqTail   = reinterpret_cast<uint32_t*>( sq + params.sq_off.tail );
+        sqMask   = *reinterpret_cast<uint32_t*>( sq + params.sq_off.ring_mask );
+        sqArray  = reinterpret_cast<uint32_t*>( sq + params.sq_off.array );
+
+        auto* cq = static_cast<uint8_t*>( cqRing );
+        cqHead   = reinterpret_cast<uint32_t*>( cq + params.cq_off.head );
+        cqTail   = reinterpret_cast<uint32_t*>( cq + params.cq_off.tail );
+        cqMask   = *reinterpret_cast<uint32_t*>( cq + params.cq_off.ring_mask );
+        cqes     = reinterpret_cast<io_uring_cqe*>( cq + params.cq_off.cqes );
+
+        reads.resize( params.sq_entries );
+        for ( uint32_t i = 0; i < params.sq_entries; ++i )
+            freeSlots.push_back( i );
+
+        return true;
+    }
+
+    void* mapRing( std::size_t size, off_t offset ) const
+    {
+        void* ptr = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset );
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    // Queue a read of the remaining bytes of a slot. The read is submitted with the next call to enter.
+    void queueRead( uint32_t slot )
+    {
+        auto& read = reads[slot];
+
+        const uint32_t tail  = *sqTail;
+        const uint32_t index = tail & sqMask;
+
+        // Reads are limited to 1 GB (the length of a read is 32-bit).
+        const std::size_t length = std::min<std::size_t>( read.data.size() - read.offset, 1u << 30 );
+
+        io_uring_sqe& sqe = sqes[index];
+        std::memset( &sqe, 0, sizeof( sqe ) );
+        sqe.opcode    = IORING_OP_READ;
+        sqe.fd        = read.fd;
+        sqe.addr      = reinterpret_cast<uint64_t>( read.data.data() + read.offset );
+        sqe.len       = static_cast<uint32_t>( length );
+        sqe.off       = read.offset;
+        sqe.user_data = slot;
+
+        sqArray[index] = index;
+        __atomic_store_n( sqTail, tail + 1, __ATOMIC_RELEASE );
+
+        ++numQueued;
+    }
+
+    // Submit the queued reads and wait for at least minComplete reads to finish.
+    void enter( uint32_t minComplete )
+    {
+        while ( true )
+        {
+            const unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+            const long     result =
+                syscall( __NR_io_uring_enter, ringFd, numQueued, minComplete, flags, nullptr, std::size_t { 0 } );
+
+            if ( result >= 0 )
+            {
+                numQueued -= static_cast<uint32_t>( result );
+                return;
+            }
+
+            // Retry if the call was interrupted by a signal.
+            if ( errno != EINTR )
+                return;
+        }
+    }
+
+    int           ringFd     = -1;
+    void*         sqRing     = nullptr;
+    void*         cqRing     = nullptr;
+    io_uring_sqe* sqes       = nullptr;
+    std::size_t   sqRingSize = 0;
+    std::size_t   cqRingSize = 0;
+    std::size_t   sqesSize   = 0;
+
+    uint32_t*     sqHead  = nullptr;
+    uint32_t*     sqTail  = nullptr;
+    uint32_t      sqMask  = 0;
+    uint32_t*     sqArray = nullptr;
+    uint32_t*     cqHead  = nullptr;
+    uint32_t*     cqTail  = nullptr;
+    uint32_t      cqMask  = 0;
+    io_uring_cqe* cqes    = nullptr;
+
+    // The reads in flight (indexed by the user data of the submission).
+    std::vector<Read>     reads;
+    std::vector<uint32_t> freeSlots;
+    uint32_t              numQueued = 0;
+};
+
+#else
+
+struct FileReader::IoUring
+{
+};
+
+#endif
+
+FileReader::FileReader( ThreadPool& _threadPool, uint32_t _queueDepth )
+: threadPool { _threadPool }
+, queueDepth { std::max( _queueDepth, 1u ) }
+{
+#ifdef WEBGPULIB_IO_URING
+    ioUring = std::make_unique<IoUring>();
+    if ( ioUring->init( queueDepth ) )
+    {
+        thread = std::thread( &FileReader::ioThread, this );
+    }
+    else
+    {
+        std::cout << "INFO: io_uring is not available. Files are read on the worker threads." << std::endl;
+        ioUring.reset();
+    }
+#endif
+}
+
+FileReader::~FileReader()
+{
+    {
+        std::lock_guard lock( mutex );
+        stop = true;
+    }
+    condition.notify_all();
+
+    if ( thread.joinable() )
+        thread.join();
+}
+
+std::future<std::vector<uint8_t>> FileReader::read( const std::filesystem::path& filePath )
+{
+    if ( !ioUring )
+        return threadPool.submit( [filePath] { return readFile( filePath ); } );
+
+    Request request;
+    request.filePath = filePath;
+    auto future      = request.promise.get_future();
+
+    {
+        std::lock_guard lock( mutex );
+        requests.push( std::move( request ) );
+    }
+    condition.notify_one();
+
+    return future;
+}
+
+std::vector<uint8_t> FileReader::readFile( const std::filesystem::path& filePath )
+{
+    std::ifstream file( filePath, std::ios::binary | std::ios::ate );
+    if ( !file )
+    {
+        std::cerr << "ERROR: Failed to open file: " << filePath << std::endl;
+        return {};
+    }
+
+    std::vector<uint8_t> data( static_cast<std::size_t>( file.tellg() ) );
+    file.seekg( 0 );
+    file.read( reinterpret_cast<char*>( data.data() ), static_cast<std::streamsize>( data.size() ) );
+
+    if ( !file )
+    {
+        std::cerr << "ERROR: Failed to read file: " << filePath << std::endl;
+        return {};
+    }
+
+    return data;
+}
+
+void FileReader::ioThread()
+{
+#ifdef WEBGPULIB_IO_URING
+    auto&    ring     = *ioUring;
+    uint32_t inFlight = 0;
+
+    while ( true )
+    {
+        // Take the queued requests (as many as there are free slots).
+        std::vector<Request> newRequests;
+        {
+            std::unique_lock lock( mutex );
+
+            // Wait for new requests if no reads are in flight.
+            if ( inFlight == 0 )
+                condition.wait( lock, [this] { return stop || !requests.empty(); } );
+
+            if ( stop && requests.empty() && inFlight == 0 )
+                break;
+
+            while ( !requests.empty() && newRequests.size() < ring.freeSlots.size() )
+            {
+                newRequests.push_back( std::move( requests.front() ) );
+                requests.pop();
+            }
+        }
+
+        // Open the files and queue the reads. Empty files are completed right away.
+        for ( auto& request: newRequests )
+        {
+            const int fd = open( request.filePath.c_str(), O_RDONLY | O_CLOEXEC );
+
+            struct stat fileStat {};
+            if ( fd < 0 || fstat( fd, &fileStat ) != 0 )
+            {
+                std::cerr << "ERROR: Failed to open file: " << request.filePath << std::endl;
+                if ( fd >= 0 )
+                    close( fd );
+                request.promise.set_value( {} );
+                continue;
+            }
+
+            if ( fileStat.st_size == 0 )
+            {
+                close( fd );
+                request.promise.set_value( {} );
+                continue;
+            }
+
+            const uint32_t slot = ring.freeSlots.back();
+            ring.freeSlots.pop_back();
+
+            auto& read   = ring.reads[slot];
+            read.request = std::move( request );
+            read.fd      = fd;
+            read.offset  = 0;
+            read.data.resize( static_cast<std::size_t>( fileStat.st_size ) );
+
+            ring.queueRead( slot );
+            ++inFlight;
+        }
+
+        if ( inFlight == 0 )
+            continue;
+
+        // Submit the new reads. Block until a read finishes unless more requests are waiting.
+        bool moreRequests;
+        {
+            std::lock_guard lock( mutex );
+            moreRequests = !requests.empty() && !ring.freeSlots.empty();
+        }
+        ring.enter( moreRequests ? 0 : 1 );
+
+        // Complete the finished reads.
+        uint32_t       head = *ring.cqHead;
+        const uint32_t tail = __atomic_load_n( ring.cqTail, __ATOMIC_ACQUIRE );
+
+        for ( ; head != tail; ++head )
+        {
+            const io_uring_cqe& cqe  = ring.cqes[head & ring.cqMask];
+            const auto          slot = static_cast<uint32_t>( cqe.user_data );
+            auto&               read = ring.reads[slot];
+
+            if ( cqe.res > 0 && read.offset + static_cast<std::size_t>( cqe.res ) < read.data.size() )
+            {
+                // Short read. Read the rest of the file.
+                read.offset += static_cast<std::size_t>( cqe.res );
+                ring.queueRead( slot );
+                continue;
+            }
+
+            if ( cqe.res > 0 )
+            {
+                read.request.promise.set_value( std::move( read.data ) );
+            }
+            else
+            {
+                // The kernel may not support IORING_OP_READ (Linux < 5.6). Read the file on this thread instead.
+                read.request.promise.set_value( readFile( read.request.filePath ) );
+            }
+
+            close( read.fd );
+            read = {};
+            ring.freeSlots.push_back( slot );
+            --inFlight;
+        }
+
+        __atomic_store_n( ring.cqHead, head, __ATOMIC_RELEASE );
+    }
+#endif
+}
@@ -0,0 +1,70 @@
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/GenerateMipsBlitPipelineState.hpp>
+#include <WebGPUlib/GraphicsCommandBuffer.hpp>
+#include <WebGPUlib/ShaderReflection.hpp>
+
+using namespace WebGPUlib;
+
+GenerateMipsBlitPipelineState::GenerateMipsBlitPipelineState( WGPUTextureFormat format )
+{
+    // Load the shader module.
+    const char* shaderCode = {
+#include "../shaders/GenerateMipsBlit.wgsl"
+    };
+
+    WGPUShaderModule shaderModule = Device::get().getShaderModule( shaderCode, "Generate Mips Blit Shader Module" );
+
+    // The bind group layouts are derived from the shader code.
+    const ShaderReflection reflection { shaderCode };
+    WGPUPipelineLayout     pipelineLayout =
+        Device::get().getPipelineLayout( reflection, bindGroupLayouts, "Generate Mips Blit Pipeline Layout" );
+
+    WGPUPrimitiveState primitiveState {};
+    primitiveState.topology         = WGPUPrimitiveTopology_TriangleList;
+    primitiveState.stripIndexFormat = WGPUIndexFormat_Undefined;
+    primitiveState.frontFace        = WGPUFrontFace_CCW;
+    primitiveState.cullMode         = WGPUCullMode_None;
+
+    // Setup the vertex shader stage (the vertices are generated in the vertex shader).
+    WGPUVertexState vertexState {};
+    vertexState.module      = shaderModule;
+    vertexState.entryPoint  = "vs_main";
+    vertexState.bufferCount = 0;
+    vertexState.buffers     = nullptr;
+
+    WGPUColorTargetState colorTargetState {};
+    colorTargetState.format    = format;
+    colorTargetState.blend     = nullptr;
+    colorTargetState.writeMask = WGPUColorWriteMask_All;
+
+    // Setup the fragment shader stage.
+    WGPUFragmentState fragmentState {};
+    fragmentState.module      = shaderModule;
+    fragmentState.entryPoint  = "fs_main";
+    fragmentState.targetCount = 1;
+    fragmentState.targets     = &colorTargetState;
+
+    WGPUMultisampleState multisampleState {};
+    multisampleState.count                  = 1u;
+    multisampleState.mask                   = ~0u;
+    multisampleState.alphaToCoverageEnabled = false;
+
+    // Setup the pipeline state.
+    WGPURenderPipelineDescriptor pipelineDesc {};
+    pipelineDesc.label        = "Generate Mips Blit Pipeline";
+    pipelineDesc.layout       = pipelineLayout;
+    pipelineDesc.vertex       = vertexState;
+    pipelineDesc.primitive    = primitiveState;
+    pipelineDesc.depthStencil = nullptr;
+    pipelineDesc.multisample  = multisampleState;
+    pipelineDesc.fragment     = &fragmentState;
+    pipeline                  = Device::get().getRenderPipeline( pipelineDesc );
+}
+
+GenerateMipsBlitPipelineState::~GenerateMipsBlitPipelineState() = default;
+
+void GenerateMipsBlitPipelineState::bind( GraphicsCommandBuffer& commandBuffer )
+{
+    auto passEncoder = commandBuffer.getWGPUPassEncoder();
+    wgpuRenderPassEncoderSetPipeline( passEncoder, pipeline );
+}
@@ -2,73 +2,62 @@
 
 #include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/GenerateMipsPipelineState.hpp>
+#include <WebGPUlib/ShaderReflection.hpp>
+
+#include <cassert>
+#include <string>
 
 using namespace WebGPUlib;
 
-GenerateMipsPipelineState::GenerateMipsPipelineState()
+// Get the WGSL name of a storage texture format (or nullptr if the format cannot be used for storage textures).
+// 32-bit float formats are not included because they are not filterable without optional features.
+static const char* getStorageFormatName( WGPUTextureFormat format )
 {
-    // Load the shader module.
-    const char* shaderCode = {
-#include "../shaders/GenerateMips.wgsl"
-    };
-
-    auto device = Device::get().getWGPUDevice();
-
-    // Load the compute shader module.
-    WGPUShaderModuleWGSLDescriptor shaderCodeDesc {};
-    shaderCodeDesc.chain.next  = nullptr;
-    shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
-    shaderCodeDesc.code        = shaderCode;
+    switch ( format )
+    {
+    case WGPUTextureFormat_RGBA8Unorm:
+        return "rgba8unorm";
+    case WGPUTextureFormat_RGBA8Snorm:
+        return "rgba8snorm";
+    case WGPUTextureFormat_RGBA16Float:
+        return "rgba16float";
+    default:
+        return nullptr;
+    }
+}
 
-    WGPUShaderModuleDescriptor shaderModuleDesc {};
-    shaderModuleDesc.nextInChain  = &shaderCodeDesc.chain;
-    shaderModuleDesc.label        = "Generate Mips Shader Module";
-    WGPUShaderModule shaderModule = wgpuDeviceCreateShaderModule( device, &shaderModuleDesc );
+bool GenerateMipsPipelineState::isStorageFormat( WGPUTextureFormat format )
+{
+    return getStorageFormatName( format ) != nullptr;
+}
 
-    // Setup the binding layout for the generate mips compute shader.
-    //@group(0) @binding(0) var<uniform> mip : Mip;
-    //@group(0) @binding(1) var srcMip : texture_2d<f32>;
-    //@group(0) @binding(2) var dstMip1 : texture_storage_2d<rgba8unorm, write>;
-    //@group(0) @binding(3) var dstMip2 : texture_storage_2d<rgba8unorm, write>;
-    //@group(0) @binding(4) var dstMip3 : texture_storage_2d<rgba8unorm, write>;
-    //@group(0) @binding(5) var dstMip4 : texture_storage_2d<rgba8unorm, write>;
-    //@group(0) @binding(6) var linearClampSampler : sampler;
-    WGPUBindGroupLayoutEntry bindGroupLayoutEntries[7] {};
-    bindGroupLayoutEntries[0].binding               = 0;
-    bindGroupLayoutEntries[0].visibility            = WGPUShaderStage_Compute;
-    bindGroupLayoutEntries[0].buffer.type           = WGPUBufferBindingType_Uniform;
-    bindGroupLayoutEntries[0].buffer.minBindingSize = sizeof( Mip );
+GenerateMipsPipelineState::GenerateMipsPipelineState( WGPUTextureFormat format )
+{
+    assert( isStorageFormat( format ) );
 
-    bindGroupLayoutEntries[1].binding               = 1;
-    bindGroupLayoutEntries[1].visibility            = WGPUShaderStage_Compute;
-    bindGroupLayoutEntries[1].texture.sampleType    = WGPUTextureSampleType_Float;
-    bindGroupLayoutEntries[1].texture.viewDimension = WGPUTextureViewDimension_2D;
+    // Load the shader module.
+    std::string shaderCode = {
+#include "../shaders/GenerateMips.wgsl"
+    };
 
-    for ( int i = 2; i <= 5; ++i )
+    // The shader is written for rgba8unorm. Replace the format of the storage textures.
+    const std::string formatName = getStorageFormatName( format );
+    std::size_t       pos        = shaderCode.find( "rgba8unorm" );
+    while ( pos != std::string::npos )
     {
-        bindGroupLayoutEntries[i].binding                      = i;
-        bindGroupLayoutEntries[i].visibility                   = WGPUShaderStage_Compute;
-        bindGroupLayoutEntries[i].storageTexture.access        = WGPUStorageTextureAccess_WriteOnly;
-        bindGroupLayoutEntries[i].storageTexture.format        = WGPUTextureFormat_RGBA8Unorm;
-        bindGroupLayoutEntries[i].storageTexture.viewDimension = WGPUTextureViewDimension_2D;
+        shaderCode.replace( pos, 10, formatName );
+        pos = shaderCode.find( "rgba8unorm", pos + formatName.size() );
     }
 
-    bindGroupLayoutEntries[6].binding      = 6;
-    bindGroupLayoutEntries[6].visibility   = WGPUShaderStage_Compute;
-    bindGroupLayoutEntries[6].sampler.type = WGPUSamplerBindingType_Filtering;
-
-    WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc {};
-    bindGroupLayoutDesc.label      = "Generate Mips Bind Group Layout";
-    bindGroupLayoutDesc.entryCount = std::size( bindGroupLayoutEntries );
-    bindGroupLayoutDesc.entries    = bindGroupLayoutEntries;
-    bindGroupLayout                = wgpuDeviceCreateBindGroupLayout( device, &bindGroupLayoutDesc );
+    // Load the compute shader module.
+    // The shader modules are cached by their code, so each storage format is only compiled once.
+    WGPUShaderModule shaderModule =
+        Device::get().getShaderModule( shaderCode.c_str(), "Generate Mips Shader Module" );
 
-    // Setup the pipeline layout.
-    WGPUPipelineLayoutDescriptor pipelineLayoutDesc {};
-    pipelineLayoutDesc.label                = "Generate Mips Pipeline Layout";
-    pipelineLayoutDesc.bindGroupLayoutCount = 1;
-    pipelineLayoutDesc.bindGroupLayouts     = &bindGroupLayout;
-    WGPUPipelineLayout pipelineLayout       = wgpuDeviceCreatePipelineLayout( device, &pipelineLayoutDesc );
+    // The bind group layouts are derived from the shader code.
+    const ShaderReflection reflection { shaderCode };
+    WGPUPipelineLayout     pipelineLayout =
+        Device::get().getPipelineLayout( reflection, bindGroupLayouts, "Generate Mips Pipeline Layout" );
 
     // Setup the pipeline state.
     WGPUComputePipelineDescriptor pipelineDesc {};
@@ -76,19 +65,10 @@ GenerateMipsPipelineState::GenerateMipsPipelineState()
     pipelineDesc.layout             = pipelineLayout;
     pipelineDesc.compute.module     = shaderModule;
     pipelineDesc.compute.entryPoint = "main";
-    pipeline                        = wgpuDeviceCreateComputePipeline( device, &pipelineDesc );
-
-    // We are done with the shader module.
-    wgpuShaderModuleRelease( shaderModule );
-    // We are done with the pipeline layout.
-    wgpuPipelineLayoutRelease( pipelineLayout );
+    pipeline                        = Device::get().getComputePipeline( pipelineDesc );
 }
 
-GenerateMipsPipelineState::~GenerateMipsPipelineState()
-{
-    if ( bindGroupLayout )
-        wgpuBindGroupLayoutRelease( bindGroupLayout );
-}
+GenerateMipsPipelineState::~GenerateMipsPipelineState() = default;
 
 void GenerateMipsPipelineState::bind( ComputeCommandBuffer& commandBuffer )
 {
@@ -0,0 +1,39 @@
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/GenerateMipsSinglePassPipelineState.hpp>
+#include <WebGPUlib/ShaderReflection.hpp>
+
+using namespace WebGPUlib;
+
+GenerateMipsSinglePassPipelineState::GenerateMipsSinglePassPipelineState()
+{
+    // Load the shader module.
+    const char* shaderCode = {
+#include "../shaders/GenerateMipsSinglePass.wgsl"
+    };
+
+    // Load the compute shader module.
+    WGPUShaderModule shaderModule =
+        Device::get().getShaderModule( shaderCode, "Generate Mips Single Pass Shader Module" );
+
+    // The bind group layouts are derived from the shader code.
+    const ShaderReflection reflection { shaderCode };
+    WGPUPipelineLayout     pipelineLayout = Device::get().getPipelineLayout(
+        reflection, bindGroupLayouts, "Generate Mips Single Pass Pipeline Layout" );
+
+    // Setup the pipeline state.
+    WGPUComputePipelineDescriptor pipelineDesc {};
+    pipelineDesc.label              = "Generate Mips Single Pass Pipeline";
+    pipelineDesc.layout             = pipelineLayout;
+    pipelineDesc.compute.module     = shaderModule;
+    pipelineDesc.compute.entryPoint = "main";
+    pipeline                        = Device::get().getComputePipeline( pipelineDesc );
+}
+
+GenerateMipsSinglePassPipelineState::~GenerateMipsSinglePassPipelineState() = default;
+
+void GenerateMipsSinglePassPipelineState::bind( ComputeCommandBuffer& commandBuffer )
+{
+    auto passEncoder = commandBuffer.getWGPUPassEncoder();
+    wgpuComputePassEncoderSetPipeline( passEncoder, pipeline );
+}
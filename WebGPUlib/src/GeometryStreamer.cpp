@@ -0,0 +1,596 @@
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/GeometryStreamer.hpp>
+#include <WebGPUlib/Hash.hpp>
+#include <WebGPUlib/Helpers.hpp>
+#include <WebGPUlib/IndexBuffer.hpp>
+#include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/StorageBuffer.hpp>
+#include <WebGPUlib/ThreadPool.hpp>
+#include <WebGPUlib/VertexBuffer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+using namespace WebGPUlib;
+
+// The alignment of the allocations in the arenas.
+constexpr uint64_t ArenaAlignment = 256;
+
+// The geometry file starts with a header. Increment the version if the layout of the file changes.
+constexpr uint32_t GeometryFileMagic   = 0x47504757;  // "WGPG"
+constexpr uint32_t GeometryFileVersion = 2;
+
+struct GeometryFileHeader
+{
+    uint32_t magic   = GeometryFileMagic;
+    uint32_t version = GeometryFileVersion;
+};
+
+static bool isValidHeader( const GeometryFileHeader& header )
+{
+    return header.magic == GeometryFileMagic && header.version == GeometryFileVersion;
+}
+
+// Hash the vertices and indices of a mesh. The hash is stored in the geometry file (see hashBytes).
+static uint64_t hashGeometry( const void* vertexData, std::size_t vertexDataSize, const void* indexData,
+                              std::size_t indexDataSize )
+{
+    return hashBytes( indexData, indexDataSize, hashBytes( vertexData, vertexDataSize ) );
+}
+
+// Read an index of a 16-bit or 32-bit index buffer.
+static uint32_t readIndex( const uint8_t* indexData, std::size_t indexStride, std::size_t i )
+{
+    if ( indexStride == 2 )
+    {
+        uint16_t index;
+        std::memcpy( &index, indexData + i * 2, sizeof( index ) );
+        return index;
+    }
+
+    uint32_t index;
+    std::memcpy( &index, indexData + i * 4, sizeof( index ) );
+    return index;
+}
+
+static void writeIndex( uint8_t* indexData, std::size_t indexStride, std::size_t i, uint32_t index )
+{
+    if ( indexStride == 2 )
+    {
+        const auto index16 = static_cast<uint16_t>( index );
+        std::memcpy( indexData + i * 2, &index16, sizeof( index16 ) );
+    }
+    else
+    {
+        std::memcpy( indexData + i * 4, &index, sizeof( index ) );
+    }
+}
+
+GeometryStreamer::GeometryStreamer( const std::filesystem::path& _filePath, uint64_t _budget, uint64_t _arenaSize )
+: filePath { _filePath }
+, budget { _budget }
+, arenaSize { AlignUp( _arenaSize, ArenaAlignment ) }
+{
+    // A geometry file that is stored uncompressed in a mounted archive is read from the mapped archive.
+    std::size_t mappedSize = 0;
+    if ( const uint8_t* mappedData = Device::get().getMappedFile( filePath, mappedSize ) )
+    {
+        GeometryFileHeader header {};
+        if ( mappedSize >= sizeof( header ) )
+            std::memcpy( &header, mappedData, sizeof( header ) );
+
+        if ( mappedSize >= sizeof( header ) && isValidHeader( header ) )
+        {
+            archiveData = mappedData;
+            fileSize    = sizeof( header );
+            storedSize  = mappedSize;
+            return;
+        }
+    }
+
+    openFile();
+}
+
+void GeometryStreamer::openFile()
+{
+    // Reuse the existing geometry file if it has a valid header.
+    GeometryFileHeader header {};
+    file.open( filePath, std::ios::binary | std::ios::in | std::ios::out );
+    if ( file )
+        file.read( reinterpret_cast<char*>( &header ), sizeof( header ) );
+
+    if ( file && isValidHeader( header ) )
+    {
+        file.seekg( 0, std::ios::end );
+        fileSize   = sizeof( header );
+        storedSize = static_cast<uint64_t>( file.tellg() );
+        return;
+    }
+
+    file.close();
+    file.clear();
+    file.open( filePath, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc );
+
+    header = {};
+    file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    file.flush();
+
+    fileSize   = sizeof( header );
+    storedSize = sizeof( header );
+
+    if ( !file )
+        std::cerr << "ERROR: Failed to create geometry file: " << filePath << std::endl;
+}
+
+bool GeometryStreamer::isStored( const GeometryRecord& record )
+{
+    if ( fileSize + sizeof( record ) + record.vertexDataSize + record.indexDataSize > storedSize )
+        return false;
+
+    GeometryRecord storedRecord {};
+    if ( archiveData )
+    {
+        std::memcpy( &storedRecord, archiveData + fileSize, sizeof( storedRecord ) );
+    }
+    else
+    {
+        file.seekg( static_cast<std::streamoff>( fileSize ) );
+        file.read( reinterpret_cast<char*>( &storedRecord ), sizeof( storedRecord ) );
+        if ( !file )
+        {
+            file.clear();
+            return false;
+        }
+    }
+
+    return storedRecord.hash == record.hash && storedRecord.vertexDataSize == record.vertexDataSize &&
+           storedRecord.indexDataSize == record.indexDataSize;
+}
+
+bool GeometryStreamer::write( const GeometryRecord& record, const void* vertexData, const void* indexData )
+{
+    if ( archiveData )
+    {
+        // The archived geometry is stale. Continue in a geometry file on disk that starts with the archived
+        // geometry that matched the meshes that have been added so far.
+        file.open( filePath, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc );
+        file.write( reinterpret_cast<const char*>( archiveData ), static_cast<std::streamsize>( fileSize ) );
+        archiveData = nullptr;
+    }
+    else if ( storedSize > fileSize )
+    {
+        // Discard the stale geometry after the meshes that matched.
+        file.close();
+        std::error_code error;
+        std::filesystem::resize_file( filePath, fileSize, error );
+        file.open( filePath, std::ios::binary | std::ios::in | std::ios::out );
+    }
+
+    // Append the record, the vertices and the indices. The file is flushed so the worker threads can read it.
+    file.seekp( static_cast<std::streamoff>( fileSize ) );
+    file.write( reinterpret_cast<const char*>( &record ), sizeof( record ) );
+    file.write( static_cast<const char*>( vertexData ), static_cast<std::streamsize>( record.vertexDataSize ) );
+    file.write( static_cast<const char*>( indexData ), static_cast<std::streamsize>( record.indexDataSize ) );
+    file.flush();
+
+    if ( !file )
+    {
+        std::cerr << "ERROR: Failed to write geometry file: " << filePath << std::endl;
+        file.clear();
+        storedSize = fileSize;
+        return false;
+    }
+
+    storedSize = fileSize + sizeof( record ) + record.vertexDataSize + record.indexDataSize;
+
+    return true;
+}
+
+GeometryStreamer::~GeometryStreamer()
+{
+    // Wait for the loads that are still running on the worker threads.
+    for ( auto& streamedMesh: meshes )
+    {
+        if ( streamedMesh.pendingLoad.valid() )
+            streamedMesh.pendingLoad.wait();
+    }
+
+    // The buffers of the resident meshes keep their own reference to the arenas.
+    for ( auto& arena: arenas )
+        wgpuBufferRelease( arena.buffer );
+}
+
+bool GeometryStreamer::addMesh( const std::shared_ptr<Mesh>& mesh, const void* vertexData, std::size_t vertexCount,
+                                std::size_t vertexStride, const void* indexData, std::size_t indexCount,
+                                std::size_t indexStride )
+{
+    StreamedMesh streamedMesh;
+    streamedMesh.vertexCount  = vertexCount;
+    streamedMesh.vertexStride = vertexStride;
+    streamedMesh.indexCount   = indexCount;
+    streamedMesh.indexStride  = indexStride;
+
+    // A mesh without a coarser level of detail has no proxy, so it is not streamed (it stays resident).
+    if ( ( !file && !archiveData ) || indexCount == 0 || mesh->getLODs().size() < 2 ||
+         getAllocationSize( streamedMesh ) > arenaSize )
+        return false;
+
+    // Reuse the geometry in the geometry file if it matches the mesh. Otherwise the geometry is written to the file.
+    const std::size_t vertexDataSize = vertexCount * vertexStride;
+    const std::size_t indexDataSize  = indexCount * indexStride;
+
+    const GeometryRecord record { hashGeometry( vertexData, vertexDataSize, indexData, indexDataSize ),
+                                  vertexDataSize, indexDataSize };
+    if ( !isStored( record ) && !write( record, vertexData, indexData ) )
+        return false;
+
+    streamedMesh.mesh       = mesh;
+    streamedMesh.fileOffset = fileSize + sizeof( record );
+    fileSize += sizeof( record ) + vertexDataSize + indexDataSize;
+
+    streamedMesh.lods               = mesh->getLODs();
+    streamedMesh.meshletBuffer      = mesh->getMeshletBuffer();
+    streamedMesh.meshletIndexBuffer = mesh->getMeshletIndexBuffer();
+
+    // Create the proxy from the lowest level of detail. Only the vertices that are referenced by the LOD are kept.
+    const MeshLOD& lod         = streamedMesh.lods.back();
+    const auto*    vertices    = static_cast<const uint8_t*>( vertexData );
+    const auto*    indices     = static_cast<const uint8_t*>( indexData );
+    std::size_t    numVertices = 0;
+
+    std::vector<uint32_t> remap( vertexCount, UINT32_MAX );
+    std::vector<uint8_t>  proxyVertices;
+    std::vector<uint8_t>  proxyIndices( lod.indexCount * indexStride );
+
+    for ( std::size_t i = 0; i < lod.indexCount; ++i )
+    {
+        uint32_t index = readIndex( indices, indexStride, lod.firstIndex + i );
+        if ( remap[index] == UINT32_MAX )
+        {
+            remap[index] = static_cast<uint32_t>( numVertices++ );
+            proxyVertices.insert( proxyVertices.end(), vertices + index * vertexStride,
+                                  vertices + ( index + 1 ) * vertexStride );
+        }
+
+        writeIndex( proxyIndices.data(), indexStride, i, remap[index] );
+    }
+
+    auto& device = Device::get();
+
+    streamedMesh.proxyVertexBuffer = device.createVertexBuffer( proxyVertices.data(), numVertices, vertexStride );
+    streamedMesh.proxyIndexBuffer  = device.createIndexBuffer( proxyIndices.data(), lod.indexCount, indexStride );
+    streamedMesh.proxyLODs         = { { 0, lod.indexCount, lod.error } };
+
+    proxySize += streamedMesh.proxyVertexBuffer->getSize() + streamedMesh.proxyIndexBuffer->getSize();
+
+    meshIndices[mesh.get()] = meshes.size();
+    meshes.push_back( std::move( streamedMesh ) );
+
+    evict( meshes.back() );
+
+    return true;
+}
+
+void GeometryStreamer::request( const Mesh& mesh, float distance )
+{
+    auto iter = meshIndices.find( &mesh );
+    if ( iter == meshIndices.end() )
+        return;
+
+    auto& streamedMesh = meshes[iter->second];
+
+    // Keep the distance of the closest instance in this frame.
+    if ( streamedMesh.lastUsedFrame == frame )
+        streamedMesh.distance = std::min( streamedMesh.distance, distance );
+    else
+        streamedMesh.distance = distance;
+
+    streamedMesh.lastUsedFrame = frame;
+}
+
+bool GeometryStreamer::isResident( const Mesh& mesh ) const
+{
+    auto iter = meshIndices.find( &mesh );
+    if ( iter == meshIndices.end() )
+        return true;
+
+    return meshes[iter->second].resident;
+}
+
+void GeometryStreamer::update()
+{
+    auto& device = Device::get();
+    auto  queue  = device.getQueue();
+
+    // Upload the meshes that have been loaded and swap their buffers.
+    for ( auto& streamedMesh: meshes )
+    {
+        if ( streamedMesh.pendingLoad.valid() &&
+             streamedMesh.pendingLoad.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready )
+        {
+            // The allocation is gone if its arena was released while the mesh was loading (see setBudget).
+            std::vector<uint8_t> data = streamedMesh.pendingLoad.get();
+            if ( data.empty() || streamedMesh.mesh.expired() || streamedMesh.allocation.arena == UINT32_MAX )
+            {
+                deallocate( streamedMesh.allocation );
+                continue;
+            }
+
+            const auto& allocation = streamedMesh.allocation;
+            queue->writeBuffer( arenas[allocation.arena].buffer, data.data(), data.size(), allocation.offset );
+
+            makeResident( streamedMesh );
+        }
+    }
+
+    // Evict the meshes that were not requested recently (or that are no longer used).
+    for ( auto& streamedMesh: meshes )
+    {
+        if ( streamedMesh.resident &&
+             ( streamedMesh.lastUsedFrame + evictFrames < frame || streamedMesh.mesh.expired() ) )
+            evict( streamedMesh );
+    }
+
+    // Load the meshes that were requested in this frame (the closest meshes first).
+    uint32_t                 numPendingLoads = 0;
+    std::vector<std::size_t> requested;
+    for ( std::size_t i = 0; i < meshes.size(); ++i )
+    {
+        const auto& streamedMesh = meshes[i];
+        if ( streamedMesh.pendingLoad.valid() )
+            ++numPendingLoads;
+        else if ( !streamedMesh.resident && streamedMesh.lastUsedFrame == frame )
+            requested.push_back( i );
+    }
+
+    std::sort( requested.begin(), requested.end(),
+               [&]( std::size_t a, std::size_t b ) { return meshes[a].distance < meshes[b].distance; } );
+
+    // The resident meshes that may be evicted to make room for the requested meshes
+    // (the least recently used and most distant meshes first).
+    std::vector<std::size_t> evictable;
+    for ( std::size_t i = 0; i < meshes.size(); ++i )
+    {
+        if ( meshes[i].resident )
+            evictable.push_back( i );
+    }
+
+    std::sort( evictable.begin(), evictable.end(), [&]( std::size_t a, std::size_t b ) {
+        if ( meshes[a].lastUsedFrame != meshes[b].lastUsedFrame )
+            return meshes[a].lastUsedFrame < meshes[b].lastUsedFrame;
+
+        return meshes[a].distance > meshes[b].distance;
+    } );
+
+    auto& threadPool  = device.getThreadPool();
+    auto  nextEvicted = evictable.begin();
+
+    for ( auto i: requested )
+    {
+        if ( numPendingLoads >= maxPendingLoads )
+            break;
+
+        auto&          streamedMesh = meshes[i];
+        const uint64_t size         = getAllocationSize( streamedMesh );
+
+        // Only meshes that are not used in this frame or that are further away than this mesh are evicted.
+        bool allocated = allocate( size, streamedMesh.allocation );
+        while ( !allocated && nextEvicted != evictable.end() )
+        {
+            auto& evicted = meshes[*nextEvicted];
+            if ( evicted.lastUsedFrame == frame && evicted.distance <= streamedMesh.distance )
+                break;
+
+            if ( evicted.resident )
+                evict( evicted );
+
+            ++nextEvicted;
+            allocated = allocate( size, streamedMesh.allocation );
+        }
+
+        // Stop if the budget is exhausted by closer meshes.
+        if ( !allocated )
+            break;
+
+        const uint64_t vertexDataSize = getVertexDataSize( streamedMesh );
+
+        streamedMesh.pendingLoad =
+            threadPool.submit( [filePath = filePath, archiveData = archiveData, fileOffset = streamedMesh.fileOffset,
+                                vertexDataSize, size,
+                                vertexSize = streamedMesh.vertexCount * streamedMesh.vertexStride,
+                                indexSize  = streamedMesh.indexCount * streamedMesh.indexStride] {
+                // The vertices and indices are read into the layout of the allocation.
+                std::vector<uint8_t> data( size, 0 );
+
+                if ( archiveData )
+                {
+                    std::memcpy( data.data(), archiveData + fileOffset, vertexSize );
+                    std::memcpy( data.data() + vertexDataSize, archiveData + fileOffset + vertexSize, indexSize );
+                    return data;
+                }
+
+                std::ifstream file( filePath, std::ios::binary );
+                file.seekg( static_cast<std::streamoff>( fileOffset ) );
+                file.read( reinterpret_cast<char*>( data.data() ), static_cast<std::streamsize>( vertexSize ) );
+                file.read( reinterpret_cast<char*>( data.data() + vertexDataSize ),
+                           static_cast<std::streamsize>( indexSize ) );
+
+                if ( !file )
+                {
+                    std::cerr << "ERROR: Failed to read geometry file: " << filePath << std::endl;
+                    return std::vector<uint8_t> {};
+                }
+
+                return data;
+            } );
+
+        ++numPendingLoads;
+    }
+
+    ++frame;
+}
+
+void GeometryStreamer::setBudget( uint64_t _budget )
+{
+    budget = _budget;
+
+    // Release the last arenas until the arenas fit in the budget.
+    while ( !arenas.empty() && arenas.size() * arenaSize > budget )
+    {
+        const auto arena = static_cast<uint32_t>( arenas.size() - 1 );
+        for ( auto& streamedMesh: meshes )
+        {
+            if ( streamedMesh.allocation.arena != arena )
+                continue;
+
+            // A mesh that is still loading is discarded when its load completes (see update).
+            if ( streamedMesh.resident )
+                evict( streamedMesh );
+            else
+                deallocate( streamedMesh.allocation );
+        }
+
+        // The buffers of the evicted meshes may still be used by the submitted draws and keep their own reference.
+        wgpuBufferRelease( arenas.back().buffer );
+        arenas.pop_back();
+
+        std::cout << "INFO: Released geometry arena " << arena + 1 << "." << std::endl;
+    }
+}
+
+uint64_t GeometryStreamer::getVertexDataSize( const StreamedMesh& mesh )
+{
+    return AlignUp( mesh.vertexCount * mesh.vertexStride, 4 );
+}
+
+uint64_t GeometryStreamer::getAllocationSize( const StreamedMesh& mesh )
+{
+    return AlignUp( getVertexDataSize( mesh ) + AlignUp( mesh.indexCount * mesh.indexStride, 4 ), ArenaAlignment );
+}
+
+bool GeometryStreamer::allocate( uint64_t size, Allocation& allocation )
+{
+    auto allocateFromArena = [&]( uint32_t a ) {
+        auto& freeRanges = arenas[a].freeRanges;
+
+        // First fit.
+        for ( auto iter = freeRanges.begin(); iter != freeRanges.end(); ++iter )
+        {
+            auto [offset, rangeSize] = *iter;
+            if ( rangeSize < size )
+                continue;
+
+            freeRanges.erase( iter );
+            if ( rangeSize > size )
+                freeRanges.emplace( offset + size, rangeSize - size );
+
+            allocation = { a, offset, size };
+            residentSize += size;
+
+            return true;
+        }
+
+        return false;
+    };
+
+    for ( uint32_t a = 0; a < arenas.size(); ++a )
+    {
+        if ( allocateFromArena( a ) )
+            return true;
+    }
+
+    // Create a new arena if it fits in the budget.
+    if ( size > arenaSize || ( arenas.size() + 1 ) * arenaSize > budget )
+        return false;
+
+    WGPUBufferDescriptor bufferDesc {};
+    bufferDesc.label = "Geometry Arena";
+    bufferDesc.size  = arenaSize;
+    bufferDesc.usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_Index | WGPUBufferUsage_CopyDst;
+
+    Arena arena;
+    arena.buffer = wgpuDeviceCreateBuffer( Device::get().getWGPUDevice(), &bufferDesc );
+    arena.freeRanges.emplace( 0, arenaSize );
+
+    arenas.push_back( std::move( arena ) );
+
+    std::cout << "INFO: Created geometry arena " << arenas.size() << " (" << arenaSize / ( 1024 * 1024 ) << " MB)."
+              << std::endl;
+
+    return allocateFromArena( static_cast<uint32_t>( arenas.size() - 1 ) );
+}
+
+void GeometryStreamer::deallocate( Allocation& allocation )
+{
+    if ( allocation.arena == UINT32_MAX )
+        return;
+
+    auto& freeRanges = arenas[allocation.arena].freeRanges;
+
+    uint64_t offset = allocation.offset;
+    uint64_t size   = allocation.size;
+
+    // Merge the range with the adjacent free ranges.
+    auto next = freeRanges.lower_bound( offset );
+    if ( next != freeRanges.end() && offset + size == next->first )
+    {
+        size += next->second;
+        next = freeRanges.erase( next );
+    }
+    if ( next != freeRanges.begin() )
+    {
+        auto prev = std::prev( next );
+        if ( prev->first + prev->second == offset )
+        {
+            offset = prev->first;
+            size += prev->second;
+            freeRanges.erase( prev );
+        }
+    }
+
+    freeRanges.emplace( offset, size );
+
+    residentSize -= allocation.size;
+    allocation = {};
+}
+
+void GeometryStreamer::makeResident( StreamedMesh& streamedMesh )
+{
+    auto mesh = streamedMesh.mesh.lock();
+    if ( !mesh )
+        return;
+
+    auto&       device     = Device::get();
+    const auto& allocation = streamedMesh.allocation;
+    WGPUBuffer  buffer     = arenas[allocation.arena].buffer;
+
+    mesh->setVertexBuffer( 0, device.createVertexBufferRange( buffer, allocation.offset, streamedMesh.vertexCount,
+                                                              streamedMesh.vertexStride ) );
+    mesh->setIndexBuffer( device.createIndexBufferRange( buffer, allocation.offset + getVertexDataSize( streamedMesh ),
+                                                         streamedMesh.indexCount, streamedMesh.indexStride ) );
+    mesh->setLODs( streamedMesh.lods );
+    mesh->setMeshlets( streamedMesh.meshletBuffer, streamedMesh.meshletIndexBuffer );
+
+    streamedMesh.resident = true;
+}
+
+void GeometryStreamer::evict( StreamedMesh& streamedMesh )
+{
+    // The arena range can be reused right away: writes to the arena are ordered after the draws
+    // that have already been submitted to the queue.
+    deallocate( streamedMesh.allocation );
+    streamedMesh.resident = false;
+
+    auto mesh = streamedMesh.mesh.lock();
+    if ( !mesh )
+        return;
+
+    // The meshlets reference the vertices of the full geometry, so they can't be used with the proxy.
+    mesh->setVertexBuffer( 0, streamedMesh.proxyVertexBuffer );
+    mesh->setIndexBuffer( streamedMesh.proxyIndexBuffer );
+    mesh->setLODs( streamedMesh.proxyLODs );
+    mesh->setMeshlets( nullptr, nullptr );
+}
@@ -5,6 +5,7 @@
 #include <WebGPUlib/Mesh.hpp>
 #include <WebGPUlib/VertexBuffer.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <utility>
 
@@ -23,13 +24,15 @@ GraphicsCommandBuffer::~GraphicsCommandBuffer()
         wgpuRenderPassEncoderRelease( passEncoder );
 }
 
-void GraphicsCommandBuffer::setBindGroup( uint32_t groupIndex, const BindGroup& _bindGroup )
+void GraphicsCommandBuffer::setBindGroup( uint32_t groupIndex, const BindGroup& _bindGroup,
+                                          const std::vector<uint32_t>& dynamicOffsets )
 {
     if ( currentPipelineState )
     {
         auto bindGroupLayout = currentPipelineState->getWGPUBindGroupLayout( groupIndex );
         auto bindGroup       = _bindGroup.getWGPUBindGroup( bindGroupLayout );
-        wgpuRenderPassEncoderSetBindGroup( passEncoder, groupIndex, bindGroup, 0, nullptr );
+        wgpuRenderPassEncoderSetBindGroup( passEncoder, groupIndex, bindGroup, dynamicOffsets.size(),
+                                           dynamicOffsets.data() );
     }
     else
     {
@@ -44,11 +47,21 @@ void GraphicsCommandBuffer::setGraphicsPipeline( GraphicsPipelineState& pipeline
     // Keep track of the currently bound pipeline state.
     currentPipelineState = &pipeline;
 
-    pipeline.bind( *this );
+    // The draws are skipped until the pipeline is ready (see isPipelineReady).
+    if ( pipeline.isReady() )
+        pipeline.bind( *this );
 }
 
-void GraphicsCommandBuffer::draw( const Mesh& mesh )
+bool GraphicsCommandBuffer::isPipelineReady() const
 {
+    return !currentPipelineState || currentPipelineState->isReady();
+}
+
+void GraphicsCommandBuffer::draw( const Mesh& mesh, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod )
+{
+    if ( !isPipelineReady() )
+        return;
+
     commitBindGroups();
 
     auto vertexBuffers = mesh.getVertexBuffers();
@@ -58,8 +71,8 @@ void GraphicsCommandBuffer::draw( const Mesh& mesh )
     {
         if ( auto& vertexBuffer = vertexBuffers[i] )
         {
-            wgpuRenderPassEncoderSetVertexBuffer( passEncoder, i, vertexBuffer->getWGPUBuffer(), 0,
-                                                  vertexBuffer->getSize() );
+            wgpuRenderPassEncoderSetVertexBuffer( passEncoder, i, vertexBuffer->getWGPUBuffer(),
+                                                  vertexBuffer->getOffset(), vertexBuffer->getSize() );
         }
     }
 
@@ -76,20 +89,66 @@ void GraphicsCommandBuffer::draw( const Mesh& mesh )
             break;
         }
 
-        wgpuRenderPassEncoderSetIndexBuffer( passEncoder, indexBuffer->getWGPUBuffer(), indexFormat, 0,
-                                             indexBuffer->getSize() );
-        wgpuRenderPassEncoderDrawIndexed( passEncoder, static_cast<uint32_t>( indexBuffer->getIndexCount() ), 1, 0, 0,
-                                          0 );
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = static_cast<uint32_t>( indexBuffer->getIndexCount() );
+
+        const auto& lods = mesh.getLODs();
+        if ( !lods.empty() )
+        {
+            const MeshLOD& meshLOD = lods[std::min<std::size_t>( lod, lods.size() - 1 )];
+            firstIndex             = meshLOD.firstIndex;
+            indexCount             = meshLOD.indexCount;
+        }
+
+        wgpuRenderPassEncoderSetIndexBuffer( passEncoder, indexBuffer->getWGPUBuffer(), indexFormat,
+                                             indexBuffer->getOffset(), indexBuffer->getSize() );
+        wgpuRenderPassEncoderDrawIndexed( passEncoder, indexCount, instanceCount, firstIndex, 0, firstInstance );
     }
     else
     {
         if ( auto& vertexBuffer = vertexBuffers[0] )
         {
-            wgpuRenderPassEncoderDraw( passEncoder, static_cast<uint32_t>( vertexBuffer->getVertexCount() ), 1, 0, 0 );
+            wgpuRenderPassEncoderDraw( passEncoder, static_cast<uint32_t>( vertexBuffer->getVertexCount() ),
+                                       instanceCount, 0, firstInstance );
         }
     }
 }
 
+void GraphicsCommandBuffer::draw( uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex,
+                                  uint32_t firstInstance )
+{
+    if ( !isPipelineReady() )
+        return;
+
+    commitBindGroups();
+
+    wgpuRenderPassEncoderDraw( passEncoder, vertexCount, instanceCount, firstVertex, firstInstance );
+}
+
+void GraphicsCommandBuffer::drawIndexedIndirect( const Mesh& mesh, const IndexBuffer& indexBuffer,
+                                                 const Buffer& indirectBuffer, uint64_t indirectOffset )
+{
+    if ( !isPipelineReady() )
+        return;
+
+    commitBindGroups();
+
+    auto vertexBuffers = mesh.getVertexBuffers();
+
+    for ( uint32_t i = 0; i < vertexBuffers.size(); ++i )
+    {
+        if ( auto& vertexBuffer = vertexBuffers[i] )
+        {
+            wgpuRenderPassEncoderSetVertexBuffer( passEncoder, i, vertexBuffer->getWGPUBuffer(),
+                                                  vertexBuffer->getOffset(), vertexBuffer->getSize() );
+        }
+    }
+
+    wgpuRenderPassEncoderSetIndexBuffer( passEncoder, indexBuffer.getWGPUBuffer(), indexBuffer.getIndexFormat(),
+                                         indexBuffer.getOffset(), indexBuffer.getSize() );
+    wgpuRenderPassEncoderDrawIndexedIndirect( passEncoder, indirectBuffer.getWGPUBuffer(), indirectOffset );
+}
+
 WGPUCommandBuffer GraphicsCommandBuffer::finish()
 {
     wgpuRenderPassEncoderEnd( passEncoder );
@@ -1,9 +1,16 @@
+#include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/GraphicsPipelineState.hpp>
 
 using namespace WebGPUlib;
 
-GraphicsPipelineState::~GraphicsPipelineState()
+// The pipeline is owned by the device.
+GraphicsPipelineState::~GraphicsPipelineState() = default;
+
+bool GraphicsPipelineState::isReady()
 {
-    if (pipeline)
-        wgpuRenderPipelineRelease(pipeline);
+    // Look up the pipeline that is created in the background until it is ready.
+    if ( !pipeline && !pipelineKey.empty() )
+        pipeline = Device::get().findRenderPipeline( pipelineKey );
+
+    return pipeline != nullptr;
 }
\ No newline at end of file
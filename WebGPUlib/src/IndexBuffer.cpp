@@ -4,8 +4,9 @@
 
 using namespace WebGPUlib;
 
-IndexBuffer::IndexBuffer( WGPUBuffer&& _buffer, std::size_t _indexCount, std::size_t _indexStride )
-: Buffer( std::move( _buffer ) )  // NOLINT(performance-move-const-arg)
+IndexBuffer::IndexBuffer( WGPUBuffer&& _buffer, std::size_t _indexCount, std::size_t _indexStride,
+                          std::size_t _offset )
+: Buffer( std::move( _buffer ), _offset )  // NOLINT(performance-move-const-arg)
 , indexCount( _indexCount )
 , indexStride( _indexStride )
 {}
\ No newline at end of file
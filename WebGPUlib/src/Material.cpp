@@ -1,12 +1,33 @@
+#include <WebGPUlib/BindGroup.hpp>
+#include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/Material.hpp>
+#include <WebGPUlib/MaterialTable.hpp>
+#include <WebGPUlib/Sampler.hpp>
+#include <WebGPUlib/StorageBuffer.hpp>
+#include <WebGPUlib/Texture.hpp>
+#include <WebGPUlib/TextureView.hpp>
+
+#include <iostream>
 #include <utility>
+#include <vector>
 
 using namespace WebGPUlib;
 
+struct MakeBindGroup : BindGroup
+{
+    MakeBindGroup() = default;
+};
+
 Material::Material( const MaterialProperties& properties )
 : properties { std::make_unique<MaterialProperties>( properties ) } // Is this aligned?
 {}
 
+Material::~Material()
+{
+    if ( table )
+        table->remove( *this );
+}
+
 const glm::vec4& Material::getDiffuse() const noexcept
 {
     return properties->diffuse;
@@ -15,6 +36,7 @@ const glm::vec4& Material::getDiffuse() const noexcept
 void Material::setDiffuse( const glm::vec4& diffuse ) noexcept
 {
     properties->diffuse = diffuse;
+    markDirty();
 }
 
 const glm::vec4& Material::getSpecular() const noexcept
@@ -25,6 +47,7 @@ const glm::vec4& Material::getSpecular() const noexcept
 void Material::setSpecular( const glm::vec4& specular ) noexcept
 {
     properties->specular = specular;
+    markDirty();
 }
 
 const glm::vec4& Material::getEmissive() const noexcept
@@ -35,6 +58,7 @@ const glm::vec4& Material::getEmissive() const noexcept
 void Material::setEmissive( const glm::vec4& emissive ) noexcept
 {
     properties->emissive = emissive;
+    markDirty();
 }
 
 const glm::vec4& Material::getAmbient() const noexcept
@@ -45,6 +69,7 @@ const glm::vec4& Material::getAmbient() const noexcept
 void Material::setAmbient( const glm::vec4& ambient ) noexcept
 {
     properties->ambient = ambient;
+    markDirty();
 }
 
 const glm::vec4& Material::getReflectance() const noexcept
@@ -55,6 +80,7 @@ const glm::vec4& Material::getReflectance() const noexcept
 void Material::setReflectance( const glm::vec4& reflectance ) noexcept
 {
     properties->reflectance = reflectance;
+    markDirty();
 }
 
 float Material::getOpacity() const noexcept
@@ -65,6 +91,7 @@ float Material::getOpacity() const noexcept
 void Material::setOpacity( float opacity ) noexcept
 {
     properties->opacity = opacity;
+    markDirty();
 }
 
 float Material::getSpecularPower() const noexcept
@@ -75,6 +102,7 @@ float Material::getSpecularPower() const noexcept
 void Material::setSpecularPower( float specularPower ) noexcept
 {
     properties->specularPower = specularPower;
+    markDirty();
 }
 
 float Material::getIndexOfRefraction() const noexcept
@@ -85,6 +113,7 @@ float Material::getIndexOfRefraction() const noexcept
 void Material::setIndexOfRefraction( float indexOfRefraction ) noexcept
 {
     properties->indexOfRefraction = indexOfRefraction;
+    markDirty();
 }
 
 float Material::getBumpIntensity() const noexcept
@@ -95,6 +124,7 @@ float Material::getBumpIntensity() const noexcept
 void Material::setBumpIntensity( float bumpIntensity ) noexcept
 {
     properties->bumpIntensity = bumpIntensity;
+    markDirty();
 }
 
 std::shared_ptr<Texture> Material::getTexture( TextureSlot slot ) const
@@ -108,42 +138,104 @@ std::shared_ptr<Texture> Material::getTexture( TextureSlot slot ) const
 
 void Material::setTexture( TextureSlot slot, std::shared_ptr<Texture> texture )
 {
-    textures[slot] = texture;
+    // Textures with fewer than 4 channels are swizzled in the shader.
+    TextureSwizzle swizzle = TextureSwizzle::None;
+    if ( texture )
+    {
+        switch ( texture->getWGPUTextureDescriptor().format )
+        {
+        case WGPUTextureFormat_R8Unorm:
+            swizzle = TextureSwizzle::RRR1;
+            break;
+        case WGPUTextureFormat_RG8Unorm:
+            swizzle = TextureSwizzle::RRRG;
+            break;
+        default:
+            swizzle = TextureSwizzle::RGBA;
+            break;
+        }
+    }
+
+    setTexture( slot, std::move( texture ), swizzle );
+}
+
+void Material::setTexture( TextureSlot slot, std::shared_ptr<Texture> texture, TextureSwizzle swizzle,
+                           uint32_t layer )
+{
+    const auto flags = texture ? static_cast<uint32_t>( swizzle ) | ( layer << 8 ) : 0u;
+
+    textures[slot] = std::move( texture );
+
+    if ( auto textureFlags = getTextureFlags( slot ) )
+        *textureFlags = flags;
+
+    markDirty();
+    bindGroupDirty = true;
+}
+
+void Material::setPackedSlot( TextureSlot slot )
+{
+    if ( slot != TextureSlot::Specular && slot != TextureSlot::SpecularPower && slot != TextureSlot::Opacity )
+    {
+        std::cerr << "ERROR: Material::setPackedSlot: Only the specular, specular power and opacity slots can be "
+                     "packed."
+                  << std::endl;
+        return;
+    }
+
+    textures.erase( slot );
+
+    if ( auto textureFlags = getTextureFlags( slot ) )
+        *textureFlags = static_cast<uint32_t>( TextureSwizzle::Packed );
+
+    markDirty();
+    bindGroupDirty = true;
+}
+
+TextureSwizzle Material::getTextureSwizzle( TextureSlot slot ) const noexcept
+{
+    auto textureFlags = getTextureFlags( slot );
+    return textureFlags ? static_cast<TextureSwizzle>( *textureFlags & 0xff ) : TextureSwizzle::None;
+}
+
+uint32_t Material::getTextureLayer( TextureSlot slot ) const noexcept
+{
+    auto textureFlags = getTextureFlags( slot );
+    return textureFlags ? *textureFlags >> 8 : 0u;
+}
 
+uint32_t* Material::getTextureFlags( TextureSlot slot ) const noexcept
+{
     switch ( slot )
     {
     case TextureSlot::Ambient:
-        properties->hasAmbientTexture = texture != nullptr;
-        break;
+        return &properties->hasAmbientTexture;
     case TextureSlot::Diffuse:
-        properties->hasDiffuseTexture = texture != nullptr;
-        break;
+        return &properties->hasDiffuseTexture;
     case TextureSlot::Emissive:
-        properties->hasEmissiveTexture = texture != nullptr;
-        break;
+        return &properties->hasEmissiveTexture;
     case TextureSlot::Specular:
-        properties->hasSpecularTexture = texture != nullptr;
-        break;
+        return &properties->hasSpecularTexture;
     case TextureSlot::SpecularPower:
-        properties->hasSpecularPowerTexture = texture != nullptr;
-        break;
+        return &properties->hasSpecularPowerTexture;
     case TextureSlot::Normal:
-        properties->hasNormalTexture = texture != nullptr;
-        break;
+        return &properties->hasNormalTexture;
     case TextureSlot::Bump:
-        properties->hasBumpTexture = texture != nullptr;
-        break;
+        return &properties->hasBumpTexture;
     case TextureSlot::Opacity:
-        properties->hasOpacityTexture = texture != nullptr;
-        break;
+        return &properties->hasOpacityTexture;
+    case TextureSlot::Packed:
+        return &properties->hasPackedTexture;
     case TextureSlot::NumTextureSlots:
         break;
     }
+
+    return nullptr;
 }
 
 bool Material::isTransparent() const noexcept
 {
-    return properties->opacity < 1.0f || textures.find( TextureSlot::Opacity ) != textures.end();
+    return properties->opacity < 1.0f || properties->hasOpacityTexture != 0;
 }
 
 const MaterialProperties& Material::getProperties() const noexcept
@@ -154,5 +246,73 @@ const MaterialProperties& Material::getProperties() const noexcept
 void Material::setProperties( const MaterialProperties& _properties ) noexcept
 {
     *properties = _properties;
+    markDirty();
 }
 
+std::shared_ptr<BindGroup> Material::getBindGroup()
+{
+    if ( !table || !table->getBuffer() )
+    {
+        std::cerr << "ERROR: Material::getBindGroup: The material is not in an updated material table." << std::endl;
+        return nullptr;
+    }
+
+    if ( bindGroup && !bindGroupDirty && bindGroupBuffer == table->getBuffer() )
+        return bindGroup;
+
+    auto& device    = Device::get();
+    bindGroupBuffer = table->getBuffer();
+
+    // Material textures are always bound as texture arrays
+    // (a regular texture is bound as a texture array with a single layer).
+    constexpr uint32_t                        numTextureSlots = static_cast<uint32_t>( TextureSlot::NumTextureSlots );
+    std::vector<std::shared_ptr<TextureView>> textureViews( numTextureSlots );
+    std::vector<WGPUTextureView>              wgpuTextureViews( numTextureSlots );
+    for ( uint32_t i = 0; i < numTextureSlots; ++i )
+    {
+        auto texture = getTexture( static_cast<TextureSlot>( i ) );
+        if ( !texture )
+            texture = device.getDefaultWhiteTexture();
+
+        const auto desc = texture->getWGPUTextureDescriptor();
+
+        WGPUTextureViewDescriptor viewDesc {};
+        viewDesc.format          = desc.format;
+        viewDesc.dimension       = WGPUTextureViewDimension_2DArray;
+        viewDesc.baseMipLevel    = 0;
+        viewDesc.mipLevelCount   = desc.mipLevelCount;
+        viewDesc.baseArrayLayer  = 0;
+        viewDesc.arrayLayerCount = desc.size.depthOrArrayLayers;
+        viewDesc.aspect          = WGPUTextureAspect_All;
+
+        textureViews[i]     = texture->getView( &viewDesc );
+        wgpuTextureViews[i] = textureViews[i]->getWGPUTextureView();
+    }
+
+    // Share the bind group with the other materials that use the same textures.
+    bindGroup      = table->findBindGroup( wgpuTextureViews );
+    bindGroupDirty = false;
+    if ( bindGroup )
+        return bindGroup;
+
+    bindGroup = std::make_shared<MakeBindGroup>();
+    bindGroup->bind( 0, *bindGroupBuffer, 0, sizeof( MaterialProperties ) );
+    for ( uint32_t i = 0; i < numTextureSlots; ++i )
+        bindGroup->bind( i + 1, *textureViews[i] );
+    bindGroup->bind( numTextureSlots + 1, *device.getMaterialSampler() );
+
+    table->addBindGroup( wgpuTextureViews, bindGroup );
+
+    return bindGroup;
+}
+
+uint32_t Material::getBindGroupOffset() const noexcept
+{
+    return static_cast<uint32_t>( MaterialTable::getOffset( id ) );
+}
+
+void Material::markDirty() const noexcept
+{
+    if ( table )
+        table->markDirty( id );
+}
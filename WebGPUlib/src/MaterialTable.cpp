@@ -0,0 +1,158 @@
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/Material.hpp>
+#include <WebGPUlib/MaterialTable.hpp>
+#include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/StorageBuffer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace WebGPUlib;
+
+static_assert( sizeof( MaterialProperties ) <= MaterialTable::Stride );
+
+// The minimum number of materials that the buffer can store.
+constexpr std::size_t MinCapacity = 64;
+
+MaterialTable::~MaterialTable()
+{
+    // Materials that outlive the table must not remove themselves from it.
+    for ( auto material: materials )
+    {
+        if ( material )
+        {
+            material->table = nullptr;
+            material->id    = Material::InvalidId;
+        }
+    }
+}
+
+uint32_t MaterialTable::add( Material& material )
+{
+    if ( material.table == this )
+        return material.id;
+
+    // A material can only be in one table.
+    if ( material.table )
+        material.table->remove( material );
+
+    uint32_t id;
+    if ( !freeIds.empty() )
+    {
+        id = freeIds.back();
+        freeIds.pop_back();
+        materials[id] = &material;
+    }
+    else
+    {
+        id = static_cast<uint32_t>( materials.size() );
+        materials.push_back( &material );
+        dirty.push_back( false );
+    }
+
+    material.table = this;
+    material.id    = id;
+
+    markDirty( id );
+
+    return id;
+}
+
+void MaterialTable::remove( Material& material )
+{
+    if ( material.table != this )
+        return;
+
+    assert( material.id < materials.size() && materials[material.id] == &material );
+
+    materials[material.id] = nullptr;
+    freeIds.push_back( material.id );
+
+    material.table = nullptr;
+    material.id    = Material::InvalidId;
+}
+
+void MaterialTable::markDirty( uint32_t id )
+{
+    assert( id < dirty.size() );
+
+    if ( !dirty[id] )
+    {
+        dirty[id] = true;
+        dirtyIds.push_back( id );
+    }
+}
+
+void MaterialTable::update()
+{
+    // Grow the buffer (by doubling its capacity) if materials were added.
+    // All materials are uploaded to the new buffer.
+    if ( !buffer || capacity < materials.size() )
+    {
+        capacity = std::max( { MinCapacity, capacity * 2, materials.size() } );
+        buffer   = Device::get().createStorageBuffer( nullptr, capacity, Stride, WGPUBufferUsage_Uniform );
+
+        // The bind groups bind the previous buffer.
+        bindGroups.clear();
+
+        for ( uint32_t id = 0; id < materials.size(); ++id )
+        {
+            if ( materials[id] )
+                markDirty( id );
+        }
+    }
+
+    if ( dirtyIds.empty() )
+        return;
+
+    // Sort the dirty IDs, so that materials with contiguous IDs are uploaded with a single write.
+    std::sort( dirtyIds.begin(), dirtyIds.end() );
+
+    const auto           queue = Device::get().getQueue();
+    std::vector<uint8_t> entries;
+    entries.reserve( dirtyIds.size() * Stride );
+
+    for ( std::size_t i = 0; i < dirtyIds.size(); )
+    {
+        const uint32_t first = dirtyIds[i];
+        uint32_t       id    = first;
+
+        entries.clear();
+        for ( ; i < dirtyIds.size() && dirtyIds[i] == id; ++i, ++id )
+        {
+            // Removed materials are still uploaded (with the default properties) to keep the range contiguous.
+            const MaterialProperties properties =
+                materials[id] ? materials[id]->getProperties() : MaterialProperties {};
+
+            entries.resize( entries.size() + Stride, 0 );
+            std::memcpy( entries.data() + entries.size() - Stride, &properties, sizeof( properties ) );
+            dirty[id] = false;
+        }
+
+        queue->writeBuffer( *buffer, entries.data(), entries.size(), getOffset( first ) );
+    }
+
+    dirtyIds.clear();
+}
+
+std::shared_ptr<BindGroup> MaterialTable::findBindGroup( const std::vector<WGPUTextureView>& textureViews ) const
+{
+    auto iter = bindGroups.find( textureViews );
+    return iter != bindGroups.end() ? iter->second.lock() : nullptr;
+}
+
+void MaterialTable::addBindGroup( const std::vector<WGPUTextureView>&  textureViews,
+                                  const std::shared_ptr<BindGroup>& bindGroup )
+{
+    // Remove the bind groups that are no longer used. The handles of their texture views may be reused.
+    for ( auto iter = bindGroups.begin(); iter != bindGroups.end(); )
+    {
+        if ( iter->second.expired() )
+            iter = bindGroups.erase( iter );
+        else
+            ++iter;
+    }
+
+    bindGroups[textureViews] = bindGroup;
+}
@@ -49,4 +49,57 @@ void Mesh::setMaterial( std::shared_ptr<Material> _material )
 std::shared_ptr<Material> Mesh::getMaterial() const
 {
     return material;
-}
\ No newline at end of file
+}
+
+void Mesh::setVertexLayout( VertexLayout _vertexLayout )
+{
+    vertexLayout = _vertexLayout;
+}
+
+VertexLayout Mesh::getVertexLayout() const
+{
+    return vertexLayout;
+}
+
+void Mesh::setLODs( std::vector<MeshLOD> _lods )
+{
+    lods = std::move( _lods );
+}
+
+const std::vector<MeshLOD>& Mesh::getLODs() const
+{
+    return lods;
+}
+
+void Mesh::setBoundingSphere( const glm::vec3& center, float radius )
+{
+    boundingSphereCenter = center;
+    boundingSphereRadius = radius;
+}
+
+const glm::vec3& Mesh::getBoundingSphereCenter() const
+{
+    return boundingSphereCenter;
+}
+
+float Mesh::getBoundingSphereRadius() const
+{
+    return boundingSphereRadius;
+}
+
+void Mesh::setMeshlets( std::shared_ptr<StorageBuffer> _meshletBuffer,
+                        std::shared_ptr<StorageBuffer> _meshletIndexBuffer )
+{
+    meshletBuffer      = std::move( _meshletBuffer );
+    meshletIndexBuffer = std::move( _meshletIndexBuffer );
+}
+
+std::shared_ptr<StorageBuffer> Mesh::getMeshletBuffer() const
+{
+    return meshletBuffer;
+}
+
+std::shared_ptr<StorageBuffer> Mesh::getMeshletIndexBuffer() const
+{
+    return meshletIndexBuffer;
+}
@@ -0,0 +1,363 @@
+#include <WebGPUlib/MeshSimplifier.hpp>
+
+#include <glm/geometric.hpp>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+
+using namespace WebGPUlib;
+
+namespace
+{
+// A symmetric 4x4 matrix that measures the squared distance of a point to a set of planes.
+struct Quadric
+{
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+
+    Quadric() = default;
+
+    // Construct a quadric from the plane equation ax + by + cz + d = 0 with weight w.
+    Quadric( double a, double b, double c, double d, double w )
+    : a00 { w * a * a }
+    , a01 { w * a * b }
+    , a02 { w * a * c }
+    , a03 { w * a * d }
+    , a11 { w * b * b }
+    , a12 { w * b * c }
+    , a13 { w * b * d }
+    , a22 { w * c * c }
+    , a23 { w * c * d }
+    , a33 { w * d * d }
+    {}
+
+    Quadric& operator+=( const Quadric& q )
+    {
+        a00 += q.a00;
+        a01 += q.a01;
+        a02 += q.a02;
+        a03 += q.a03;
+        a11 += q.a11;
+        a12 += q.a12;
+        a13 += q.a13;
+        a22 += q.a22;
+        a23 += q.a23;
+        a33 += q.a33;
+
+        return *this;
+    }
+
+    // Evaluate the squared distance of p to the planes of the quadric.
+    double error( const glm::vec3& p ) const
+    {
+        double x = p.x, y = p.y, z = p.z;
+
+        double e = a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x + a11 * y * y +
+                   2.0 * a12 * y * z + 2.0 * a13 * y + a22 * z * z + 2.0 * a23 * z + a33;
+
+        return std::max( e, 0.0 );
+    }
+};
+
+// A candidate edge collapse (from -> to).
+struct Collapse
+{
+    float    cost;   // The cost that is used to order the collapses (the error plus the attribute penalties).
+    float    error;  // The squared distance of the collapsed vertex to the planes of the original triangles.
+    uint32_t from;
+    uint32_t to;
+    uint32_t version;  // The version of the from vertex when the collapse was computed.
+
+    bool operator>( const Collapse& rhs ) const
+    {
+        return cost > rhs.cost;
+    }
+};
+
+struct PositionHash
+{
+    std::size_t operator()( const glm::vec3& p ) const noexcept
+    {
+        uint32_t h[3];
+        std::memcpy( h, &p, sizeof( h ) );
+        return ( h[0] * 73856093u ) ^ ( h[1] * 19349663u ) ^ ( h[2] * 83492791u );
+    }
+};
+
+uint64_t edgeKey( uint32_t a, uint32_t b )
+{
+    if ( a > b )
+        std::swap( a, b );
+
+    return ( static_cast<uint64_t>( a ) << 32 ) | b;
+}
+
+}  // namespace
+
+std::vector<uint32_t> WebGPUlib::simplifyMesh( const std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
+                                               const std::vector<uint32_t>& indices, std::size_t targetIndexCount,
+                                               float maxError, float* resultError )
+{
+    assert( ( indices.size() % 3 ) == 0 );
+
+    const std::size_t vertexCount   = vertices.size();
+    const std::size_t triangleCount = indices.size() / 3;
+
+    std::vector<uint32_t> triangles = indices;
+    std::vector<bool>     triangleRemoved( triangleCount, false );
+    std::size_t           remainingTriangles = triangleCount;
+
+    // The triangles that reference each vertex.
+    std::vector<std::vector<uint32_t>> vertexTriangles( vertexCount );
+    for ( uint32_t t = 0; t < triangleCount; ++t )
+    {
+        for ( uint32_t k = 0; k < 3; ++k )
+            vertexTriangles[triangles[t * 3 + k]].push_back( t );
+    }
+
+    // Compute the quadric of each vertex from the planes of the adjacent triangles.
+    // The quadrics are not weighted by area so the error is a squared distance.
+    std::vector<Quadric> quadrics( vertexCount );
+    for ( uint32_t t = 0; t < triangleCount; ++t )
+    {
+        const glm::vec3& p0 = vertices[triangles[t * 3 + 0]].position;
+        const glm::vec3& p1 = vertices[triangles[t * 3 + 1]].position;
+        const glm::vec3& p2 = vertices[triangles[t * 3 + 2]].position;
+
+        glm::vec3 n      = glm::cross( p1 - p0, p2 - p0 );
+        float     length = glm::length( n );
+        if ( length <= 0.0f )
+            continue;
+
+        n /= length;
+        Quadric q { n.x, n.y, n.z, -glm::dot( n, p0 ), 1.0 };
+
+        for ( uint32_t k = 0; k < 3; ++k )
+            quadrics[triangles[t * 3 + k]] += q;
+    }
+
+    // Lock vertices on attribute seams (multiple vertices with the same position).
+    std::vector<bool> locked( vertexCount, false );
+    {
+        std::unordered_map<glm::vec3, uint32_t, PositionHash> positions;
+        for ( uint32_t v = 0; v < vertexCount; ++v )
+        {
+            auto [iter, inserted] = positions.try_emplace( vertices[v].position, v );
+            if ( !inserted )
+            {
+                locked[v]            = true;
+                locked[iter->second] = true;
+            }
+        }
+    }
+
+    // Lock vertices on borders (edges that are only used by a single triangle).
+    {
+        std::unordered_map<uint64_t, uint32_t> edgeCount;
+        for ( uint32_t t = 0; t < triangleCount; ++t )
+        {
+            for ( uint32_t k = 0; k < 3; ++k )
+                ++edgeCount[edgeKey( triangles[t * 3 + k], triangles[t * 3 + ( k + 1 ) % 3] )];
+        }
+
+        for ( auto& [key, count]: edgeCount )
+        {
+            if ( count == 1 )
+            {
+                locked[static_cast<uint32_t>( key >> 32 )]         = true;
+                locked[static_cast<uint32_t>( key & 0xffffffff )] = true;
+            }
+        }
+    }
+
+    // Compute the geometric error (the squared distance to the planes of the original triangles)
+    // of collapsing vertex from onto vertex to.
+    auto collapseError = [&]( uint32_t from, uint32_t to ) {
+        Quadric q = quadrics[from];
+        q += quadrics[to];
+
+        return static_cast<float>( q.error( vertices[to].position ) );
+    };
+
+    // Compute the cost of a collapse. Differences in the vertex attributes are penalized (scaled by the
+    // edge length to match the geometric error), but they only affect the order of the collapses.
+    auto collapseCost = [&]( uint32_t from, uint32_t to, float error ) {
+        const auto& v0 = vertices[from];
+        const auto& v1 = vertices[to];
+
+        float edgeLength2   = glm::dot( v1.position - v0.position, v1.position - v0.position );
+        float normalError   = glm::dot( v1.normal - v0.normal, v1.normal - v0.normal );
+        float texCoordError = glm::dot( v1.texCoord - v0.texCoord, v1.texCoord - v0.texCoord );
+
+        return error + ( normalError + texCoordError ) * edgeLength2;
+    };
+
+    // Check if collapsing vertex from onto vertex to flips the orientation of any of the remaining triangles.
+    auto flipsTriangles = [&]( uint32_t from, uint32_t to ) {
+        for ( uint32_t t: vertexTriangles[from] )
+        {
+            if ( triangleRemoved[t] )
+                continue;
+
+            const uint32_t* tri = &triangles[t * 3];
+            if ( tri[0] == to || tri[1] == to || tri[2] == to )
+                continue;  // This triangle will be removed.
+
+            glm::vec3 p[3], q[3];
+            for ( uint32_t k = 0; k < 3; ++k )
+            {
+                p[k] = vertices[tri[k]].position;
+                q[k] = tri[k] == from ? vertices[to].position : p[k];
+            }
+
+            glm::vec3 n0 = glm::cross( p[1] - p[0], p[2] - p[0] );
+            glm::vec3 n1 = glm::cross( q[1] - q[0], q[2] - q[0] );
+            if ( glm::dot( n0, n1 ) <= 0.0f )
+                return true;
+        }
+
+        return false;
+    };
+
+    // Each vertex has a version that is incremented when its neighborhood changes.
+    // Collapses with an outdated version are discarded when they are popped from the queue.
+    std::vector<uint32_t> versions( vertexCount, 0 );
+    std::vector<bool>     collapsed( vertexCount, false );
+
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> queue;
+
+    // Add the best collapse of vertex v to the queue.
+    auto pushCollapse = [&]( uint32_t v ) {
+        if ( locked[v] || collapsed[v] )
+            return;
+
+        Collapse best { FLT_MAX, FLT_MAX, v, v, versions[v] };
+        for ( uint32_t t: vertexTriangles[v] )
+        {
+            if ( triangleRemoved[t] )
+                continue;
+
+            for ( uint32_t k = 0; k < 3; ++k )
+            {
+                uint32_t to = triangles[t * 3 + k];
+                if ( to == v )
+                    continue;
+
+                float error = collapseError( v, to );
+                float cost  = collapseCost( v, to, error );
+                if ( cost < best.cost )
+                {
+                    best.cost  = cost;
+                    best.error = error;
+                    best.to    = to;
+                }
+            }
+        }
+
+        if ( best.to != v )
+            queue.push( best );
+    };
+
+    for ( uint32_t v = 0; v < vertexCount; ++v )
+        pushCollapse( v );
+
+    const std::size_t targetTriangles = targetIndexCount / 3;
+    const float       maxError2       = maxError < FLT_MAX ? maxError * maxError : FLT_MAX;
+    float             error           = 0.0f;
+
+    std::vector<uint32_t> neighbors;
+
+    while ( remainingTriangles > targetTriangles && !queue.empty() )
+    {
+        Collapse c = queue.top();
+        queue.pop();
+
+        if ( collapsed[c.from] || collapsed[c.to] || c.version != versions[c.from] )
+            continue;
+
+        // The collapses are ordered by cost (not by error), so other collapses may still be within the error.
+        if ( c.error > maxError2 )
+            continue;
+
+        // If the collapse flips the orientation of any of the remaining triangles, collapse the edge
+        // in the other direction instead. Otherwise, try again when the neighborhood of the vertex changes.
+        if ( flipsTriangles( c.from, c.to ) )
+        {
+            if ( locked[c.to] || flipsTriangles( c.to, c.from ) )
+                continue;
+
+            std::swap( c.from, c.to );
+            c.error = collapseError( c.from, c.to );
+            if ( c.error > maxError2 )
+                continue;
+        }
+
+        // Perform the collapse.
+        for ( uint32_t t: vertexTriangles[c.from] )
+        {
+            if ( triangleRemoved[t] )
+                continue;
+
+            uint32_t* tri = &triangles[t * 3];
+            if ( tri[0] == c.to || tri[1] == c.to || tri[2] == c.to )
+            {
+                triangleRemoved[t] = true;
+                --remainingTriangles;
+                continue;
+            }
+
+            for ( uint32_t k = 0; k < 3; ++k )
+            {
+                if ( tri[k] == c.from )
+                    tri[k] = c.to;
+            }
+
+            vertexTriangles[c.to].push_back( t );
+        }
+
+        collapsed[c.from] = true;
+        quadrics[c.to] += quadrics[c.from];
+        error = std::max( error, c.error );
+
+        // Update the collapses of the vertices around the collapsed edge.
+        neighbors.clear();
+        for ( uint32_t t: vertexTriangles[c.to] )
+        {
+            if ( triangleRemoved[t] )
+                continue;
+
+            neighbors.insert( neighbors.end(), &triangles[t * 3], &triangles[t * 3] + 3 );
+        }
+
+        std::sort( neighbors.begin(), neighbors.end() );
+        neighbors.erase( std::unique( neighbors.begin(), neighbors.end() ), neighbors.end() );
+
+        for ( uint32_t v: neighbors )
+        {
+            ++versions[v];
+            pushCollapse( v );
+        }
+    }
+
+    std::vector<uint32_t> result;
+    result.reserve( remainingTriangles * 3 );
+
+    for ( uint32_t t = 0; t < triangleCount; ++t )
+    {
+        if ( !triangleRemoved[t] )
+            result.insert( result.end(), &triangles[t * 3], &triangles[t * 3] + 3 );
+    }
+
+    if ( resultError )
+        *resultError = std::sqrt( error );
+
+    return result;
+}
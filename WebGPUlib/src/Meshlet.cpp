@@ -0,0 +1,184 @@
+#include <WebGPUlib/Meshlet.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+using namespace WebGPUlib;
+
+// Compute the bounding sphere and normal cone of a meshlet.
+static void computeMeshletBounds( Meshlet& meshlet, const std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
+                                  const std::vector<uint32_t>& meshletIndices )
+{
+    glm::vec3 boundsMin { FLT_MAX };
+    glm::vec3 boundsMax { -FLT_MAX };
+    glm::vec3 normalSum { 0 };
+
+    const uint32_t* indices = meshletIndices.data() + meshlet.firstIndex;
+
+    for ( uint32_t i = 0; i < meshlet.indexCount; i += 3 )
+    {
+        const glm::vec3& p0 = vertices[indices[i + 0]].position;
+        const glm::vec3& p1 = vertices[indices[i + 1]].position;
+        const glm::vec3& p2 = vertices[indices[i + 2]].position;
+
+        boundsMin = glm::min( boundsMin, glm::min( p0, glm::min( p1, p2 ) ) );
+        boundsMax = glm::max( boundsMax, glm::max( p0, glm::max( p1, p2 ) ) );
+
+        glm::vec3 n = glm::cross( p1 - p0, p2 - p0 );
+        float     l = glm::length( n );
+        if ( l > 0.0f )
+            normalSum += n / l;
+    }
+
+    meshlet.center = ( boundsMin + boundsMax ) * 0.5f;
+    meshlet.radius = 0.0f;
+    for ( uint32_t i = 0; i < meshlet.indexCount; ++i )
+    {
+        meshlet.radius = std::max( meshlet.radius, glm::distance( meshlet.center, vertices[indices[i]].position ) );
+    }
+
+    // The cone axis is the average triangle normal.
+    // The cutoff is the sine of the largest angle between the axis and a triangle normal.
+    float axisLength = glm::length( normalSum );
+    if ( axisLength <= 0.0f )
+    {
+        // Degenerate meshlet. Never cull it.
+        meshlet.coneAxis   = { 0, 0, 1 };
+        meshlet.coneCutoff = 1.0f;
+        return;
+    }
+
+    meshlet.coneAxis = normalSum / axisLength;
+
+    float minDot = 1.0f;
+    for ( uint32_t i = 0; i < meshlet.indexCount; i += 3 )
+    {
+        const glm::vec3& p0 = vertices[indices[i + 0]].position;
+        const glm::vec3& p1 = vertices[indices[i + 1]].position;
+        const glm::vec3& p2 = vertices[indices[i + 2]].position;
+
+        glm::vec3 n = glm::cross( p1 - p0, p2 - p0 );
+        float     l = glm::length( n );
+        if ( l > 0.0f )
+            minDot = std::min( minDot, glm::dot( n / l, meshlet.coneAxis ) );
+    }
+
+    // If the spread of the cone is 90 degrees or more, the meshlet can always be seen from some direction.
+    meshlet.coneCutoff = minDot <= 0.0f ? 1.0f : std::sqrt( 1.0f - minDot * minDot );
+}
+
+std::vector<Meshlet> WebGPUlib::buildMeshlets( const std::vector<VertexPositionNormalTangentBitangentTexture>& vertices,
+                                               const std::vector<uint32_t>& indices,
+                                               std::vector<uint32_t>& meshletIndices, std::size_t maxVertices,
+                                               std::size_t maxTriangles )
+{
+    assert( ( indices.size() % 3 ) == 0 );
+    assert( maxVertices >= 3 && maxTriangles >= 1 );
+
+    std::vector<Meshlet> meshlets;
+
+    meshletIndices.clear();
+    meshletIndices.reserve( indices.size() );
+
+    const std::size_t triangleCount = indices.size() / 3;
+
+    // The triangles that reference each vertex.
+    std::vector<std::vector<uint32_t>> vertexTriangles( vertices.size() );
+    for ( uint32_t t = 0; t < triangleCount; ++t )
+    {
+        for ( uint32_t k = 0; k < 3; ++k )
+            vertexTriangles[indices[t * 3 + k]].push_back( t );
+    }
+
+    // The meshlet that each vertex was last added to (used to count the unique vertices of a meshlet).
+    constexpr uint32_t    invalidMeshlet = ~0u;
+    std::vector<uint32_t> vertexMeshlet( vertices.size(), invalidMeshlet );
+    std::vector<bool>     triangleUsed( triangleCount, false );
+    std::vector<uint32_t> meshletVertices;
+    std::size_t           nextTriangle = 0;  // The first triangle that may not have been used yet.
+
+    Meshlet meshlet;
+
+    // Count the number of vertices that triangle t adds to the current meshlet.
+    auto countNewVertices = [&]( uint32_t t ) {
+        std::size_t newVertices = 0;
+        for ( uint32_t k = 0; k < 3; ++k )
+        {
+            if ( vertexMeshlet[indices[t * 3 + k]] != meshlets.size() )
+                ++newVertices;
+        }
+        return newVertices;
+    };
+
+    for ( std::size_t i = 0; i < triangleCount; ++i )
+    {
+        // Grow the meshlet with the adjacent triangle that adds the fewest new vertices
+        // to keep the meshlets compact (which improves the bounds and normal cones).
+        uint32_t    bestTriangle    = invalidMeshlet;
+        std::size_t bestNewVertices = 4;
+        for ( uint32_t v: meshletVertices )
+        {
+            for ( uint32_t t: vertexTriangles[v] )
+            {
+                if ( triangleUsed[t] )
+                    continue;
+
+                std::size_t newVertices = countNewVertices( t );
+                if ( newVertices < bestNewVertices )
+                {
+                    bestTriangle    = t;
+                    bestNewVertices = newVertices;
+                }
+            }
+        }
+
+        // Start a new meshlet if there is no adjacent triangle or it does not fit in the current meshlet.
+        if ( bestTriangle == invalidMeshlet || meshletVertices.size() + bestNewVertices > maxVertices ||
+             meshlet.indexCount / 3 + 1 > maxTriangles )
+        {
+            if ( meshlet.indexCount > 0 )
+            {
+                computeMeshletBounds( meshlet, vertices, meshletIndices );
+                meshlets.push_back( meshlet );
+
+                meshlet            = {};
+                meshlet.firstIndex = static_cast<uint32_t>( meshletIndices.size() );
+                meshletVertices.clear();
+            }
+
+            while ( triangleUsed[nextTriangle] )
+                ++nextTriangle;
+
+            bestTriangle = static_cast<uint32_t>( nextTriangle );
+        }
+
+        triangleUsed[bestTriangle] = true;
+
+        for ( uint32_t k = 0; k < 3; ++k )
+        {
+            uint32_t index = indices[bestTriangle * 3 + k];
+            if ( vertexMeshlet[index] != meshlets.size() )
+            {
+                vertexMeshlet[index] = static_cast<uint32_t>( meshlets.size() );
+                meshletVertices.push_back( index );
+            }
+
+            meshletIndices.push_back( index );
+        }
+
+        meshlet.indexCount += 3;
+    }
+
+    if ( meshlet.indexCount > 0 )
+    {
+        computeMeshletBounds( meshlet, vertices, meshletIndices );
+        meshlets.push_back( meshlet );
+    }
+
+    return meshlets;
+}
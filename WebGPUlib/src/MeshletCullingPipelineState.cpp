@@ -0,0 +1,43 @@
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/Meshlet.hpp>
+#include <WebGPUlib/MeshletCullingPipelineState.hpp>
+#include <WebGPUlib/ShaderReflection.hpp>
+
+using namespace WebGPUlib;
+
+MeshletCullingPipelineState::MeshletCullingPipelineState( bool async )
+{
+    // Load the shader module.
+    const char* shaderCode = {
+#include "../shaders/MeshletCulling.wgsl"
+    };
+
+    // Load the compute shader module.
+    WGPUShaderModule shaderModule = Device::get().getShaderModule( shaderCode, "Meshlet Culling Shader Module" );
+
+    // The bind group layouts are derived from the shader code.
+    const ShaderReflection reflection { shaderCode };
+    WGPUPipelineLayout     pipelineLayout =
+        Device::get().getPipelineLayout( reflection, bindGroupLayouts, "Meshlet Culling Pipeline Layout" );
+
+    // Setup the pipeline state.
+    WGPUComputePipelineDescriptor pipelineDesc {};
+    pipelineDesc.label              = "Meshlet Culling Pipeline";
+    pipelineDesc.layout             = pipelineLayout;
+    pipelineDesc.compute.module     = shaderModule;
+    pipelineDesc.compute.entryPoint = "main";
+
+    if ( async )
+        pipelineKey = Device::get().getComputePipelineAsync( pipelineDesc );
+    else
+        pipeline = Device::get().getComputePipeline( pipelineDesc );
+}
+
+MeshletCullingPipelineState::~MeshletCullingPipelineState() = default;
+
+void MeshletCullingPipelineState::bind( ComputeCommandBuffer& commandBuffer )
+{
+    auto passEncoder = commandBuffer.getWGPUPassEncoder();
+    wgpuComputePassEncoderSetPipeline( passEncoder, pipeline );
+}
@@ -0,0 +1,136 @@
+#include <WebGPUlib/FileReader.hpp>
+#include <WebGPUlib/Hash.hpp>
+#include <WebGPUlib/PipelineCache.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace WebGPUlib;
+namespace fs = std::filesystem;
+
+namespace
+{
+std::string toHex( uint64_t value )
+{
+    constexpr char digits[] = "0123456789abcdef";
+
+    std::string hex( 16, '0' );
+    for ( int i = 15; i >= 0; --i, value >>= 4 )
+        hex[i] = digits[value & 0xf];
+
+    return hex;
+}
+}  // namespace
+
+PipelineCache::PipelineCache( const fs::path& cachePath, std::string_view isolationKey )
+{
+    directory = cachePath / ( "v" + std::to_string( Version ) + "-" +
+                              toHex( hashBytes( isolationKey.data(), isolationKey.size() ) ) );
+
+    std::error_code error;
+    fs::create_directories( directory, error );
+    if ( error )
+    {
+        std::cerr << "ERROR: Failed to create pipeline cache directory: " << directory << " (" << error.message()
+                  << ")" << std::endl;
+        return;
+    }
+
+    for ( const auto& entry: fs::directory_iterator( directory, error ) )
+    {
+        if ( entry.is_regular_file() && entry.path().extension() == ".bin" )
+            ++numEntriesAtOpen;
+    }
+}
+
+fs::path PipelineCache::getEntryPath( const void* key, std::size_t keySize ) const
+{
+    return directory / ( toHex( hashBytes( key, keySize ) ) + ".bin" );
+}
+
+std::size_t PipelineCache::load( const void* key, std::size_t keySize, void* value, std::size_t valueSize )
+{
+    const fs::path entryPath = getEntryPath( key, keySize );
+
+    std::error_code error;
+    if ( !fs::is_regular_file( entryPath, error ) )
+    {
+        ++numMisses;
+        return 0;
+    }
+
+    // An entry stores the size of the key, the key and the value.
+    const std::vector<uint8_t> entry = FileReader::readFile( entryPath );
+
+    uint64_t storedKeySize = 0;
+    if ( entry.size() >= sizeof( storedKeySize ) )
+        std::memcpy( &storedKeySize, entry.data(), sizeof( storedKeySize ) );
+
+    const std::size_t headerSize = sizeof( storedKeySize ) + keySize;
+    if ( entry.size() < headerSize || storedKeySize != keySize ||
+         std::memcmp( entry.data() + sizeof( storedKeySize ), key, keySize ) != 0 )
+    {
+        ++numMisses;
+        return 0;
+    }
+
+    const std::size_t size = entry.size() - headerSize;
+    if ( !value || valueSize == 0 )
+        return size;
+
+    if ( valueSize < size )
+        return 0;
+
+    std::memcpy( value, entry.data() + headerSize, size );
+    ++numHits;
+
+    return size;
+}
+
+void PipelineCache::store( const void* key, std::size_t keySize, const void* value, std::size_t valueSize )
+{
+    const fs::path entryPath = getEntryPath( key, keySize );
+
+    // Write to a temporary file first, so a partially written entry is never loaded
+    // (another thread or a concurrent instance of the application may be loading the entry).
+    fs::path tempPath = entryPath;
+    tempPath += ".tmp" + std::to_string( tempFileCounter++ );
+
+    {
+        std::ofstream file( tempPath, std::ios::binary | std::ios::trunc );
+        if ( !file )
+        {
+            std::cerr << "ERROR: Failed to write pipeline cache entry: " << tempPath << std::endl;
+            return;
+        }
+
+        const uint64_t storedKeySize = keySize;
+        file.write( reinterpret_cast<const char*>( &storedKeySize ), sizeof( storedKeySize ) );
+        file.write( static_cast<const char*>( key ), static_cast<std::streamsize>( keySize ) );
+        file.write( static_cast<const char*>( value ), static_cast<std::streamsize>( valueSize ) );
+
+        if ( !file )
+        {
+            std::cerr << "ERROR: Failed to write pipeline cache entry: " << tempPath << std::endl;
+            file.close();
+            std::error_code error;
+            fs::remove( tempPath, error );
+            return;
+        }
+    }
+
+    std::error_code error;
+    fs::rename( tempPath, entryPath, error );
+    if ( error )
+    {
+        std::cerr << "ERROR: Failed to write pipeline cache entry: " << entryPath << " (" << error.message() << ")"
+                  << std::endl;
+        fs::remove( tempPath, error );
+        return;
+    }
+
+    ++numStores;
+}
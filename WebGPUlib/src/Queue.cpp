@@ -8,6 +8,7 @@
 #include <WebGPUlib/Texture.hpp>
 #include <WebGPUlib/TextureView.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <exception>
 #include <vector>
@@ -35,7 +36,7 @@ void Queue::writeBuffer( WGPUBuffer buffer, const void* data, std::size_t size,
 
 void Queue::writeBuffer( const Buffer& buffer, const void* data, std::size_t size, uint64_t offset ) const
 {
-    writeBuffer( buffer.getWGPUBuffer(), data, size, offset );
+    writeBuffer( buffer.getWGPUBuffer(), data, size, buffer.getOffset() + offset );
 }
 
 static uint32_t bytesPerPixel( WGPUTextureFormat format, WGPUTextureAspect aspect )
@@ -182,39 +183,104 @@ static uint32_t bytesPerPixel( WGPUTextureFormat format, WGPUTextureAspect aspec
     throw std::invalid_argument( "Invalid texture format" );
 }
 
-void Queue::writeTexture( Texture& texture, uint32_t mip, const void* data, std::size_t size ) const
+// The size (in texels) of a block of a compressed texture format.
+// Uncompressed formats have a block size of 1x1 texels.
+static WGPUExtent3D blockSize( WGPUTextureFormat format )
 {
-    constexpr float mipDiv[] = {
-        1.0f,      // 2^0
-        2.0f,      // 2^1
-        4.0f,      // 2^2
-        8.0f,      // 2^3
-        16.0f,     // 2^4
-        32.0f,     // 2^5
-        64.0f,     // 2^6
-        128.0f,    // 2^7
-        256.0f,    // 2^8
-        512.0f,    // 2^9
-        1024.0f,   // 2^10
-        2048.0f,   // 2^11
-        4096.0f,   // 2^12
-        8192.0f,   // 2^13
-        16384.0f,  // 2^14
-    };
+    switch ( format )
+    {
+    case WGPUTextureFormat_BC1RGBAUnorm:
+    case WGPUTextureFormat_BC1RGBAUnormSrgb:
+    case WGPUTextureFormat_BC2RGBAUnorm:
+    case WGPUTextureFormat_BC2RGBAUnormSrgb:
+    case WGPUTextureFormat_BC3RGBAUnorm:
+    case WGPUTextureFormat_BC3RGBAUnormSrgb:
+    case WGPUTextureFormat_BC4RUnorm:
+    case WGPUTextureFormat_BC4RSnorm:
+    case WGPUTextureFormat_BC5RGUnorm:
+    case WGPUTextureFormat_BC5RGSnorm:
+    case WGPUTextureFormat_BC6HRGBUfloat:
+    case WGPUTextureFormat_BC6HRGBFloat:
+    case WGPUTextureFormat_BC7RGBAUnorm:
+    case WGPUTextureFormat_BC7RGBAUnormSrgb:
+    case WGPUTextureFormat_ETC2RGB8Unorm:
+    case WGPUTextureFormat_ETC2RGB8UnormSrgb:
+    case WGPUTextureFormat_ETC2RGB8A1Unorm:
+    case WGPUTextureFormat_ETC2RGB8A1UnormSrgb:
+    case WGPUTextureFormat_ETC2RGBA8Unorm:
+    case WGPUTextureFormat_ETC2RGBA8UnormSrgb:
+    case WGPUTextureFormat_EACR11Unorm:
+    case WGPUTextureFormat_EACR11Snorm:
+    case WGPUTextureFormat_EACRG11Unorm:
+    case WGPUTextureFormat_EACRG11Snorm:
+    case WGPUTextureFormat_ASTC4x4Unorm:
+    case WGPUTextureFormat_ASTC4x4UnormSrgb:
+        return { 4, 4, 1 };
+    case WGPUTextureFormat_ASTC5x4Unorm:
+    case WGPUTextureFormat_ASTC5x4UnormSrgb:
+        return { 5, 4, 1 };
+    case WGPUTextureFormat_ASTC5x5Unorm:
+    case WGPUTextureFormat_ASTC5x5UnormSrgb:
+        return { 5, 5, 1 };
+    case WGPUTextureFormat_ASTC6x5Unorm:
+    case WGPUTextureFormat_ASTC6x5UnormSrgb:
+        return { 6, 5, 1 };
+    case WGPUTextureFormat_ASTC6x6Unorm:
+    case WGPUTextureFormat_ASTC6x6UnormSrgb:
+        return { 6, 6, 1 };
+    case WGPUTextureFormat_ASTC8x5Unorm:
+    case WGPUTextureFormat_ASTC8x5UnormSrgb:
+        return { 8, 5, 1 };
+    case WGPUTextureFormat_ASTC8x6Unorm:
+    case WGPUTextureFormat_ASTC8x6UnormSrgb:
+        return { 8, 6, 1 };
+    case WGPUTextureFormat_ASTC8x8Unorm:
+    case WGPUTextureFormat_ASTC8x8UnormSrgb:
+        return { 8, 8, 1 };
+    case WGPUTextureFormat_ASTC10x5Unorm:
+    case WGPUTextureFormat_ASTC10x5UnormSrgb:
+        return { 10, 5, 1 };
+    case WGPUTextureFormat_ASTC10x6Unorm:
+    case WGPUTextureFormat_ASTC10x6UnormSrgb:
+        return { 10, 6, 1 };
+    case WGPUTextureFormat_ASTC10x8Unorm:
+    case WGPUTextureFormat_ASTC10x8UnormSrgb:
+        return { 10, 8, 1 };
+    case WGPUTextureFormat_ASTC10x10Unorm:
+    case WGPUTextureFormat_ASTC10x10UnormSrgb:
+        return { 10, 10, 1 };
+    case WGPUTextureFormat_ASTC12x10Unorm:
+    case WGPUTextureFormat_ASTC12x10UnormSrgb:
+        return { 12, 10, 1 };
+    case WGPUTextureFormat_ASTC12x12Unorm:
+    case WGPUTextureFormat_ASTC12x12UnormSrgb:
+        return { 12, 12, 1 };
+    default:
+        break;
+    }
+
+    return { 1, 1, 1 };
+}
 
+void Queue::writeTexture( Texture& texture, uint32_t mip, const void* data, std::size_t size ) const
+{
     auto desc = texture.getWGPUTextureDescriptor();
-    assert( mip < desc.mipLevelCount && mip < 14 );
+    assert( mip < desc.mipLevelCount );
 
-    uint32_t w = static_cast<uint32_t>( std::floor( static_cast<float>( desc.size.width ) / mipDiv[mip] ) );
-    uint32_t h = static_cast<uint32_t>( std::floor( static_cast<float>( desc.size.height ) / mipDiv[mip] ) );
     // Width and height must be greater than 0!
-    assert( w > 0 );
-    assert( h > 0 );
+    uint32_t w = std::max( desc.size.width >> mip, 1u );
+    uint32_t h = std::max( desc.size.height >> mip, 1u );
+
+    // Compressed textures are copied in whole blocks. The size of the mip is
+    // rounded up to the block size (even if the mip is smaller than a single block).
+    WGPUExtent3D block   = blockSize( desc.format );
+    uint32_t     blocksX = ( w + block.width - 1 ) / block.width;
+    uint32_t     blocksY = ( h + block.height - 1 ) / block.height;
 
     WGPUTextureDataLayout src {};
     src.offset       = 0;
-    src.bytesPerRow  = w * bytesPerPixel( desc.format, WGPUTextureAspect_All );
-    src.rowsPerImage = h;
+    src.bytesPerRow  = blocksX * bytesPerPixel( desc.format, WGPUTextureAspect_All );
+    src.rowsPerImage = blocksY;
     // The source size and the data size must match.
     assert( static_cast<std::size_t>( src.bytesPerRow ) * src.rowsPerImage == size );
 
@@ -224,7 +290,9 @@ void Queue::writeTexture( Texture& texture, uint32_t mip, const void* data, std:
     dst.origin   = { 0, 0, 0 };
     dst.aspect   = WGPUTextureAspect_All;
 
-    wgpuQueueWriteTexture( queue, &dst, data, size, &src, &desc.size );
+    WGPUExtent3D copySize { blocksX * block.width, blocksY * block.height, 1 };
+
+    wgpuQueueWriteTexture( queue, &dst, data, size, &src, &copySize );
 }
 
 std::shared_ptr<GraphicsCommandBuffer> Queue::createGraphicsCommandBuffer( const RenderTarget& renderTarget,
@@ -321,6 +389,19 @@ void Queue::submit( CommandBuffer& commandBuffer )
     wgpuCommandBufferRelease( cb );
 }
 
+void Queue::submit( const std::vector<std::shared_ptr<CommandBuffer>>& commandBuffers )
+{
+    std::vector<WGPUCommandBuffer> cbs;
+    cbs.reserve( commandBuffers.size() );
+    for ( auto& commandBuffer: commandBuffers )
+        cbs.push_back( commandBuffer->finish() );
+
+    wgpuQueueSubmit( queue, cbs.size(), cbs.data() );
+
+    for ( auto cb: cbs )
+        wgpuCommandBufferRelease( cb );
+}
+
 Queue::Queue( WGPUQueue&& _queue )  // NOLINT(cppcoreguidelines-rvalue-reference-param-not-moved)
 : queue { _queue }
 {}
@@ -0,0 +1,765 @@
+#include <WebGPUlib/Helpers.hpp>
+#include <WebGPUlib/ShaderReflection.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace WebGPUlib;
+
+namespace
+{
+struct Token
+{
+    enum class Kind
+    {
+        Identifier,
+        Number,
+        Symbol
+    };
+
+    Kind             kind;
+    std::string_view text;
+};
+
+// A (possibly templated) type, for example: array<vec4f, 4>.
+// Template arguments that are not types (numbers, access modes and texel formats) are stored as types without arguments.
+struct Type
+{
+    std::string_view  name;
+    std::vector<Type> args;
+};
+
+struct StructMember
+{
+    Type     type;
+    uint32_t align = 0;  // The value of the @align attribute (0 if not specified).
+    uint32_t size  = 0;  // The value of the @size attribute (0 if not specified).
+};
+
+struct Resource
+{
+    uint32_t         group;
+    uint32_t         binding;
+    std::string_view name;
+    std::string_view addressSpace;
+    std::string_view accessMode;
+    Type             type;
+};
+
+struct Function
+{
+    WGPUShaderStageFlags                 stage = WGPUShaderStage_None;  // The stage of an entry point.
+    std::unordered_set<std::string_view> identifiers;                   // The identifiers used in the body.
+};
+
+struct Attribute
+{
+    std::string_view name;
+    std::string_view value;  // The first argument (if any).
+};
+
+// The size and alignment of a type in memory.
+struct MemoryLayout
+{
+    uint32_t align = 0;
+    uint32_t size  = 0;
+};
+
+bool isIdentifierStart( char c )
+{
+    return std::isalpha( static_cast<unsigned char>( c ) ) || c == '_';
+}
+
+bool isIdentifierChar( char c )
+{
+    return std::isalnum( static_cast<unsigned char>( c ) ) || c == '_';
+}
+
+std::vector<Token> tokenize( std::string_view code )
+{
+    std::vector<Token> tokens;
+
+    std::size_t i = 0;
+    while ( i < code.size() )
+    {
+        const char c = code[i];
+
+        if ( std::isspace( static_cast<unsigned char>( c ) ) )
+        {
+            ++i;
+        }
+        else if ( code.compare( i, 2, "//" ) == 0 )
+        {
+            while ( i < code.size() && code[i] != '\n' )
+                ++i;
+        }
+        else if ( code.compare( i, 2, "/*" ) == 0 )
+        {
+            // Block comments can be nested.
+            int depth = 0;
+            do
+            {
+                if ( code.compare( i, 2, "/*" ) == 0 )
+                {
+                    ++depth;
+                    i += 2;
+                }
+                else if ( code.compare( i, 2, "*/" ) == 0 )
+                {
+                    --depth;
+                    i += 2;
+                }
+                else
+                {
+                    ++i;
+                }
+            } while ( depth > 0 && i < code.size() );
+        }
+        else if ( isIdentifierStart( c ) )
+        {
+            const std::size_t start = i;
+            while ( i < code.size() && isIdentifierChar( code[i] ) )
+                ++i;
+            tokens.push_back( { Token::Kind::Identifier, code.substr( start, i - start ) } );
+        }
+        else if ( std::isdigit( static_cast<unsigned char>( c ) ) )
+        {
+            // Numbers can have suffixes (1u, 1.0f) and hexadecimal digits (0xff).
+            const std::size_t start = i;
+            while ( i < code.size() && ( isIdentifierChar( code[i] ) || code[i] == '.' ) )
+                ++i;
+            tokens.push_back( { Token::Kind::Number, code.substr( start, i - start ) } );
+        }
+        else if ( code.compare( i, 2, "->" ) == 0 )
+        {
+            tokens.push_back( { Token::Kind::Symbol, code.substr( i, 2 ) } );
+            i += 2;
+        }
+        else
+        {
+            // Other symbols are single characters (so '>>' closes two template argument lists).
+            tokens.push_back( { Token::Kind::Symbol, code.substr( i, 1 ) } );
+            ++i;
+        }
+    }
+
+    return tokens;
+}
+
+uint32_t toUInt( std::string_view number )
+{
+    try
+    {
+        return static_cast<uint32_t>( std::stoul( std::string( number ), nullptr, 0 ) );
+    }
+    catch ( ... )
+    {
+        return 0;
+    }
+}
+
+// Parses the module scope declarations of a WGSL module.
+class Parser
+{
+public:
+    explicit Parser( std::string_view code )
+    : tokens { tokenize( code ) }
+    {}
+
+    void parse()
+    {
+        std::vector<Attribute> attributes;
+
+        while ( pos < tokens.size() )
+        {
+            if ( accept( "@" ) )
+            {
+                attributes.push_back( parseAttribute() );
+                continue;
+            }
+
+            if ( accept( "struct" ) )
+                parseStruct();
+            else if ( accept( "alias" ) )
+                parseAlias();
+            else if ( accept( "var" ) )
+                parseVar( attributes );
+            else if ( accept( "fn" ) )
+                parseFunction( attributes );
+            else
+                skipStatement();  // const, override, enable, ...
+
+            attributes.clear();
+        }
+    }
+
+    std::unordered_map<std::string_view, std::vector<StructMember>> structs;
+    std::unordered_map<std::string_view, Type>                      aliases;
+    std::vector<Resource>                                           resources;
+    std::unordered_map<std::string_view, Function>                  functions;
+
+private:
+    bool peek( std::string_view text ) const
+    {
+        return pos < tokens.size() && tokens[pos].text == text;
+    }
+
+    bool accept( std::string_view text )
+    {
+        if ( !peek( text ) )
+            return false;
+
+        ++pos;
+        return true;
+    }
+
+    std::string_view next()
+    {
+        return pos < tokens.size() ? tokens[pos++].text : std::string_view {};
+    }
+
+    // Skip tokens until the closing symbol (the opening symbol was already consumed).
+    void skipBlock( std::string_view open, std::string_view close )
+    {
+        int depth = 1;
+        while ( pos < tokens.size() && depth > 0 )
+        {
+            const auto text = next();
+            if ( text == open )
+                ++depth;
+            else if ( text == close )
+                --depth;
+        }
+    }
+
+    // Skip a statement up to (and including) the semicolon.
+    void skipStatement()
+    {
+        while ( pos < tokens.size() )
+        {
+            const auto text = next();
+            if ( text == ";" )
+                return;
+            if ( text == "(" )
+                skipBlock( "(", ")" );
+            else if ( text == "{" )
+                skipBlock( "{", "}" );
+        }
+    }
+
+    Attribute parseAttribute()
+    {
+        Attribute attribute;
+        attribute.name = next();
+
+        if ( accept( "(" ) )
+        {
+            if ( !peek( ")" ) )
+                attribute.value = tokens[pos].text;
+
+            skipBlock( "(", ")" );
+        }
+
+        return attribute;
+    }
+
+    Type parseType()
+    {
+        Type type;
+        type.name = next();
+
+        if ( accept( "<" ) )
+        {
+            while ( pos < tokens.size() && !accept( ">" ) )
+            {
+                if ( accept( "," ) )
+                    continue;
+
+                if ( tokens[pos].kind == Token::Kind::Number )
+                    type.args.push_back( { next(), {} } );
+                else
+                    type.args.push_back( parseType() );
+            }
+        }
+
+        return type;
+    }
+
+    void parseStruct()
+    {
+        const auto name = next();
+        if ( !accept( "{" ) )
+            return;
+
+        std::vector<StructMember> members;
+        StructMember              member;
+
+        while ( pos < tokens.size() && !accept( "}" ) )
+        {
+            if ( accept( "," ) )
+                continue;
+
+            if ( accept( "@" ) )
+            {
+                const auto attribute = parseAttribute();
+                if ( attribute.name == "align" )
+                    member.align = toUInt( attribute.value );
+                else if ( attribute.name == "size" )
+                    member.size = toUInt( attribute.value );
+                continue;
+            }
+
+            next();  // The name of the member.
+            if ( accept( ":" ) )
+                member.type = parseType();
+
+            members.push_back( member );
+            member = {};
+        }
+
+        accept( ";" );
+
+        structs[name] = std::move( members );
+    }
+
+    void parseAlias()
+    {
+        const auto name = next();
+        if ( accept( "=" ) )
+            aliases[name] = parseType();
+
+        accept( ";" );
+    }
+
+    void parseVar( const std::vector<Attribute>& attributes )
+    {
+        Resource resource {};
+
+        if ( accept( "<" ) )
+        {
+            resource.addressSpace = next();
+            if ( accept( "," ) )
+                resource.accessMode = next();
+            accept( ">" );
+        }
+
+        resource.name = next();
+        if ( accept( ":" ) )
+            resource.type = parseType();
+
+        skipStatement();
+
+        bool hasGroup   = false;
+        bool hasBinding = false;
+        for ( const auto& attribute: attributes )
+        {
+            if ( attribute.name == "group" )
+            {
+                resource.group = toUInt( attribute.value );
+                hasGroup       = true;
+            }
+            else if ( attribute.name == "binding" )
+            {
+                resource.binding = toUInt( attribute.value );
+                hasBinding       = true;
+            }
+        }
+
+        if ( hasGroup && hasBinding )
+            resources.push_back( resource );
+    }
+
+    void parseFunction( const std::vector<Attribute>& attributes )
+    {
+        const auto name     = next();
+        auto&      function = functions[name];
+
+        for ( const auto& attribute: attributes )
+        {
+            if ( attribute.name == "vertex" )
+                function.stage = WGPUShaderStage_Vertex;
+            else if ( attribute.name == "fragment" )
+                function.stage = WGPUShaderStage_Fragment;
+            else if ( attribute.name == "compute" )
+                function.stage = WGPUShaderStage_Compute;
+        }
+
+        // Skip the parameters and the return type.
+        while ( pos < tokens.size() && !accept( "{" ) )
+        {
+            if ( accept( "(" ) )
+                skipBlock( "(", ")" );
+            else
+                next();
+        }
+
+        // Collect the identifiers that are used in the body.
+        int depth = 1;
+        while ( pos < tokens.size() && depth > 0 )
+        {
+            const auto& token = tokens[pos++];
+            if ( token.text == "{" )
+                ++depth;
+            else if ( token.text == "}" )
+                --depth;
+            else if ( token.kind == Token::Kind::Identifier )
+                function.identifiers.insert( token.text );
+        }
+    }
+
+    std::vector<Token> tokens;
+    std::size_t        pos = 0;
+};
+
+// Computes the memory layout of types with the WGSL alignment and size rules.
+class LayoutCalculator
+{
+public:
+    explicit LayoutCalculator( const Parser& parser )
+    : parser { parser }
+    {}
+
+    // Returns false if the layout of the type is unknown.
+    // Runtime-sized arrays have the size of a single element.
+    bool getLayout( const Type& type, MemoryLayout& layout, int depth = 0 ) const
+    {
+        // Guard against recursive aliases.
+        if ( depth > 32 )
+            return false;
+
+        const auto name = type.name;
+
+        if ( auto alias = parser.aliases.find( name ); alias != parser.aliases.end() )
+            return getLayout( alias->second, layout, depth + 1 );
+
+        if ( name == "f32" || name == "i32" || name == "u32" || name == "atomic" )
+        {
+            layout = { 4, 4 };
+            return true;
+        }
+
+        if ( name == "f16" )
+        {
+            layout = { 2, 2 };
+            return true;
+        }
+
+        // vecN<T> and the vecN{f,h,i,u} shorthands.
+        if ( name.size() >= 4 && name.substr( 0, 3 ) == "vec" )
+        {
+            const uint32_t n = name[3] - '0';
+            const uint32_t s = getScalarSize( type, name.substr( 4 ) );
+            if ( n < 2 || n > 4 || s == 0 )
+                return false;
+
+            layout = { n == 2 ? 2 * s : 4 * s, n * s };
+            return true;
+        }
+
+        // matCxR<T> and the matCxR{f,h} shorthands. A matrix is stored as an array of C column vectors.
+        if ( name.size() >= 6 && name.substr( 0, 3 ) == "mat" && name[4] == 'x' )
+        {
+            const uint32_t c = name[3] - '0';
+            const uint32_t r = name[5] - '0';
+            const uint32_t s = getScalarSize( type, name.substr( 6 ) );
+            if ( c < 2 || c > 4 || r < 2 || r > 4 || s == 0 )
+                return false;
+
+            const uint32_t columnAlign = r == 2 ? 2 * s : 4 * s;
+            layout                     = { columnAlign, c * AlignUp( r * s, columnAlign ) };
+            return true;
+        }
+
+        if ( name == "array" )
+        {
+            MemoryLayout element;
+            if ( type.args.empty() || !getLayout( type.args[0], element, depth + 1 ) )
+                return false;
+
+            const uint32_t stride = AlignUp( element.size, element.align );
+            const uint32_t count  = type.args.size() > 1 ? std::max( toUInt( type.args[1].name ), 1u ) : 1u;
+
+            layout = { element.align, count * stride };
+            return true;
+        }
+
+        if ( auto iter = parser.structs.find( name ); iter != parser.structs.end() )
+        {
+            uint32_t offset = 0;
+            uint32_t align  = 1;
+
+            for ( const auto& member: iter->second )
+            {
+                MemoryLayout memberLayout;
+                if ( !getLayout( member.type, memberLayout, depth + 1 ) )
+                    return false;
+
+                const uint32_t memberAlign = member.align ? member.align : memberLayout.align;
+                const uint32_t memberSize  = member.size ? member.size : memberLayout.size;
+
+                offset = AlignUp( offset, memberAlign ) + memberSize;
+                align  = std::max( align, memberAlign );
+            }
+
+            layout = { align, AlignUp( offset, align ) };
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    // Get the size of the scalar type of a vector or matrix (from the template argument or the shorthand suffix).
+    static uint32_t getScalarSize( const Type& type, std::string_view suffix )
+    {
+        const auto scalar = !type.args.empty() ? type.args[0].name : suffix;
+
+        if ( scalar == "f32" || scalar == "i32" || scalar == "u32" || scalar == "f" || scalar == "i" || scalar == "u" )
+            return 4;
+        if ( scalar == "f16" || scalar == "h" )
+            return 2;
+
+        return 0;
+    }
+
+    const Parser& parser;
+};
+
+WGPUTextureViewDimension getViewDimension( std::string_view name )
+{
+    if ( name.find( "cube_array" ) != std::string_view::npos )
+        return WGPUTextureViewDimension_CubeArray;
+    if ( name.find( "cube" ) != std::string_view::npos )
+        return WGPUTextureViewDimension_Cube;
+    if ( name.find( "2d_array" ) != std::string_view::npos )
+        return WGPUTextureViewDimension_2DArray;
+    if ( name.find( "3d" ) != std::string_view::npos )
+        return WGPUTextureViewDimension_3D;
+    if ( name.find( "1d" ) != std::string_view::npos )
+        return WGPUTextureViewDimension_1D;
+
+    return WGPUTextureViewDimension_2D;
+}
+
+WGPUTextureFormat getStorageTextureFormat( std::string_view name )
+{
+    static const std::unordered_map<std::string_view, WGPUTextureFormat> formats = {
+        { "rgba8unorm", WGPUTextureFormat_RGBA8Unorm },   { "rgba8snorm", WGPUTextureFormat_RGBA8Snorm },
+        { "rgba8uint", WGPUTextureFormat_RGBA8Uint },     { "rgba8sint", WGPUTextureFormat_RGBA8Sint },
+        { "rgba16uint", WGPUTextureFormat_RGBA16Uint },   { "rgba16sint", WGPUTextureFormat_RGBA16Sint },
+        { "rgba16float", WGPUTextureFormat_RGBA16Float }, { "r32uint", WGPUTextureFormat_R32Uint },
+        { "r32sint", WGPUTextureFormat_R32Sint },         { "r32float", WGPUTextureFormat_R32Float },
+        { "rg32uint", WGPUTextureFormat_RG32Uint },       { "rg32sint", WGPUTextureFormat_RG32Sint },
+        { "rg32float", WGPUTextureFormat_RG32Float },     { "rgba32uint", WGPUTextureFormat_RGBA32Uint },
+        { "rgba32sint", WGPUTextureFormat_RGBA32Sint },   { "rgba32float", WGPUTextureFormat_RGBA32Float },
+        { "bgra8unorm", WGPUTextureFormat_BGRA8Unorm },
+    };
+
+    const auto iter = formats.find( name );
+    return iter != formats.end() ? iter->second : WGPUTextureFormat_Undefined;
+}
+
+// Fill in the binding type of a layout entry. Returns false if the type of the resource is not supported.
+bool setBindingType( const Resource& resource, const LayoutCalculator& layoutCalculator,
+                     WGPUBindGroupLayoutEntry& entry )
+{
+    const auto name = resource.type.name;
+
+    if ( resource.addressSpace == "uniform" || resource.addressSpace == "storage" )
+    {
+        if ( resource.addressSpace == "uniform" )
+            entry.buffer.type = WGPUBufferBindingType_Uniform;
+        else if ( resource.accessMode == "read_write" )
+            entry.buffer.type = WGPUBufferBindingType_Storage;
+        else
+            entry.buffer.type = WGPUBufferBindingType_ReadOnlyStorage;
+
+        MemoryLayout layout;
+        if ( layoutCalculator.getLayout( resource.type, layout ) )
+            entry.buffer.minBindingSize = layout.size;
+
+        return true;
+    }
+
+    if ( name == "sampler" )
+    {
+        entry.sampler.type = WGPUSamplerBindingType_Filtering;
+        return true;
+    }
+
+    if ( name == "sampler_comparison" )
+    {
+        entry.sampler.type = WGPUSamplerBindingType_Comparison;
+        return true;
+    }
+
+    if ( name.substr( 0, 16 ) == "texture_storage_" )
+    {
+        if ( resource.type.args.size() < 2 )
+            return false;
+
+        const auto access = resource.type.args[1].name;
+        if ( access == "read" )
+            entry.storageTexture.access = WGPUStorageTextureAccess_ReadOnly;
+        else if ( access == "read_write" )
+            entry.storageTexture.access = WGPUStorageTextureAccess_ReadWrite;
+        else
+            entry.storageTexture.access = WGPUStorageTextureAccess_WriteOnly;
+
+        entry.storageTexture.format        = getStorageTextureFormat( resource.type.args[0].name );
+        entry.storageTexture.viewDimension = getViewDimension( name );
+        return entry.storageTexture.format != WGPUTextureFormat_Undefined;
+    }
+
+    if ( name.substr( 0, 8 ) == "texture_" )
+    {
+        entry.texture.viewDimension = getViewDimension( name );
+        entry.texture.multisampled  = name.find( "multisampled" ) != std::string_view::npos;
+
+        if ( name.substr( 0, 14 ) == "texture_depth_" )
+        {
+            entry.texture.sampleType = WGPUTextureSampleType_Depth;
+        }
+        else
+        {
+            const auto sampledType = !resource.type.args.empty() ? resource.type.args[0].name : std::string_view {};
+            if ( sampledType == "i32" )
+                entry.texture.sampleType = WGPUTextureSampleType_Sint;
+            else if ( sampledType == "u32" )
+                entry.texture.sampleType = WGPUTextureSampleType_Uint;
+            else if ( entry.texture.multisampled )  // Multisampled float textures cannot be filtered.
+                entry.texture.sampleType = WGPUTextureSampleType_UnfilterableFloat;
+            else
+                entry.texture.sampleType = WGPUTextureSampleType_Float;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// Add the stage of an entry point to the resources that are used by a function (and the functions it calls).
+void markUsedResources( const Parser& parser, std::string_view functionName, WGPUShaderStageFlags stage,
+                        std::unordered_set<std::string_view>&                          visited,
+                        std::unordered_map<std::string_view, WGPUShaderStageFlags>& visibility )
+{
+    if ( !visited.insert( functionName ).second )
+        return;
+
+    const auto& function = parser.functions.at( functionName );
+    for ( const auto identifier: function.identifiers )
+    {
+        if ( auto iter = visibility.find( identifier ); iter != visibility.end() )
+            iter->second |= stage;
+        else if ( parser.functions.count( identifier ) )
+            markUsedResources( parser, identifier, stage, visited, visibility );
+    }
+}
+}  // namespace
+
+ShaderReflection::ShaderReflection( std::string_view shaderCode )
+{
+    Parser parser { shaderCode };
+    parser.parse();
+
+    const LayoutCalculator layoutCalculator { parser };
+
+    // Find the stages that use each resource.
+    std::unordered_map<std::string_view, WGPUShaderStageFlags> visibility;
+    for ( const auto& resource: parser.resources )
+        visibility[resource.name] = WGPUShaderStage_None;
+
+    WGPUShaderStageFlags allStages = WGPUShaderStage_None;
+    for ( const auto& [name, function]: parser.functions )
+    {
+        if ( function.stage == WGPUShaderStage_None )
+            continue;
+
+        std::unordered_set<std::string_view> visited;
+        markUsedResources( parser, name, function.stage, visited, visibility );
+
+        allStages |= function.stage;
+    }
+
+    for ( const auto& resource: parser.resources )
+    {
+        WGPUBindGroupLayoutEntry entry {};
+        entry.binding = resource.binding;
+
+        if ( !setBindingType( resource, layoutCalculator, entry ) )
+        {
+            std::cerr << "ERROR: ShaderReflection: Unsupported type of resource '" << resource.name
+                      << "' (group: " << resource.group << ", binding: " << resource.binding << ")." << std::endl;
+            continue;
+        }
+
+        // Resources that are not used by any entry point are visible to all stages of the module
+        // (the bind group layout may still contain them).
+        entry.visibility = visibility[resource.name];
+        if ( entry.visibility == WGPUShaderStage_None )
+        {
+            entry.visibility = allStages;
+
+            // Writable storage buffers and textures are not allowed in the vertex stage.
+            if ( entry.buffer.type == WGPUBufferBindingType_Storage ||
+                 entry.storageTexture.access != WGPUStorageTextureAccess_Undefined )
+                entry.visibility &= ~WGPUShaderStage_Vertex;
+        }
+
+        if ( bindGroups.size() <= resource.group )
+            bindGroups.resize( resource.group + 1 );
+
+        bindGroups[resource.group].push_back( entry );
+    }
+
+    for ( auto& entries: bindGroups )
+    {
+        std::sort( entries.begin(), entries.end(),
+                   []( const WGPUBindGroupLayoutEntry& a, const WGPUBindGroupLayoutEntry& b ) {
+                       return a.binding < b.binding;
+                   } );
+    }
+}
+
+const std::vector<WGPUBindGroupLayoutEntry>& ShaderReflection::getBindGroupLayoutEntries( uint32_t groupIndex ) const
+{
+    static const std::vector<WGPUBindGroupLayoutEntry> empty;
+    return groupIndex < bindGroups.size() ? bindGroups[groupIndex] : empty;
+}
+
+void ShaderReflection::setTextureSampleType( uint32_t groupIndex, uint32_t binding, WGPUTextureSampleType sampleType )
+{
+    if ( auto entry = findEntry( groupIndex, binding ) )
+        entry->texture.sampleType = sampleType;
+}
+
+void ShaderReflection::setSamplerType( uint32_t groupIndex, uint32_t binding, WGPUSamplerBindingType samplerType )
+{
+    if ( auto entry = findEntry( groupIndex, binding ) )
+        entry->sampler.type = samplerType;
+}
+
+void ShaderReflection::setDynamicOffset( uint32_t groupIndex, uint32_t binding, bool hasDynamicOffset )
+{
+    if ( auto entry = findEntry( groupIndex, binding ) )
+        entry->buffer.hasDynamicOffset = hasDynamicOffset;
+}
+
+WGPUBindGroupLayoutEntry* ShaderReflection::findEntry( uint32_t groupIndex, uint32_t binding )
+{
+    if ( groupIndex >= bindGroups.size() )
+        return nullptr;
+
+    for ( auto& entry: bindGroups[groupIndex] )
+    {
+        if ( entry.binding == binding )
+            return &entry;
+    }
+
+    return nullptr;
+}
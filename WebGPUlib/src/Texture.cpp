@@ -17,6 +17,15 @@ Texture::Texture( WGPUTexture&&                _texture,  // NOLINT(cppcoreguide
 : texture { _texture }
 , descriptor { descriptor }
 {
+    // The label and the view formats point to the memory of the caller, which is only valid while the texture
+    // is created (for example, the view formats of the intermediate texture in Device::generateMipsMultiPass).
+    // The view formats are copied so the texture can be recreated with the same view formats (see resize).
+    if ( descriptor.viewFormatCount > 0 )
+        viewFormats.assign( descriptor.viewFormats, descriptor.viewFormats + descriptor.viewFormatCount );
+
+    this->descriptor.label       = nullptr;
+    this->descriptor.viewFormats = viewFormats.data();
+
     defaultView = std::make_shared<MakeTextureView>( texture );
 }
 
@@ -34,6 +43,8 @@ Texture::Texture( Texture&& other ) noexcept
     descriptor       = other.descriptor;
     other.descriptor = {};
 
+    // Moving the vector keeps its data, so the view formats of the descriptor stay valid.
+    viewFormats = std::move( other.viewFormats );
     defaultView = std::move( other.defaultView );
     views       = std::move( other.views );
 }
@@ -49,6 +60,7 @@ Texture& Texture::operator=( Texture&& other ) noexcept
     descriptor       = other.descriptor;
     other.descriptor = {};
 
+    viewFormats = std::move( other.viewFormats );
     defaultView = std::move( other.defaultView );
     views       = std::move( other.views );
 
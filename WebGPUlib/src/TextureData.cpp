@@ -0,0 +1,968 @@
+#include <WebGPUlib/TextureData.hpp>
+#include <WebGPUlib/ThreadPool.hpp>
+
+#include <stb_dxt.h>
+#include <stb_image_resize2.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+using namespace WebGPUlib;
+
+namespace
+{
+// The size (in bytes) of a 4x4 block of a BCn format.
+// Returns the size of a single pixel for uncompressed formats.
+uint32_t bytesPerBlock( WGPUTextureFormat format )
+{
+    switch ( format )
+    {
+    case WGPUTextureFormat_BC1RGBAUnorm:
+    case WGPUTextureFormat_BC1RGBAUnormSrgb:
+    case WGPUTextureFormat_BC4RUnorm:
+    case WGPUTextureFormat_BC4RSnorm:
+        return 8u;
+    case WGPUTextureFormat_BC2RGBAUnorm:
+    case WGPUTextureFormat_BC2RGBAUnormSrgb:
+    case WGPUTextureFormat_BC3RGBAUnorm:
+    case WGPUTextureFormat_BC3RGBAUnormSrgb:
+    case WGPUTextureFormat_BC5RGUnorm:
+    case WGPUTextureFormat_BC5RGSnorm:
+    case WGPUTextureFormat_BC6HRGBUfloat:
+    case WGPUTextureFormat_BC6HRGBFloat:
+    case WGPUTextureFormat_BC7RGBAUnorm:
+    case WGPUTextureFormat_BC7RGBAUnormSrgb:
+        return 16u;
+    case WGPUTextureFormat_R8Unorm:
+        return 1u;
+    case WGPUTextureFormat_RG8Unorm:
+        return 2u;
+    case WGPUTextureFormat_RGBA8Unorm:
+    case WGPUTextureFormat_RGBA8UnormSrgb:
+        return 4u;
+    default:
+        break;
+    }
+
+    throw std::invalid_argument( "Unsupported texture format" );
+}
+
+// DDS file format structures.
+// See: https://learn.microsoft.com/en-us/windows/win32/direct3ddds/dds-header
+constexpr uint32_t makeFourCC( char a, char b, char c, char d )
+{
+    return static_cast<uint32_t>( a ) | ( static_cast<uint32_t>( b ) << 8 ) | ( static_cast<uint32_t>( c ) << 16 ) |
+           ( static_cast<uint32_t>( d ) << 24 );
+}
+
+constexpr uint32_t DDS_MAGIC = makeFourCC( 'D', 'D', 'S', ' ' );
+// Tags the cook key in the reserved fields of the DDS header (reserved1[0] is the tag and reserved1[1] the key).
+constexpr uint32_t DDS_COOK_TAG = makeFourCC( 'W', 'G', 'P', 'U' );
+
+constexpr uint32_t DDSD_CAPS        = 0x1;
+constexpr uint32_t DDSD_HEIGHT      = 0x2;
+constexpr uint32_t DDSD_WIDTH       = 0x4;
+constexpr uint32_t DDSD_PIXELFORMAT = 0x1000;
+constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+constexpr uint32_t DDSD_LINEARSIZE  = 0x80000;
+
+constexpr uint32_t DDPF_FOURCC = 0x4;
+constexpr uint32_t DDPF_RGB    = 0x40;
+
+constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+constexpr uint32_t DDSCAPS_MIPMAP  = 0x400000;
+
+constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+// DXGI_FORMAT values of the supported formats.
+enum DXGIFormat : uint32_t
+{
+    DXGI_FORMAT_R8G8B8A8_UNORM      = 28,
+    DXGI_FORMAT_R8G8_UNORM          = 49,
+    DXGI_FORMAT_R8_UNORM            = 61,
+    DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+    DXGI_FORMAT_BC1_UNORM           = 71,
+    DXGI_FORMAT_BC1_UNORM_SRGB      = 72,
+    DXGI_FORMAT_BC2_UNORM           = 74,
+    DXGI_FORMAT_BC2_UNORM_SRGB      = 75,
+    DXGI_FORMAT_BC3_UNORM           = 77,
+    DXGI_FORMAT_BC3_UNORM_SRGB      = 78,
+    DXGI_FORMAT_BC4_UNORM           = 80,
+    DXGI_FORMAT_BC5_UNORM           = 83,
+};
+
+struct DDSPixelFormat
+{
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t rgbBitCount;
+    uint32_t rBitMask;
+    uint32_t gBitMask;
+    uint32_t bBitMask;
+    uint32_t aBitMask;
+};
+
+struct DDSHeader
+{
+    uint32_t       size;
+    uint32_t       flags;
+    uint32_t       height;
+    uint32_t       width;
+    uint32_t       pitchOrLinearSize;
+    uint32_t       depth;
+    uint32_t       mipMapCount;
+    uint32_t       reserved1[11];
+    DDSPixelFormat pixelFormat;
+    uint32_t       caps;
+    uint32_t       caps2;
+    uint32_t       caps3;
+    uint32_t       caps4;
+    uint32_t       reserved2;
+};
+
+struct DDSHeaderDX10
+{
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
+
+static_assert( sizeof( DDSPixelFormat ) == 32 );
+static_assert( sizeof( DDSHeader ) == 124 );
+static_assert( sizeof( DDSHeaderDX10 ) == 20 );
+
+WGPUTextureFormat fromDXGIFormat( uint32_t dxgiFormat )
+{
+    switch ( dxgiFormat )
+    {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+        return WGPUTextureFormat_RGBA8Unorm;
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        return WGPUTextureFormat_RGBA8UnormSrgb;
+    case DXGI_FORMAT_R8G8_UNORM:
+        return WGPUTextureFormat_RG8Unorm;
+    case DXGI_FORMAT_R8_UNORM:
+        return WGPUTextureFormat_R8Unorm;
+    case DXGI_FORMAT_BC1_UNORM:
+        return WGPUTextureFormat_BC1RGBAUnorm;
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+        return WGPUTextureFormat_BC1RGBAUnormSrgb;
+    case DXGI_FORMAT_BC2_UNORM:
+        return WGPUTextureFormat_BC2RGBAUnorm;
+    case DXGI_FORMAT_BC2_UNORM_SRGB:
+        return WGPUTextureFormat_BC2RGBAUnormSrgb;
+    case DXGI_FORMAT_BC3_UNORM:
+        return WGPUTextureFormat_BC3RGBAUnorm;
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+        return WGPUTextureFormat_BC3RGBAUnormSrgb;
+    case DXGI_FORMAT_BC4_UNORM:
+        return WGPUTextureFormat_BC4RUnorm;
+    case DXGI_FORMAT_BC5_UNORM:
+        return WGPUTextureFormat_BC5RGUnorm;
+    default:
+        break;
+    }
+
+    return WGPUTextureFormat_Undefined;
+}
+
+uint32_t toDXGIFormat( WGPUTextureFormat format )
+{
+    switch ( format )
+    {
+    case WGPUTextureFormat_RGBA8Unorm:
+        return DXGI_FORMAT_R8G8B8A8_UNORM;
+    case WGPUTextureFormat_RGBA8UnormSrgb:
+        return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    case WGPUTextureFormat_RG8Unorm:
+        return DXGI_FORMAT_R8G8_UNORM;
+    case WGPUTextureFormat_R8Unorm:
+        return DXGI_FORMAT_R8_UNORM;
+    case WGPUTextureFormat_BC1RGBAUnorm:
+        return DXGI_FORMAT_BC1_UNORM;
+    case WGPUTextureFormat_BC1RGBAUnormSrgb:
+        return DXGI_FORMAT_BC1_UNORM_SRGB;
+    case WGPUTextureFormat_BC2RGBAUnorm:
+        return DXGI_FORMAT_BC2_UNORM;
+    case WGPUTextureFormat_BC2RGBAUnormSrgb:
+        return DXGI_FORMAT_BC2_UNORM_SRGB;
+    case WGPUTextureFormat_BC3RGBAUnorm:
+        return DXGI_FORMAT_BC3_UNORM;
+    case WGPUTextureFormat_BC3RGBAUnormSrgb:
+        return DXGI_FORMAT_BC3_UNORM_SRGB;
+    case WGPUTextureFormat_BC4RUnorm:
+        return DXGI_FORMAT_BC4_UNORM;
+    case WGPUTextureFormat_BC5RGUnorm:
+        return DXGI_FORMAT_BC5_UNORM;
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+// Legacy DDS files use a FourCC code instead of the DX10 header.
+WGPUTextureFormat fromFourCC( uint32_t fourCC )
+{
+    switch ( fourCC )
+    {
+    case makeFourCC( 'D', 'X', 'T', '1' ):
+        return WGPUTextureFormat_BC1RGBAUnorm;
+    case makeFourCC( 'D', 'X', 'T', '3' ):
+        return WGPUTextureFormat_BC2RGBAUnorm;
+    case makeFourCC( 'D', 'X', 'T', '5' ):
+        return WGPUTextureFormat_BC3RGBAUnorm;
+    case makeFourCC( 'A', 'T', 'I', '1' ):
+    case makeFourCC( 'B', 'C', '4', 'U' ):
+        return WGPUTextureFormat_BC4RUnorm;
+    case makeFourCC( 'A', 'T', 'I', '2' ):
+    case makeFourCC( 'B', 'C', '5', 'U' ):
+        return WGPUTextureFormat_BC5RGUnorm;
+    default:
+        break;
+    }
+
+    return WGPUTextureFormat_Undefined;
+}
+
+// Expand a 5:6:5 color to RGBA8.
+void decodeColor565( uint16_t c, uint8_t* rgba )
+{
+    const uint32_t r = ( c >> 11 ) & 0x1f;
+    const uint32_t g = ( c >> 5 ) & 0x3f;
+    const uint32_t b = c & 0x1f;
+
+    rgba[0] = static_cast<uint8_t>( ( r << 3 ) | ( r >> 2 ) );
+    rgba[1] = static_cast<uint8_t>( ( g << 2 ) | ( g >> 4 ) );
+    rgba[2] = static_cast<uint8_t>( ( b << 3 ) | ( b >> 2 ) );
+    rgba[3] = 255;
+}
+
+// Decode the color part of a BC1-BC3 block to 16 RGBA8 pixels.
+// BC2 and BC3 blocks always use the four color mode.
+void decodeColorBlock( const uint8_t* block, uint8_t* rgba, bool alwaysFourColors )
+{
+    const uint16_t c0 = static_cast<uint16_t>( block[0] | ( block[1] << 8 ) );
+    const uint16_t c1 = static_cast<uint16_t>( block[2] | ( block[3] << 8 ) );
+
+    uint8_t palette[4][4];
+    decodeColor565( c0, palette[0] );
+    decodeColor565( c1, palette[1] );
+
+    if ( c0 > c1 || alwaysFourColors )
+    {
+        for ( uint32_t c = 0; c < 3; ++c )
+        {
+            palette[2][c] = static_cast<uint8_t>( ( 2 * palette[0][c] + palette[1][c] + 1 ) / 3 );
+            palette[3][c] = static_cast<uint8_t>( ( palette[0][c] + 2 * palette[1][c] + 1 ) / 3 );
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 255;
+    }
+    else
+    {
+        for ( uint32_t c = 0; c < 3; ++c )
+        {
+            palette[2][c] = static_cast<uint8_t>( ( palette[0][c] + palette[1][c] + 1 ) / 2 );
+            palette[3][c] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 0;  // Transparent black.
+    }
+
+    const uint32_t indices =
+        block[4] | ( block[5] << 8 ) | ( block[6] << 16 ) | ( static_cast<uint32_t>( block[7] ) << 24 );
+    for ( uint32_t i = 0; i < 16; ++i )
+        std::memcpy( &rgba[i * 4], palette[( indices >> ( i * 2 ) ) & 0x3], 4 );
+}
+
+// Decode a BC4 block (also used for the alpha of BC3 and the channels of BC5) to 16 values.
+// The values are written to every stride bytes of dst.
+void decodeBC4Block( const uint8_t* block, uint8_t* dst, uint32_t stride )
+{
+    const uint32_t a0 = block[0];
+    const uint32_t a1 = block[1];
+
+    uint8_t palette[8];
+    palette[0] = static_cast<uint8_t>( a0 );
+    palette[1] = static_cast<uint8_t>( a1 );
+
+    if ( a0 > a1 )
+    {
+        for ( uint32_t i = 1; i < 7; ++i )
+            palette[i + 1] = static_cast<uint8_t>( ( ( 7 - i ) * a0 + i * a1 + 3 ) / 7 );
+    }
+    else
+    {
+        for ( uint32_t i = 1; i < 5; ++i )
+            palette[i + 1] = static_cast<uint8_t>( ( ( 5 - i ) * a0 + i * a1 + 2 ) / 5 );
+
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for ( uint32_t i = 0; i < 6; ++i )
+        indices |= static_cast<uint64_t>( block[2 + i] ) << ( i * 8 );
+
+    for ( uint32_t i = 0; i < 16; ++i )
+        dst[i * stride] = palette[( indices >> ( i * 3 ) ) & 0x7];
+}
+
+// Decode a single 4x4 block to 16 RGBA8 pixels.
+void decodeBlock( const uint8_t* block, uint8_t* rgba, WGPUTextureFormat format )
+{
+    switch ( format )
+    {
+    case WGPUTextureFormat_BC1RGBAUnorm:
+    case WGPUTextureFormat_BC1RGBAUnormSrgb:
+        decodeColorBlock( block, rgba, false );
+        break;
+    case WGPUTextureFormat_BC2RGBAUnorm:
+    case WGPUTextureFormat_BC2RGBAUnormSrgb:
+        decodeColorBlock( block + 8, rgba, true );
+        for ( uint32_t i = 0; i < 16; ++i )
+        {
+            const uint32_t a = ( block[i / 2] >> ( ( i % 2 ) * 4 ) ) & 0xf;
+            rgba[i * 4 + 3]  = static_cast<uint8_t>( a * 17 );
+        }
+        break;
+    case WGPUTextureFormat_BC3RGBAUnorm:
+    case WGPUTextureFormat_BC3RGBAUnormSrgb:
+        decodeColorBlock( block + 8, rgba, true );
+        decodeBC4Block( block, rgba + 3, 4 );
+        break;
+    case WGPUTextureFormat_BC4RUnorm:
+        for ( uint32_t i = 0; i < 16; ++i )
+        {
+            rgba[i * 4 + 1] = 0;
+            rgba[i * 4 + 2] = 0;
+            rgba[i * 4 + 3] = 255;
+        }
+        decodeBC4Block( block, rgba, 4 );
+        break;
+    case WGPUTextureFormat_BC5RGUnorm:
+        for ( uint32_t i = 0; i < 16; ++i )
+        {
+            rgba[i * 4 + 2] = 0;
+            rgba[i * 4 + 3] = 255;
+        }
+        decodeBC4Block( block, rgba, 4 );
+        decodeBC4Block( block + 8, rgba + 1, 4 );
+        break;
+    default:
+        throw std::invalid_argument( "Unsupported block compression format" );
+    }
+}
+
+// Decompress the block rows [firstRow, lastRow) of a BCn image to RGBA8.
+void decompressBlockRows( const uint8_t* blocks, uint32_t width, uint32_t height, WGPUTextureFormat format,
+                          uint32_t firstRow, uint32_t lastRow, uint8_t* rgba )
+{
+    const uint32_t blocksX = ( width + 3 ) / 4;
+    const uint32_t stride  = bytesPerBlock( format );
+
+    uint8_t pixels[16 * 4];
+    for ( uint32_t by = firstRow; by < lastRow; ++by )
+    {
+        for ( uint32_t bx = 0; bx < blocksX; ++bx )
+        {
+            decodeBlock( &blocks[( static_cast<std::size_t>( by ) * blocksX + bx ) * stride], pixels, format );
+
+            // Copy the pixels of the block that are inside the image.
+            for ( uint32_t y = 0; y < 4 && by * 4 + y < height; ++y )
+            {
+                const uint32_t px = bx * 4;
+                const uint32_t n  = std::min( 4u, width - px );
+                std::memcpy( &rgba[( static_cast<std::size_t>( by * 4 + y ) * width + px ) * 4], &pixels[y * 4 * 4],
+                             n * 4 );
+            }
+        }
+    }
+}
+
+// A read-only stream buffer over a block of memory (used to parse files that have already been read).
+class MemoryStreamBuffer : public std::streambuf
+{
+public:
+    MemoryStreamBuffer( const uint8_t* data, std::size_t size )
+    {
+        // The buffer is never written, std::streambuf just doesn't have a const get area.
+        char* begin = const_cast<char*>( reinterpret_cast<const char*>( data ) );
+        setg( begin, begin, begin + size );
+    }
+
+protected:
+    pos_type seekoff( off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode ) override
+    {
+        char* pos = dir == std::ios_base::beg ? eback() : dir == std::ios_base::cur ? gptr() : egptr();
+        if ( offset < eback() - pos || offset > egptr() - pos )
+            return pos_type( off_type( -1 ) );
+
+        setg( eback(), pos + offset, egptr() );
+        return pos_type( gptr() - eback() );
+    }
+
+    pos_type seekpos( pos_type pos, std::ios_base::openmode which ) override
+    {
+        return seekoff( off_type( pos ), std::ios_base::beg, which );
+    }
+};
+
+// Read a DDS file from a stream. The name of the file is used in error messages.
+// If headerOnly is true, only the format, the size and the number of mips are read (the mips are left empty).
+bool readDDS( std::istream& file, const std::string& fileName, TextureData& textureData, uint32_t firstMip,
+              bool headerOnly )
+{
+    uint32_t  magic = 0;
+    DDSHeader header {};
+    file.read( reinterpret_cast<char*>( &magic ), sizeof( magic ) );
+    file.read( reinterpret_cast<char*>( &header ), sizeof( header ) );
+
+    if ( !file || magic != DDS_MAGIC || header.size != sizeof( DDSHeader ) )
+    {
+        std::cerr << "ERROR: Invalid DDS file: " << fileName << std::endl;
+        return false;
+    }
+
+    WGPUTextureFormat format = WGPUTextureFormat_Undefined;
+
+    if ( ( header.pixelFormat.flags & DDPF_FOURCC ) != 0 )
+    {
+        if ( header.pixelFormat.fourCC == makeFourCC( 'D', 'X', '1', '0' ) )
+        {
+            DDSHeaderDX10 headerDX10 {};
+            file.read( reinterpret_cast<char*>( &headerDX10 ), sizeof( headerDX10 ) );
+
+            if ( !file || headerDX10.resourceDimension != DDS_DIMENSION_TEXTURE2D || headerDX10.arraySize > 1 )
+            {
+                std::cerr << "ERROR: Only 2D textures are supported: " << fileName << std::endl;
+                return false;
+            }
+
+            format = fromDXGIFormat( headerDX10.dxgiFormat );
+        }
+        else
+        {
+            format = fromFourCC( header.pixelFormat.fourCC );
+        }
+    }
+    else if ( ( header.pixelFormat.flags & DDPF_RGB ) != 0 && header.pixelFormat.rgbBitCount == 32 &&
+              header.pixelFormat.rBitMask == 0x000000ff && header.pixelFormat.gBitMask == 0x0000ff00 &&
+              header.pixelFormat.bBitMask == 0x00ff0000 )
+    {
+        format = WGPUTextureFormat_RGBA8Unorm;
+    }
+
+    if ( format == WGPUTextureFormat_Undefined )
+    {
+        std::cerr << "ERROR: Unsupported DDS pixel format: " << fileName << std::endl;
+        return false;
+    }
+
+    if ( header.width == 0 || header.height == 0 || header.width > MaxTextureDimension2D ||
+         header.height > MaxTextureDimension2D )
+    {
+        std::cerr << "ERROR: Invalid DDS texture size (" << header.width << "x" << header.height
+                  << "): " << fileName << std::endl;
+        return false;
+    }
+
+    // The size of a block compressed texture must be a multiple of the block size.
+    if ( isBlockCompressed( format ) && ( ( header.width % 4 ) != 0 || ( header.height % 4 ) != 0 ) )
+    {
+        std::cerr << "ERROR: The size of a block compressed DDS texture must be a multiple of 4 (" << header.width
+                  << "x" << header.height << "): " << fileName << std::endl;
+        return false;
+    }
+
+    // A mip chain never has more mips than a full mip chain.
+    const uint32_t maxMipLevelCount =
+        static_cast<uint32_t>( std::floor( std::log2( std::max( header.width, header.height ) ) ) ) + 1u;
+    const uint32_t mipLevelCount =
+        ( header.flags & DDSD_MIPMAPCOUNT ) != 0 ? std::clamp( header.mipMapCount, 1u, maxMipLevelCount ) : 1u;
+
+    textureData.format  = format;
+    textureData.width   = header.width;
+    textureData.height  = header.height;
+    textureData.cookKey = header.reserved1[0] == DDS_COOK_TAG ? header.reserved1[1] : 0u;
+    textureData.mips.clear();
+    textureData.mips.resize( mipLevelCount );
+
+    if ( headerOnly )
+        return true;
+
+    if ( firstMip >= mipLevelCount )
+    {
+        std::cerr << "ERROR: The first mip (" << firstMip << ") is not in the DDS file (" << mipLevelCount
+                  << " mips): " << fileName << std::endl;
+        return false;
+    }
+
+    for ( uint32_t mip = 0; mip < mipLevelCount; ++mip )
+    {
+        const auto mipSize = static_cast<std::streamsize>( getMipSize( format, header.width, header.height, mip ) );
+        if ( mip < firstMip )
+        {
+            file.seekg( mipSize, std::ios::cur );
+            continue;
+        }
+
+        auto& data = textureData.mips[mip];
+        data.resize( static_cast<std::size_t>( mipSize ) );
+        file.read( reinterpret_cast<char*>( data.data() ), mipSize );
+    }
+
+    if ( !file )
+    {
+        std::cerr << "ERROR: Unexpected end of DDS file: " << fileName << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace
+
+bool WebGPUlib::isBlockCompressed( WGPUTextureFormat format )
+{
+    switch ( format )
+    {
+    case WGPUTextureFormat_BC1RGBAUnorm:
+    case WGPUTextureFormat_BC1RGBAUnormSrgb:
+    case WGPUTextureFormat_BC2RGBAUnorm:
+    case WGPUTextureFormat_BC2RGBAUnormSrgb:
+    case WGPUTextureFormat_BC3RGBAUnorm:
+    case WGPUTextureFormat_BC3RGBAUnormSrgb:
+    case WGPUTextureFormat_BC4RUnorm:
+    case WGPUTextureFormat_BC4RSnorm:
+    case WGPUTextureFormat_BC5RGUnorm:
+    case WGPUTextureFormat_BC5RGSnorm:
+    case WGPUTextureFormat_BC6HRGBUfloat:
+    case WGPUTextureFormat_BC6HRGBFloat:
+    case WGPUTextureFormat_BC7RGBAUnorm:
+    case WGPUTextureFormat_BC7RGBAUnormSrgb:
+        return true;
+    default:
+        break;
+    }
+
+    return false;
+}
+
+uint32_t WebGPUlib::getCookKey( const TextureCookOptions& options )
+{
+    // Bit 0 is always set, so the key of a cooked texture is never 0.
+    return 1u | ( static_cast<uint32_t>( options.mipFilter ) << 1 ) | ( options.sRGB ? 1u << 8 : 0u ) |
+           ( options.normalMap ? 1u << 9 : 0u ) | ( options.packedChannels ? 1u << 10 : 0u );
+}
+
+std::size_t WebGPUlib::getMipSize( WGPUTextureFormat format, uint32_t width, uint32_t height, uint32_t mip )
+{
+    // Shifting by 32 or more bits is undefined.
+    uint32_t w = mip < 32 ? std::max( width >> mip, 1u ) : 1u;
+    uint32_t h = mip < 32 ? std::max( height >> mip, 1u ) : 1u;
+
+    if ( isBlockCompressed( format ) )
+    {
+        w = ( w + 3 ) / 4;
+        h = ( h + 3 ) / 4;
+    }
+
+    return static_cast<std::size_t>( w ) * h * bytesPerBlock( format );
+}
+
+std::vector<std::vector<uint8_t>> WebGPUlib::generateMips( const uint8_t* rgba, uint32_t width, uint32_t height,
+                                                           const TextureCookOptions& options )
+{
+    const uint32_t mipLevelCount = static_cast<uint32_t>( std::floor( std::log2( std::max( width, height ) ) ) ) + 1u;
+
+    std::vector<std::vector<uint8_t>> mips( mipLevelCount );
+    mips[0].assign( rgba, rgba + static_cast<std::size_t>( width ) * height * 4u );
+
+    // Normal maps and packed images are not weighted by alpha. Normal maps are never sRGB encoded.
+    const stbir_pixel_layout layout   = options.normalMap || options.packedChannels ? STBIR_4CHANNEL : STBIR_RGBA;
+    const stbir_datatype     dataType = options.sRGB && !options.normalMap ? STBIR_TYPE_UINT8_SRGB : STBIR_TYPE_UINT8;
+
+    const stbir_filter filter = options.mipFilter == MipFilter::Mitchell ? STBIR_FILTER_MITCHELL : STBIR_FILTER_BOX;
+
+    for ( uint32_t mip = 1; mip < mipLevelCount; ++mip )
+    {
+        // Each mip is downsampled from the previous mip.
+        const auto& src       = mips[mip - 1];
+        const int   srcWidth  = static_cast<int>( std::max( width >> ( mip - 1 ), 1u ) );
+        const int   srcHeight = static_cast<int>( std::max( height >> ( mip - 1 ), 1u ) );
+        const int   dstWidth  = static_cast<int>( std::max( width >> mip, 1u ) );
+        const int   dstHeight = static_cast<int>( std::max( height >> mip, 1u ) );
+
+        auto& dst = mips[mip];
+        dst.resize( static_cast<std::size_t>( dstWidth ) * dstHeight * 4u );
+
+        stbir_resize( src.data(), srcWidth, srcHeight, 0, dst.data(), dstWidth, dstHeight, 0, layout, dataType,
+                      STBIR_EDGE_CLAMP, filter );
+
+        if ( options.normalMap )
+        {
+            // Averaging shortens the normals. Restore the unit length.
+            for ( std::size_t i = 0; i < dst.size(); i += 4 )
+            {
+                uint8_t* p = &dst[i];
+
+                float n[3];
+                for ( uint32_t c = 0; c < 3; ++c )
+                    n[c] = static_cast<float>( p[c] ) / 127.5f - 1.0f;
+
+                float length = std::sqrt( n[0] * n[0] + n[1] * n[1] + n[2] * n[2] );
+                if ( length > 0.0f )
+                {
+                    for ( uint32_t c = 0; c < 3; ++c )
+                        p[c] = static_cast<uint8_t>(
+                            std::clamp( ( n[c] / length + 1.0f ) * 127.5f + 0.5f, 0.0f, 255.0f ) );
+                }
+            }
+        }
+    }
+
+    return mips;
+}
+
+std::vector<uint8_t> WebGPUlib::compressBC( const uint8_t* rgba, uint32_t width, uint32_t height,
+                                            WGPUTextureFormat format )
+{
+    const uint32_t blocksX = ( width + 3 ) / 4;
+    const uint32_t blocksY = ( height + 3 ) / 4;
+    const uint32_t stride  = bytesPerBlock( format );
+
+    std::vector<uint8_t> blocks( static_cast<std::size_t>( blocksX ) * blocksY * stride );
+
+    uint8_t block[16 * 4];
+    for ( uint32_t by = 0; by < blocksY; ++by )
+    {
+        for ( uint32_t bx = 0; bx < blocksX; ++bx )
+        {
+            // Gather the 4x4 block of pixels.
+            for ( uint32_t y = 0; y < 4; ++y )
+            {
+                const uint32_t py = std::min( by * 4 + y, height - 1 );
+                for ( uint32_t x = 0; x < 4; ++x )
+                {
+                    const uint32_t px = std::min( bx * 4 + x, width - 1 );
+                    std::memcpy( &block[( y * 4 + x ) * 4], &rgba[( static_cast<std::size_t>( py ) * width + px ) * 4],
+                                 4 );
+                }
+            }
+
+            uint8_t* dst = &blocks[( static_cast<std::size_t>( by ) * blocksX + bx ) * stride];
+
+            switch ( format )
+            {
+            case WGPUTextureFormat_BC1RGBAUnorm:
+            case WGPUTextureFormat_BC1RGBAUnormSrgb:
+                stb_compress_dxt_block( dst, block, 0, STB_DXT_HIGHQUAL );
+                break;
+            case WGPUTextureFormat_BC3RGBAUnorm:
+            case WGPUTextureFormat_BC3RGBAUnormSrgb:
+                stb_compress_dxt_block( dst, block, 1, STB_DXT_HIGHQUAL );
+                break;
+            case WGPUTextureFormat_BC4RUnorm:
+            {
+                uint8_t r[16];
+                for ( uint32_t i = 0; i < 16; ++i )
+                    r[i] = block[i * 4 + 0];
+
+                stb_compress_bc4_block( dst, r );
+            }
+            break;
+            case WGPUTextureFormat_BC5RGUnorm:
+            {
+                uint8_t rg[16 * 2];
+                for ( uint32_t i = 0; i < 16; ++i )
+                {
+                    rg[i * 2 + 0] = block[i * 4 + 0];
+                    rg[i * 2 + 1] = block[i * 4 + 1];
+                }
+
+                stb_compress_bc5_block( dst, rg );
+            }
+            break;
+            default:
+                throw std::invalid_argument( "Unsupported block compression format" );
+            }
+        }
+    }
+
+    return blocks;
+}
+
+std::vector<uint8_t> WebGPUlib::decompressBC( const uint8_t* blocks, uint32_t width, uint32_t height,
+                                              WGPUTextureFormat format )
+{
+    std::vector<uint8_t> rgba( static_cast<std::size_t>( width ) * height * 4u );
+    decompressBlockRows( blocks, width, height, format, 0, ( height + 3 ) / 4, rgba.data() );
+
+    return rgba;
+}
+
+WGPUTextureFormat WebGPUlib::getChannelFormat( uint32_t channels )
+{
+    switch ( channels )
+    {
+    case 1:
+        return WGPUTextureFormat_R8Unorm;
+    case 2:
+        return WGPUTextureFormat_RG8Unorm;
+    default:
+        return WGPUTextureFormat_RGBA8Unorm;
+    }
+}
+
+std::vector<uint8_t> WebGPUlib::packChannels( const uint8_t* rgba, uint32_t width, uint32_t height,
+                                              uint32_t channels )
+{
+    const std::size_t pixelCount = static_cast<std::size_t>( width ) * height;
+
+    if ( channels != 1 && channels != 2 )
+        return { rgba, rgba + pixelCount * 4u };
+
+    std::vector<uint8_t> packed( pixelCount * channels );
+    for ( std::size_t i = 0; i < pixelCount; ++i )
+    {
+        // The red channel stores the luminance of the image. The alpha channel is stored in the green channel.
+        packed[i * channels] = rgba[i * 4];
+        if ( channels == 2 )
+            packed[i * 2 + 1] = rgba[i * 4 + 3];
+    }
+
+    return packed;
+}
+
+bool WebGPUlib::isGrayscale( const uint8_t* rgba, uint32_t width, uint32_t height )
+{
+    const std::size_t pixelCount = static_cast<std::size_t>( width ) * height;
+    for ( std::size_t i = 0; i < pixelCount; ++i )
+    {
+        const uint8_t* p = &rgba[i * 4];
+        if ( p[0] != p[1] || p[0] != p[2] )
+            return false;
+    }
+
+    return true;
+}
+
+std::vector<uint8_t> WebGPUlib::packTextureChannels( const std::array<ImageRGBA8, 4>& images, uint32_t width,
+                                                     uint32_t height )
+{
+    const std::size_t pixelCount = static_cast<std::size_t>( width ) * height;
+
+    std::vector<uint8_t> packed( pixelCount * 4u, 255 );
+    std::vector<uint8_t> resized;
+
+    for ( uint32_t c = 0; c < 4; ++c )
+    {
+        const ImageRGBA8& image = images[c];
+        if ( !image.pixels )
+            continue;
+
+        const uint8_t* src = image.pixels;
+        if ( image.width != width || image.height != height )
+        {
+            resized.resize( pixelCount * 4u );
+            stbir_resize( image.pixels, static_cast<int>( image.width ), static_cast<int>( image.height ), 0,
+                          resized.data(), static_cast<int>( width ), static_cast<int>( height ), 0, STBIR_4CHANNEL,
+                          STBIR_TYPE_UINT8, STBIR_EDGE_CLAMP, STBIR_FILTER_TRIANGLE );
+            src = resized.data();
+        }
+
+        for ( std::size_t i = 0; i < pixelCount; ++i )
+            packed[i * 4 + c] = src[i * 4];
+    }
+
+    return packed;
+}
+
+TextureData WebGPUlib::compressTexture( const uint8_t* rgba, uint32_t width, uint32_t height,
+                                        const TextureCookOptions& options )
+{
+    TextureData textureData;
+    textureData.width  = width;
+    textureData.height = height;
+
+    if ( options.normalMap )
+    {
+        textureData.format = WGPUTextureFormat_BC5RGUnorm;
+    }
+    else
+    {
+        // Use BC3 only if the image is not fully opaque.
+        const std::size_t pixelCount = static_cast<std::size_t>( width ) * height;
+
+        bool hasAlpha = false;
+        for ( std::size_t i = 0; i < pixelCount && !hasAlpha; ++i )
+            hasAlpha = rgba[i * 4 + 3] < 255;
+
+        textureData.format = hasAlpha ? WGPUTextureFormat_BC3RGBAUnorm : WGPUTextureFormat_BC1RGBAUnorm;
+    }
+
+    auto mips = generateMips( rgba, width, height, options );
+
+    textureData.mips.reserve( mips.size() );
+    for ( uint32_t mip = 0; mip < mips.size(); ++mip )
+    {
+        textureData.mips.emplace_back( compressBC( mips[mip].data(), std::max( width >> mip, 1u ),
+                                                   std::max( height >> mip, 1u ), textureData.format ) );
+    }
+
+    return textureData;
+}
+
+TextureData WebGPUlib::decompressTexture( const TextureData& textureData, ThreadPool* threadPool )
+{
+    assert( isBlockCompressed( textureData.format ) );
+
+    TextureData result;
+    result.width  = textureData.width;
+    result.height = textureData.height;
+    result.format = ( textureData.format == WGPUTextureFormat_BC1RGBAUnormSrgb ||
+                      textureData.format == WGPUTextureFormat_BC2RGBAUnormSrgb ||
+                      textureData.format == WGPUTextureFormat_BC3RGBAUnormSrgb )
+                        ? WGPUTextureFormat_RGBA8UnormSrgb
+                        : WGPUTextureFormat_RGBA8Unorm;
+    result.mips.resize( textureData.mips.size() );
+
+    // Split the mips into jobs of (at most) 16 block rows.
+    struct Job
+    {
+        uint32_t mip;
+        uint32_t firstRow;
+        uint32_t lastRow;
+    };
+    std::vector<Job> jobs;
+
+    constexpr uint32_t rowsPerJob = 16;
+    for ( uint32_t mip = 0; mip < textureData.mips.size(); ++mip )
+    {
+        const uint32_t w       = std::max( textureData.width >> mip, 1u );
+        const uint32_t h       = std::max( textureData.height >> mip, 1u );
+        const uint32_t blocksY = ( h + 3 ) / 4;
+
+        result.mips[mip].resize( static_cast<std::size_t>( w ) * h * 4u );
+
+        for ( uint32_t row = 0; row < blocksY; row += rowsPerJob )
+            jobs.push_back( { mip, row, std::min( row + rowsPerJob, blocksY ) } );
+    }
+
+    auto decompressJob = [&]( std::size_t i ) {
+        const Job&     job = jobs[i];
+        const uint32_t w   = std::max( textureData.width >> job.mip, 1u );
+        const uint32_t h   = std::max( textureData.height >> job.mip, 1u );
+
+        decompressBlockRows( textureData.mips[job.mip].data(), w, h, textureData.format, job.firstRow, job.lastRow,
+                             result.mips[job.mip].data() );
+    };
+
+    if ( threadPool )
+    {
+        threadPool->parallelFor( jobs.size(), decompressJob );
+    }
+    else
+    {
+        for ( std::size_t i = 0; i < jobs.size(); ++i )
+            decompressJob( i );
+    }
+
+    return result;
+}
+
+bool WebGPUlib::loadDDS( const std::filesystem::path& filePath, TextureData& textureData, uint32_t firstMip )
+{
+    std::ifstream file( filePath, std::ios::binary );
+    if ( !file )
+        return false;
+
+    return readDDS( file, filePath.string(), textureData, firstMip, false );
+}
+
+bool WebGPUlib::loadDDSHeader( const std::filesystem::path& filePath, TextureData& textureData )
+{
+    std::ifstream file( filePath, std::ios::binary );
+    if ( !file )
+        return false;
+
+    return readDDS( file, filePath.string(), textureData, 0, true );
+}
+
+bool WebGPUlib::loadDDS( const uint8_t* data, std::size_t size, const std::string& fileName, TextureData& textureData,
+                         uint32_t firstMip )
+{
+    MemoryStreamBuffer buffer( data, size );
+    std::istream       stream( &buffer );
+
+    return readDDS( stream, fileName, textureData, firstMip, false );
+}
+
+bool WebGPUlib::loadDDSHeader( const uint8_t* data, std::size_t size, const std::string& fileName,
+                               TextureData& textureData )
+{
+    MemoryStreamBuffer buffer( data, size );
+    std::istream       stream( &buffer );
+
+    return readDDS( stream, fileName, textureData, 0, true );
+}
+
+bool WebGPUlib::saveDDS( const std::filesystem::path& filePath, const TextureData& textureData )
+{
+    const uint32_t dxgiFormat = toDXGIFormat( textureData.format );
+    if ( dxgiFormat == 0 )
+    {
+        std::cerr << "ERROR: Unsupported DDS pixel format: " << filePath << std::endl;
+        return false;
+    }
+
+    std::ofstream file( filePath, std::ios::binary );
+    if ( !file )
+    {
+        std::cerr << "ERROR: Failed to open file for writing: " << filePath << std::endl;
+        return false;
+    }
+
+    DDSHeader header {};
+    header.size  = sizeof( DDSHeader );
+    header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header.height            = textureData.height;
+    header.width             = textureData.width;
+    header.pitchOrLinearSize = static_cast<uint32_t>( textureData.mips.empty() ? 0 : textureData.mips[0].size() );
+    header.mipMapCount       = static_cast<uint32_t>( textureData.mips.size() );
+    header.pixelFormat.size  = sizeof( DDSPixelFormat );
+    header.pixelFormat.flags = DDPF_FOURCC;
+    header.pixelFormat.fourCC = makeFourCC( 'D', 'X', '1', '0' );
+    header.caps               = DDSCAPS_TEXTURE | ( textureData.mips.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0 );
+
+    if ( textureData.cookKey != 0 )
+    {
+        header.reserved1[0] = DDS_COOK_TAG;
+        header.reserved1[1] = textureData.cookKey;
+    }
+
+    DDSHeaderDX10 headerDX10 {};
+    headerDX10.dxgiFormat        = dxgiFormat;
+    headerDX10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+    headerDX10.arraySize         = 1;
+
+    file.write( reinterpret_cast<const char*>( &DDS_MAGIC ), sizeof( DDS_MAGIC ) );
+    file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    file.write( reinterpret_cast<const char*>( &headerDX10 ), sizeof( headerDX10 ) );
+
+    for ( const auto& data: textureData.mips )
+        file.write( reinterpret_cast<const char*>( data.data() ), static_cast<std::streamsize>( data.size() ) );
+
+    return static_cast<bool>( file );
+}
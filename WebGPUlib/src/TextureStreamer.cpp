@@ -0,0 +1,324 @@
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
+#include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/Queue.hpp>
+#include <WebGPUlib/Texture.hpp>
+#include <WebGPUlib/TextureStreamer.hpp>
+#include <WebGPUlib/ThreadPool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+using namespace WebGPUlib;
+
+namespace
+{
+// Load the mips [firstMip, endMip) of a DDS file that has been read into memory. The first mip of the result
+// is firstMip. Block compressed mips are transcoded to RGBA8 if transcode is true.
+TextureData loadMips( const std::vector<uint8_t>& data, const std::string& fileName, uint32_t firstMip,
+                      uint32_t endMip, bool transcode )
+{
+    TextureData textureData;
+    if ( !loadDDS( data.data(), data.size(), fileName, textureData, firstMip ) )
+        return {};
+
+    endMip = std::min( endMip, static_cast<uint32_t>( textureData.mips.size() ) );
+    if ( firstMip >= endMip )
+        return {};
+
+    TextureData result;
+    result.format = textureData.format;
+    result.width  = std::max( textureData.width >> firstMip, 1u );
+    result.height = std::max( textureData.height >> firstMip, 1u );
+    result.mips.assign( std::make_move_iterator( textureData.mips.begin() + firstMip ),
+                        std::make_move_iterator( textureData.mips.begin() + endMip ) );
+
+    if ( transcode && isBlockCompressed( result.format ) )
+        result = decompressTexture( result );
+
+    return result;
+}
+}  // namespace
+
+uint64_t StreamedTexture::getResidentSize( uint32_t mip ) const
+{
+    uint64_t size = 0;
+    for ( uint32_t i = mip; i < mipLevelCount; ++i )
+        size += getMipSize( format, width, height, i );
+
+    return size;
+}
+
+TextureStreamer::TextureStreamer( uint64_t budget )
+: budget { budget }
+{}
+
+TextureStreamer::~TextureStreamer()
+{
+    // Wait for the loads that are still running on the worker threads.
+    for ( auto& texture: textures )
+    {
+        if ( texture->pendingRead.valid() )
+            texture->pendingRead.wait();
+        if ( texture->pendingLoad.valid() )
+            texture->pendingLoad.wait();
+    }
+}
+
+std::shared_ptr<StreamedTexture> TextureStreamer::load( const std::filesystem::path& filePath )
+{
+    auto& device = Device::get();
+
+    // The smallest mips are loaded from the same read as the header.
+    const std::vector<uint8_t> data     = device.readFileAsync( filePath ).get();
+    const std::string          fileName = filePath.string();
+
+    TextureData header;
+    if ( data.empty() || !loadDDSHeader( data.data(), data.size(), fileName, header ) )
+        return nullptr;
+
+    const bool transcode =
+        isBlockCompressed( header.format ) && !device.hasFeature( WGPUFeatureName_TextureCompressionBC );
+
+    auto texture           = std::make_shared<StreamedTexture>();
+    texture->filePath      = filePath;
+    texture->format        = transcode ? WGPUTextureFormat_RGBA8Unorm : header.format;
+    texture->width         = header.width;
+    texture->height        = header.height;
+    texture->mipLevelCount = static_cast<uint32_t>( header.mips.size() );
+
+    // The size of the first mip of a block compressed texture must be a multiple of the block size.
+    // The smallest mip that satisfies this is always resident.
+    uint32_t minResidentMip = texture->mipLevelCount - 1;
+    if ( isBlockCompressed( texture->format ) )
+    {
+        minResidentMip = 0;
+        for ( uint32_t mip = 1; mip < texture->mipLevelCount; ++mip )
+        {
+            const uint32_t w = header.width >> mip;
+            const uint32_t h = header.height >> mip;
+            if ( w < 4 || h < 4 || ( w % 4 ) != 0 || ( h % 4 ) != 0 )
+                break;
+
+            minResidentMip = mip;
+        }
+    }
+    texture->minResidentMip = minResidentMip;
+    texture->requestedMip   = minResidentMip;
+
+    TextureData textureData = loadMips( data, fileName, minResidentMip, texture->mipLevelCount, transcode );
+    if ( textureData.mips.empty() )
+        return nullptr;
+
+    swapTexture( *texture, textureData, minResidentMip );
+
+    textures.push_back( texture );
+
+    return texture;
+}
+
+void TextureStreamer::addMaterial( const std::shared_ptr<StreamedTexture>& texture,
+                                   const std::shared_ptr<Material>& material, TextureSlot slot )
+{
+    texture->materials.push_back( { material, slot } );
+    materialTextures[material].push_back( texture.get() );
+
+    material->setTexture( slot, texture->getTexture() );
+}
+
+void TextureStreamer::request( StreamedTexture& texture, uint32_t mip )
+{
+    // Keep the largest mip that was requested in this frame.
+    if ( texture.lastUsedFrame == frame )
+        texture.requestedMip = std::min( texture.requestedMip, mip );
+    else
+        texture.requestedMip = mip;
+
+    texture.lastUsedFrame = frame;
+}
+
+void TextureStreamer::request( const std::shared_ptr<Material>& material, float screenSize )
+{
+    auto iter = materialTextures.find( material );
+    if ( iter == materialTextures.end() )
+        return;
+
+    for ( auto texture: iter->second )
+        request( *texture, getDesiredMip( texture->width, texture->height, screenSize ) );
+}
+
+bool TextureStreamer::isStreamed( const Texture& texture ) const
+{
+    return std::any_of( textures.begin(), textures.end(),
+                        [&]( const auto& streamedTexture ) { return streamedTexture->texture.get() == &texture; } );
+}
+
+uint32_t TextureStreamer::getDesiredMip( uint32_t width, uint32_t height, float screenSize )
+{
+    const float size = static_cast<float>( std::max( width, height ) );
+    if ( screenSize >= size )
+        return 0;
+
+    return static_cast<uint32_t>( std::floor( std::log2( size / std::max( screenSize, 1.0f ) ) ) );
+}
+
+void TextureStreamer::update()
+{
+    // Forget the materials that have been destroyed.
+    for ( auto iter = materialTextures.begin(); iter != materialTextures.end(); )
+    {
+        if ( iter->first.expired() )
+            iter = materialTextures.erase( iter );
+        else
+            ++iter;
+    }
+
+    const bool transcode  = !Device::get().hasFeature( WGPUFeatureName_TextureCompressionBC );
+    auto&      threadPool = Device::get().getThreadPool();
+
+    // Load the new mips of the files that have been read and swap the textures whose mips have been loaded.
+    for ( auto& texture: textures )
+    {
+        if ( texture->pendingRead.valid() &&
+             texture->pendingRead.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready )
+        {
+            texture->pendingLoad = threadPool.submit(
+                [data = texture->pendingRead.get(), fileName = texture->filePath.string(),
+                 firstMip = texture->pendingMip, endMip = texture->residentMip, transcode] {
+                    return loadMips( data, fileName, firstMip, endMip, transcode );
+                } );
+        }
+
+        if ( texture->pendingLoad.valid() &&
+             texture->pendingLoad.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready )
+        {
+            TextureData textureData = texture->pendingLoad.get();
+            if ( !textureData.mips.empty() )
+                swapTexture( *texture, textureData, texture->pendingMip );
+        }
+    }
+
+    // Determine the mips that should be resident. Textures that were not used recently only keep their smallest mips.
+    std::vector<uint32_t> targetMips( textures.size() );
+    uint64_t              targetSize = 0;
+    for ( std::size_t i = 0; i < textures.size(); ++i )
+    {
+        const auto& texture = *textures[i];
+        if ( texture.lastUsedFrame + evictFrames >= frame )
+            targetMips[i] = std::min( texture.requestedMip, texture.minResidentMip );
+        else
+            targetMips[i] = texture.minResidentMip;
+
+        targetSize += texture.getResidentSize( targetMips[i] );
+    }
+
+    // Evict the mips of the least recently used textures until the requested mips fit in the budget.
+    if ( targetSize > budget )
+    {
+        std::vector<std::size_t> lru( textures.size() );
+        for ( std::size_t i = 0; i < lru.size(); ++i )
+            lru[i] = i;
+
+        std::stable_sort( lru.begin(), lru.end(), [&]( std::size_t a, std::size_t b ) {
+            return textures[a]->lastUsedFrame < textures[b]->lastUsedFrame;
+        } );
+
+        for ( auto i: lru )
+        {
+            const auto& texture = *textures[i];
+            while ( targetSize > budget && targetMips[i] < texture.minResidentMip )
+            {
+                targetSize -= texture.getResidentSize( targetMips[i] ) - texture.getResidentSize( targetMips[i] + 1 );
+                ++targetMips[i];
+            }
+
+            if ( targetSize <= budget )
+                break;
+        }
+    }
+
+    // Evict the mips first to free memory for the loads. The mips that stay resident are copied on the GPU,
+    // so evictions don't read the file.
+    uint32_t numPendingLoads = 0;
+    for ( std::size_t i = 0; i < textures.size(); ++i )
+    {
+        auto& texture = *textures[i];
+        if ( texture.isLoading() )
+            ++numPendingLoads;
+        else if ( targetMips[i] > texture.residentMip )
+            swapTexture( texture, {}, targetMips[i] );
+    }
+
+    // Start reading the files of the textures whose missing mips must be loaded.
+    for ( std::size_t i = 0; i < textures.size() && numPendingLoads < maxPendingLoads; ++i )
+    {
+        auto& texture = *textures[i];
+        if ( texture.isLoading() || targetMips[i] >= texture.residentMip )
+            continue;
+
+        texture.pendingMip  = targetMips[i];
+        texture.pendingRead = Device::get().readFileAsync( texture.filePath );
+
+        ++numPendingLoads;
+    }
+
+    ++frame;
+}
+
+void TextureStreamer::swapTexture( StreamedTexture& texture, const TextureData& textureData, uint32_t mip )
+{
+    auto& device = Device::get();
+    auto  queue  = device.getQueue();
+
+    std::string label = texture.filePath.filename().string();
+
+    // The mips that stay resident are copied to the next texture, so the texture is created with
+    // WGPUTextureUsage_CopySrc (Device::createTextureArrays skips streamed textures, see isStreamed).
+    WGPUTextureDescriptor textureDesc {};
+    textureDesc.label         = label.c_str();
+    textureDesc.dimension     = WGPUTextureDimension_2D;
+    textureDesc.format        = texture.format;
+    textureDesc.size          = { std::max( texture.width >> mip, 1u ), std::max( texture.height >> mip, 1u ), 1u };
+    textureDesc.sampleCount   = 1;
+    textureDesc.mipLevelCount = texture.mipLevelCount - mip;
+    textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst | WGPUTextureUsage_CopySrc;
+
+    auto newTexture = device.createTexture( textureDesc );
+
+    // Upload the new mips and copy the other mips from the current texture (whose first mip is the resident mip).
+    std::shared_ptr<ComputeCommandBuffer> commandBuffer;
+    for ( uint32_t i = 0; i < textureDesc.mipLevelCount; ++i )
+    {
+        if ( i < textureData.mips.size() )
+        {
+            const auto& data = textureData.mips[i];
+            queue->writeTexture( *newTexture, i, data.data(), data.size() );
+        }
+        else if ( texture.texture && mip + i >= texture.residentMip )
+        {
+            if ( !commandBuffer )
+                commandBuffer = queue->createComputeCommandBuffer();
+
+            commandBuffer->copyTextureToTexture( *texture.texture, mip + i - texture.residentMip, *newTexture, i );
+        }
+    }
+
+    if ( commandBuffer )
+        queue->submit( *commandBuffer );
+
+    if ( texture.texture )
+        residentSize -= texture.getResidentSize( texture.residentMip );
+
+    texture.texture     = newTexture;
+    texture.residentMip = mip;
+
+    residentSize += texture.getResidentSize( mip );
+
+    // Replace the texture of the materials (the previous texture is released when it is no longer used).
+    for ( auto& [weakMaterial, slot]: texture.materials )
+    {
+        if ( auto material = weakMaterial.lock() )
+            material->setTexture( slot, newTexture, material->getTextureSwizzle( slot ) );
+    }
+}
@@ -0,0 +1,90 @@
+#include <WebGPUlib/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+using namespace WebGPUlib;
+
+ThreadPool::ThreadPool( std::size_t numThreads )
+{
+#if defined( __EMSCRIPTEN__ ) && !defined( __EMSCRIPTEN_PTHREADS__ )
+    // Threads are not available.
+    numThreads = 0;
+#endif
+
+    threads.reserve( numThreads );
+    for ( std::size_t i = 0; i < numThreads; ++i )
+        threads.emplace_back( &ThreadPool::workerThread, this );
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock( mutex );
+        stop = true;
+    }
+    condition.notify_all();
+
+    for ( auto& thread: threads )
+        thread.join();
+}
+
+void ThreadPool::parallelFor( std::size_t count, const std::function<void( std::size_t )>& func )
+{
+    if ( count == 0 )
+        return;
+
+    // Each participating thread takes the next index until all indices are processed.
+    std::atomic_size_t next { 0 };
+    auto               work = [&] {
+        for ( std::size_t i = next++; i < count; i = next++ )
+            func( i );
+    };
+
+    const std::size_t numTasks = std::min( threads.size(), count - 1 );
+
+    std::vector<std::future<void>> futures;
+    futures.reserve( numTasks );
+    for ( std::size_t i = 0; i < numTasks; ++i )
+        futures.emplace_back( submit( work ) );
+
+    work();
+
+    for ( auto& future: futures )
+        future.get();
+}
+
+void ThreadPool::enqueue( std::function<void()> task )
+{
+    if ( threads.empty() )
+    {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard lock( mutex );
+        tasks.push( std::move( task ) );
+    }
+    condition.notify_one();
+}
+
+void ThreadPool::workerThread()
+{
+    while ( true )
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock( mutex );
+            condition.wait( lock, [this] { return stop || !tasks.empty(); } );
+
+            if ( stop && tasks.empty() )
+                return;
+
+            task = std::move( tasks.front() );
+            tasks.pop();
+        }
+
+        task();
+    }
+}
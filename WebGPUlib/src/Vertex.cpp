@@ -1,5 +1,12 @@
 #include <WebGPUlib/Vertex.hpp>
 
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat3x3.hpp>
+
+#include <cmath>
 #include <cstddef>
 
 using namespace WebGPUlib;
@@ -48,4 +55,85 @@ WGPUVertexAttribute VertexPositionNormalTangentBitangentTexture::attributes[5] =
         offsetof(VertexPositionNormalTangentBitangentTexture, texCoord),
         4
     }
-};
\ No newline at end of file
+};
+
+WGPUVertexAttribute VertexPositionQTangentTexture::attributes[3] = {
+    {
+        WGPUVertexFormat_Float32x3,
+        offsetof(VertexPositionQTangentTexture, position),
+        0,
+    },
+    {
+        WGPUVertexFormat_Snorm16x4,
+        offsetof(VertexPositionQTangentTexture, qTangent),
+        1
+    },
+    {
+        WGPUVertexFormat_Float16x2,
+        offsetof(VertexPositionQTangentTexture, texCoord),
+        2
+    }
+};
+
+static int16_t toSnorm16( float v )
+{
+    return static_cast<int16_t>( std::round( glm::clamp( v, -1.0f, 1.0f ) * 32767.0f ) );
+}
+
+VertexPositionQTangentTexture::VertexPositionQTangentTexture( const VertexPositionNormalTangentBitangentTexture& vertex )
+: position( vertex.position )
+, qTangent( encodeQTangent( vertex.normal, vertex.tangent, vertex.bitangent ) )
+, texCoord( glm::packHalf1x16( vertex.texCoord.x ), glm::packHalf1x16( vertex.texCoord.y ) )
+{}
+
+bool VertexPositionQTangentTexture::canEncodeTexCoord( const glm::vec3& texCoord, float maxError )
+{
+    for ( int i = 0; i < 2; ++i )
+    {
+        float decoded = glm::unpackHalf1x16( glm::packHalf1x16( texCoord[i] ) );
+        if ( !std::isfinite( decoded ) || std::abs( decoded - texCoord[i] ) > maxError )
+            return false;
+    }
+
+    return true;
+}
+
+glm::i16vec4 WebGPUlib::encodeQTangent( const glm::vec3& normal, const glm::vec3& tangent, const glm::vec3& bitangent )
+{
+    glm::vec3 n = glm::dot( normal, normal ) > 0.0f ? glm::normalize( normal ) : glm::vec3 { 0, 0, 1 };
+
+    // Orthogonalize the tangent with respect to the normal (Gram-Schmidt).
+    glm::vec3 t = tangent - n * glm::dot( n, tangent );
+    if ( glm::dot( t, t ) < 1e-12f )
+    {
+        // The tangent is missing or parallel to the normal.
+        t = std::abs( n.x ) < 0.9f ? glm::vec3 { 1, 0, 0 } : glm::vec3 { 0, 1, 0 };
+        t = t - n * glm::dot( n, t );
+    }
+    t = glm::normalize( t );
+
+    glm::vec3 b         = glm::cross( n, t );
+    bool      reflected = glm::dot( b, bitangent ) < 0.0f;
+    glm::quat q         = glm::normalize( glm::quat_cast( glm::mat3 { t, b, n } ) );
+
+    // q and -q represent the same rotation, so the sign of w is free to
+    // store the handedness of the tangent frame.
+    if ( q.w < 0.0f )
+        q = -q;
+
+    // Make sure w does not quantize to 0, otherwise the sign is lost.
+    constexpr float bias = 1.0f / 32767.0f;
+    if ( q.w < bias )
+    {
+        float s = std::sqrt( 1.0f - bias * bias );
+        q.x *= s;
+        q.y *= s;
+        q.z *= s;
+        q.w = bias;
+    }
+
+    if ( reflected )
+        q = -q;
+
+    return { toSnorm16( q.x ), toSnorm16( q.y ), toSnorm16( q.z ), toSnorm16( q.w ) };
+}
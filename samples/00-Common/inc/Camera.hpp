@@ -29,6 +29,10 @@ public:
 
     const glm::mat4& getProjectionMatrix() const;
 
+    // Get the projected size of an object of the given (world-space) size at the
+    // given distance from the camera as a fraction of the viewport height.
+    float getProjectedSize( float size, float distance ) const;
+
 private:
     void updateViewMatrix() const;
     void updateProjectionMatrix() const;
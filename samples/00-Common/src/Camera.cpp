@@ -1,5 +1,8 @@
 #include <Camera.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 void Camera::setLookAt( const glm::vec3& eye, const glm::vec3& target, const glm::vec3& up )
 {
     viewMatrix = glm::lookAtRH( eye, target, up );
@@ -58,6 +61,13 @@ const glm::mat4& Camera::getProjectionMatrix() const
     return projectionMatrix;
 }
 
+float Camera::getProjectedSize( float size, float distance ) const
+{
+    distance = std::max( distance, near );
+
+    return size / ( 2.0f * distance * std::tan( fov * 0.5f ) );
+}
+
 void Camera::updateViewMatrix() const
 {
     auto rotationMatrix    = glm::mat4_cast( glm::inverse( rotation ) );
@@ -4,7 +4,7 @@
 
 #include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/GraphicsCommandBuffer.hpp>
-#include <WebGPUlib/Material.hpp>
+#include <WebGPUlib/ShaderReflection.hpp>
 #include <WebGPUlib/Surface.hpp>
 #include <WebGPUlib/Vertex.hpp>
 
@@ -12,84 +12,26 @@
 
 using namespace WebGPUlib;
 
-TextureLitPipelineState::TextureLitPipelineState()
+TextureLitPipelineState::TextureLitPipelineState( VertexLayout vertexLayout )
 {
     const char* shaderCode = {
+#include <VertexDecode.wgsl>
 #include "TextureLitShader.wgsl"
     };
 
-    WGPUDevice        device        = Device::get().getWGPUDevice();
     WGPUTextureFormat surfaceFormat = Device::get().getSurface()->getSurfaceFormat();
 
     // Load the shader module.
-    WGPUShaderModuleWGSLDescriptor shaderCodeDesc {};
-    shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
-    shaderCodeDesc.chain.next  = nullptr;
-    shaderCodeDesc.code        = shaderCode;
-
-    WGPUShaderModuleDescriptor shaderModuleDescriptor {};
-    shaderModuleDescriptor.nextInChain = &shaderCodeDesc.chain;
-    WGPUShaderModule shaderModule      = wgpuDeviceCreateShaderModule( device, &shaderModuleDescriptor );
-
-    // Setup the binding layout.
-    WGPUBindGroupLayoutEntry bindGroupLayoutEntries[12] {};
-
-    // @group( 0 ) @binding( 0 ) var<uniform> matrices : Matrices;
-    bindGroupLayoutEntries[0].binding               = 0;
-    bindGroupLayoutEntries[0].visibility            = WGPUShaderStage_Vertex;
-    bindGroupLayoutEntries[0].buffer.type           = WGPUBufferBindingType_Uniform;
-    bindGroupLayoutEntries[0].buffer.minBindingSize = sizeof( Matrices );
-
-    // @group( 0 ) @binding( 1 ) var<uniform> material : Material;
-    bindGroupLayoutEntries[1].binding               = 1;
-    bindGroupLayoutEntries[1].visibility            = WGPUShaderStage_Fragment;
-    bindGroupLayoutEntries[1].buffer.type           = WGPUBufferBindingType_Uniform;
-    bindGroupLayoutEntries[1].buffer.minBindingSize = sizeof( MaterialProperties );
-
-    // @group( 0 ) @binding( 2 ) var ambientTexture : texture_2d<f32>;
-    // @group( 0 ) @binding( 3 ) var emissiveTexture : texture_2d<f32>;
-    // @group( 0 ) @binding( 4 ) var diffuseTexture : texture_2d<f32>;
-    // @group( 0 ) @binding( 5 ) var specularTexture : texture_2d<f32>;
-    // @group( 0 ) @binding( 6 ) var specularPowerTexture : texture_2d<f32>;
-    // @group( 0 ) @binding( 7 ) var normalTexture : texture_2d<f32>;
-    // @group( 0 ) @binding( 8 ) var bumpTexture : texture_2d<f32>;
-    // @group( 0 ) @binding( 9 ) var opacityTexture : texture_2d<f32>;
-    for ( int binding = 2; binding <= 9; ++binding )
-    {
-        bindGroupLayoutEntries[binding].binding               = binding;
-        bindGroupLayoutEntries[binding].visibility            = WGPUShaderStage_Fragment;
-        bindGroupLayoutEntries[binding].texture.sampleType    = WGPUTextureSampleType_Float;
-        bindGroupLayoutEntries[binding].texture.viewDimension = WGPUTextureViewDimension_2D;
-    }
+    WGPUShaderModule shaderModule = Device::get().getShaderModule( shaderCode, "Texture Lit Shader Module" );
 
-    // @group( 0 ) @binding( 10 ) var linearRepeatSampler : sampler;
-    bindGroupLayoutEntries[10].binding      = 10;
-    bindGroupLayoutEntries[10].visibility   = WGPUShaderStage_Fragment;
-    bindGroupLayoutEntries[10].sampler.type = WGPUSamplerBindingType_Filtering;
-
-    // @group( 0 ) @binding( 11 ) var<storage> pointLights : array<PointLight>;
-    bindGroupLayoutEntries[11].binding               = 11;
-    bindGroupLayoutEntries[11].visibility            = WGPUShaderStage_Fragment;
-    bindGroupLayoutEntries[11].buffer.type           = WGPUBufferBindingType_ReadOnlyStorage;
-    bindGroupLayoutEntries[11].buffer.minBindingSize = 0; //sizeof(PointLight);
-
-    // @group( 0 ) @binding( 12 ) var<storage> spotLights : array<SpotLight>;
-    //bindGroupLayoutEntries[12].binding               = 12;
-    //bindGroupLayoutEntries[12].visibility            = WGPUShaderStage_Fragment;
-    //bindGroupLayoutEntries[12].buffer.type           = WGPUBufferBindingType_ReadOnlyStorage;
-    //bindGroupLayoutEntries[12].buffer.minBindingSize = 0; // sizeof(SpotLight);
-
-    // Setup the binding group.
-    WGPUBindGroupLayoutDescriptor bindGroupLayoutDescriptor {};
-    bindGroupLayoutDescriptor.entryCount = std::size( bindGroupLayoutEntries );
-    bindGroupLayoutDescriptor.entries    = bindGroupLayoutEntries;
-    bindGroupLayout                      = wgpuDeviceCreateBindGroupLayout( device, &bindGroupLayoutDescriptor );
-
-    // Setup the pipeline layout.
-    WGPUPipelineLayoutDescriptor pipelineLayoutDescriptor {};
-    pipelineLayoutDescriptor.bindGroupLayoutCount = 1;
-    pipelineLayoutDescriptor.bindGroupLayouts     = &bindGroupLayout;
-    WGPUPipelineLayout pipelineLayout             = wgpuDeviceCreatePipelineLayout( device, &pipelineLayoutDescriptor );
+    // The bind group layouts are derived from the shader code.
+    // Group 0: per-frame (lights), group 1: per-material, group 2: per-object (matrices).
+    // The per-material group declares the same bindings as the material bind groups, so it resolves to the
+    // layout of the device (see Material::getBindGroup). The material properties are bound with a dynamic offset.
+    ShaderReflection reflection { shaderCode };
+    reflection.setDynamicOffset( 1, 0 );
+    WGPUPipelineLayout     pipelineLayout =
+        Device::get().getPipelineLayout( reflection, bindGroupLayouts, "Texture Lit Pipeline Layout" );
 
     // Setup the vertex layout.
     // @location(0) position : vec3f,
@@ -130,6 +72,20 @@ TextureLitPipelineState::TextureLitPipelineState()
     vertexBufferLayout.attributeCount = std::size( vertexAttributes );
     vertexBufferLayout.attributes     = vertexAttributes;
 
+    const char* vertexEntryPoint = "vs_main";
+
+    if ( vertexLayout == VertexLayout::PositionQTangentTexture )
+    {
+        // @location(0) position : vec3f,
+        // @location(1) qTangent : vec4f,
+        // @location(2) uv       : vec2f,
+        vertexBufferLayout.arrayStride    = sizeof( VertexPositionQTangentTexture );
+        vertexBufferLayout.attributeCount = std::size( VertexPositionQTangentTexture::attributes );
+        vertexBufferLayout.attributes     = VertexPositionQTangentTexture::attributes;
+
+        vertexEntryPoint = "vs_main_qtangent";
+    }
+
     WGPUPrimitiveState primitiveState {};
     primitiveState.topology         = WGPUPrimitiveTopology_TriangleList;
     primitiveState.stripIndexFormat = WGPUIndexFormat_Undefined;
@@ -139,7 +95,7 @@ TextureLitPipelineState::TextureLitPipelineState()
     // Setup the vertex shader stage.
     WGPUVertexState vertexState {};
     vertexState.module        = shaderModule;
-    vertexState.entryPoint    = "vs_main";
+    vertexState.entryPoint    = vertexEntryPoint;
     vertexState.constantCount = 0;
     vertexState.constants     = nullptr;
     vertexState.constants     = nullptr;
@@ -194,17 +150,12 @@ TextureLitPipelineState::TextureLitPipelineState()
     pipelineDescriptor.depthStencil = &depthStencilState;
     pipelineDescriptor.multisample  = multisampleState;
     pipelineDescriptor.fragment     = &fragmentState;
-    pipeline                        = wgpuDeviceCreateRenderPipeline( device, &pipelineDescriptor );
 
-    wgpuShaderModuleRelease( shaderModule );
-    wgpuPipelineLayoutRelease( pipelineLayout );
+    // The pipeline is compiled in the background. Draws are skipped until it is ready (see isReady).
+    pipelineKey = Device::get().getRenderPipelineAsync( pipelineDescriptor );
 }
 
-TextureLitPipelineState::~TextureLitPipelineState()
-{
-    if ( bindGroupLayout )
-        wgpuBindGroupLayoutRelease( bindGroupLayout );
-}
+TextureLitPipelineState::~TextureLitPipelineState() = default;
 
 void TextureLitPipelineState::bind( GraphicsCommandBuffer& commandBuffer )
 {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <WebGPUlib/GraphicsPipelineState.hpp>
+#include <WebGPUlib/Vertex.hpp>
 
 namespace WebGPUlib
 {
@@ -10,7 +11,8 @@ class Surface;
 class TextureLitPipelineState : public GraphicsPipelineState
 {
 public:
-    TextureLitPipelineState();
+    explicit TextureLitPipelineState(
+        VertexLayout vertexLayout = VertexLayout::PositionNormalTangentBitangentTexture );
     ~TextureLitPipelineState() override;
 
     TextureLitPipelineState( const TextureLitPipelineState& )         = delete;
@@ -19,16 +21,7 @@ public:
     TextureLitPipelineState&   operator=( const TextureLitPipelineState& )       = delete;
     TextureLitPipelineState& operator=( TextureLitPipelineState&& ) noexcept = delete;
 
-    WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex ) override
-    {
-        // This pipeline only has a single bind group.
-        return bindGroupLayout;
-    }
-
 protected:
     void bind( GraphicsCommandBuffer& commandBuffer ) override;
-
-private:
-    WGPUBindGroupLayout bindGroupLayout = nullptr;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
@@ -8,6 +8,13 @@ struct VertexIn
     @location(4) uv       : vec3f,
 };
 
+struct VertexInQTangent
+{
+    @location(0) position : vec3f,
+    @location(1) qTangent : vec4f,
+    @location(2) uv       : vec2f,
+};
+
 struct VertexOut
 {
     @location(0) positionVS : vec3f,
@@ -52,6 +59,8 @@ struct Material
     indexOfRefraction : f32,
     bumpIntensity : f32,
     //------------------------------------ ( 16 bytes )
+    // The has*Texture flags store the swizzle (bits 0-7) and the array layer (bits 8-31)
+    // of the texture (0 if there is no texture).
     hasAmbientTexture : u32,
     hasDiffuseTexture : u32,
     hasEmissiveTexture : u32,
@@ -62,7 +71,12 @@ struct Material
     hasBumpTexture : u32,
     hasOpacityTexture : u32,
     //------------------------------------ ( 16 bytes )
-    // Total:                              ( 16 * 8 = 128 bytes )
+    hasPackedTexture : u32,
+    padding0 : u32,
+    padding1 : u32,
+    padding2 : u32,
+    //------------------------------------ ( 16 bytes )
+    // Total:                              ( 16 * 9 = 144 bytes )
 };
 
 struct PointLight
@@ -110,26 +124,31 @@ struct LightResult
     ambient : vec4f,
 };
 
-// Constants
-@group(0) @binding(0) var<uniform> matrices : Matrices;
-@group(0) @binding(1) var<uniform> material : Material;
-
-// Textures
-@group(0) @binding(2) var ambientTexture : texture_2d<f32>;
-@group(0) @binding(3) var emissiveTexture : texture_2d<f32>;
-@group(0) @binding(4) var diffuseTexture : texture_2d<f32>;
-@group(0) @binding(5) var specularTexture : texture_2d<f32>;
-@group(0) @binding(6) var specularPowerTexture : texture_2d<f32>;
-@group(0) @binding(7) var normalTexture : texture_2d<f32>;
-@group(0) @binding(8) var bumpTexture : texture_2d<f32>;
-@group(0) @binding(9) var opacityTexture : texture_2d<f32>;
+// Per-frame bind group.
+// Lights
+@group(0) @binding(0) var<storage> pointLights : array<PointLight>;
+// @group(0) @binding(1) var<storage> spotLights : array<SpotLight>;
+
+// Per-material bind group (see Device::getMaterialBindGroupLayout).
+@group(1) @binding(0) var<uniform> material : Material;
+
+// Textures (materials with textures of the same size and format share texture arrays).
+@group(1) @binding(1) var ambientTexture : texture_2d_array<f32>;
+@group(1) @binding(2) var diffuseTexture : texture_2d_array<f32>;
+@group(1) @binding(3) var emissiveTexture : texture_2d_array<f32>;
+@group(1) @binding(4) var specularTexture : texture_2d_array<f32>;
+@group(1) @binding(5) var specularPowerTexture : texture_2d_array<f32>;
+@group(1) @binding(6) var normalTexture : texture_2d_array<f32>;
+@group(1) @binding(7) var bumpTexture : texture_2d_array<f32>;
+@group(1) @binding(8) var opacityTexture : texture_2d_array<f32>;
+// Specular (red), specular power (green) and opacity (blue) (see TextureSlot::Packed).
+@group(1) @binding(9) var packedTexture : texture_2d_array<f32>;
 
 // Sampler.
-@group(0) @binding(10) var linearRepeatSampler : sampler;
+@group(1) @binding(10) var linearRepeatSampler : sampler;
 
-// Lights
-@group(0) @binding(11) var<storage> pointLights : array<PointLight>;
-// @group(0) @binding(12) var<storage> spotLights : array<SpotLight>;
+// Per-object bind group.
+@group(2) @binding(0) var<storage> matrices : array<Matrices>; // Indexed by instance index.
 
 fn toMat3x3( m : mat4x4f ) -> mat3x3f
 {
@@ -137,16 +156,35 @@ fn toMat3x3( m : mat4x4f ) -> mat3x3f
 }
 
 @vertex
-fn vs_main(in: VertexIn) -> VertexOut
+fn vs_main(in: VertexIn, @builtin(instance_index) instanceIndex : u32) -> VertexOut
 {
     var out: VertexOut;
+    let m = matrices[instanceIndex];
     
-    out.positionVS =  (matrices.modelView * vec4f(in.position, 1.0)).xyz;
-    out.normalVS = toMat3x3(matrices.modelViewIT) * in.normal;
-    out.tangentVS = toMat3x3(matrices.modelViewIT) * in.tangent;
-    out.bitangentVS = toMat3x3(matrices.modelViewIT) * in.bitangent;
+    out.positionVS =  (m.modelView * vec4f(in.position, 1.0)).xyz;
+    out.normalVS = toMat3x3(m.modelViewIT) * in.normal;
+    out.tangentVS = toMat3x3(m.modelViewIT) * in.tangent;
+    out.bitangentVS = toMat3x3(m.modelViewIT) * in.bitangent;
     out.uv = in.uv.xy;
-    out.position = matrices.modelViewProjection * vec4f(in.position, 1.0);
+    out.position = m.modelViewProjection * vec4f(in.position, 1.0);
+
+    return out;
+}
+
+@vertex
+fn vs_main_qtangent(in: VertexInQTangent, @builtin(instance_index) instanceIndex : u32) -> VertexOut
+{
+    var out: VertexOut;
+    let m = matrices[instanceIndex];
+
+    let frame = decodeQTangent(in.qTangent);
+
+    out.positionVS =  (m.modelView * vec4f(in.position, 1.0)).xyz;
+    out.normalVS = toMat3x3(m.modelViewIT) * frame.normal;
+    out.tangentVS = toMat3x3(m.modelViewIT) * frame.tangent;
+    out.bitangentVS = toMat3x3(m.modelViewIT) * frame.bitangent;
+    out.uv = in.uv;
+    out.position = m.modelViewProjection * vec4f(in.position, 1.0);
 
     return out;
 }
@@ -254,15 +292,47 @@ fn DoLighting( P : vec3f, N : vec3f, specularPower : f32 ) -> LightResult
     return totalResult;
 }
 
-fn ExpandNormal( n : vec3f ) -> vec3f
+// Texture swizzles (see TextureSwizzle in Material.hpp).
+const SWIZZLE_RRR1 = 2u; // Single channel (grayscale) texture.
+const SWIZZLE_RRRG = 3u; // Two channel (grayscale + alpha) texture.
+const SWIZZLE_GGG1 = 4u; // Green channel of a packed texture.
+const SWIZZLE_BBB1 = 5u; // Blue channel of a packed texture.
+const SWIZZLE_AAA1 = 6u; // Alpha channel of a packed texture.
+const SWIZZLE_PACKED = 7u; // The slot is stored in a channel of the packed texture.
+
+// Check if a material slot is stored in a channel of the packed texture.
+fn IsPacked( flags : u32 ) -> bool
 {
-    return n * 2.0f - 1.0f;
+    return (flags & 0xffu) == SWIZZLE_PACKED;
 }
 
-fn DoNormalMapping( TBN : mat3x3f, tex : texture_2d<f32>, uv : vec2f ) -> vec3f
+// Get the array layer of a material texture from the texture flags.
+fn TextureLayer( flags : u32 ) -> u32
 {
-    var N = textureSample( tex, linearRepeatSampler, uv ).xyz;
-    N = ExpandNormal( N );
+    return flags >> 8u;
+}
+
+// Sample a material texture and expand textures with fewer than 4 channels.
+fn SampleTexture( tex : texture_2d_array<f32>, uv : vec2f, flags : u32 ) -> vec4f
+{
+    let color = textureSample( tex, linearRepeatSampler, uv, TextureLayer( flags ) );
+
+    switch flags & 0xffu {
+        case SWIZZLE_RRR1: { return vec4f( color.rrr, 1.0f ); }
+        case SWIZZLE_RRRG: { return color.rrrg; }
+        case SWIZZLE_GGG1: { return vec4f( color.ggg, 1.0f ); }
+        case SWIZZLE_BBB1: { return vec4f( color.bbb, 1.0f ); }
+        case SWIZZLE_AAA1: { return vec4f( color.aaa, 1.0f ); }
+        default: { return color; }
+    }
+}
+
+fn DoNormalMapping( TBN : mat3x3f, tex : texture_2d_array<f32>, uv : vec2f, layer : u32 ) -> vec3f
+{
+    // Only the x and y components are used so that compressed normal maps (BC5)
+    // can be used which only store two channels. The z component is reconstructed.
+    let xy = textureSample( tex, linearRepeatSampler, uv, layer ).xy * 2.0f - 1.0f;
+    var N = vec3f( xy, sqrt( saturate( 1.0f - dot( xy, xy ) ) ) );
 
     // Transfrom normal from texture space to view space.
     N = TBN * N;
@@ -270,11 +340,11 @@ fn DoNormalMapping( TBN : mat3x3f, tex : texture_2d<f32>, uv : vec2f ) -> vec3f
     return normalize(N);
 }
 
-fn DoBumpMapping( TBN : mat3x3f, tex : texture_2d<f32>, uv : vec2f, bumpScale : f32 ) -> vec3f
+fn DoBumpMapping( TBN : mat3x3f, tex : texture_2d_array<f32>, uv : vec2f, layer : u32, bumpScale : f32 ) -> vec3f
 {
-    let height_00 = textureSample( tex, linearRepeatSampler, uv ).r * bumpScale;
-    let height_10 = textureSample( tex, linearRepeatSampler, uv, vec2i(1, 0) ).r * bumpScale;
-    let height_01 = textureSample( tex, linearRepeatSampler, uv, vec2i(0, 1) ).r * bumpScale;
+    let height_00 = textureSample( tex, linearRepeatSampler, uv, layer ).r * bumpScale;
+    let height_10 = textureSample( tex, linearRepeatSampler, uv, layer, vec2i(1, 0) ).r * bumpScale;
+    let height_01 = textureSample( tex, linearRepeatSampler, uv, layer, vec2i(0, 1) ).r * bumpScale;
 
     let p_00 = vec3f( 0, 0, height_00 );
     let p_10 = vec3f( 0, 0, height_10 );
@@ -292,11 +362,22 @@ fn DoBumpMapping( TBN : mat3x3f, tex : texture_2d<f32>, uv : vec2f, bumpScale :
 @fragment
 fn fs_main(in: FragmentIn) -> @location(0) vec4f {
     
+    // The packed texture is sampled once for all of the slots that it stores.
+    var packed = vec4f( 1.0f );
+    if (material.hasPackedTexture != 0)
+    {
+        packed = SampleTexture(packedTexture, in.uv, material.hasPackedTexture);
+    }
+
     // Use the alpha component of the diffuse color for opacity.
     var opacity = material.diffuse.a;
-    if (material.hasOpacityTexture != 0)
+    if (IsPacked(material.hasOpacityTexture))
+    {
+        opacity = packed.b;
+    }
+    else if (material.hasOpacityTexture != 0)
     {
-        opacity = textureSample(opacityTexture, linearRepeatSampler, in.uv ).r;
+        opacity = SampleTexture(opacityTexture, in.uv, material.hasOpacityTexture).r;
     }
 
     if (opacity < 0.1)
@@ -312,23 +393,31 @@ fn fs_main(in: FragmentIn) -> @location(0) vec4f {
 
     if (material.hasAmbientTexture != 0)
     {
-        ambient = textureSample(ambientTexture, linearRepeatSampler, in.uv);
+        ambient = SampleTexture(ambientTexture, in.uv, material.hasAmbientTexture);
     }
     if (material.hasEmissiveTexture != 0)
     {
-        emissive = textureSample(emissiveTexture, linearRepeatSampler, in.uv);
+        emissive = SampleTexture(emissiveTexture, in.uv, material.hasEmissiveTexture);
     }
     if (material.hasDiffuseTexture != 0)
     {
-        diffuse = textureSample(diffuseTexture, linearRepeatSampler, in.uv);
+        diffuse = SampleTexture(diffuseTexture, in.uv, material.hasDiffuseTexture);
+    }
+    if (IsPacked(material.hasSpecularTexture))
+    {
+        specular = vec4f( vec3f( packed.r ), 1.0f );
+    }
+    else if (material.hasSpecularTexture != 0)
+    {
+        specular = SampleTexture(specularTexture, in.uv, material.hasSpecularTexture);
     }
-    if (material.hasSpecularTexture != 0)
+    if (IsPacked(material.hasSpecularPowerTexture))
     {
-        specular = textureSample(specularTexture, linearRepeatSampler, in.uv);
+        specularPower *= packed.g;
     }
-    if (material.hasSpecularPowerTexture != 0)
+    else if (material.hasSpecularPowerTexture != 0)
     {
-        specularPower *= textureSample(specularPowerTexture, linearRepeatSampler, in.uv).x;
+        specularPower *= SampleTexture(specularPowerTexture, in.uv, material.hasSpecularPowerTexture).x;
     }
 
     var N = normalize(in.normalVS);
@@ -340,7 +429,7 @@ fn fs_main(in: FragmentIn) -> @location(0) vec4f {
 
         let TBN = mat3x3f(tangent, bitangent, normal);
 
-        N = DoNormalMapping(TBN, normalTexture, in.uv);
+        N = DoNormalMapping(TBN, normalTexture, in.uv, TextureLayer(material.hasNormalTexture));
     }
     else if (material.hasBumpTexture != 0)
     {
@@ -350,7 +439,7 @@ fn fs_main(in: FragmentIn) -> @location(0) vec4f {
 
         let TBN = mat3x3f(tangent, bitangent, normal);
 
-        N = DoBumpMapping(TBN, bumpTexture, in.uv, material.bumpIntensity);
+        N = DoBumpMapping(TBN, bumpTexture, in.uv, TextureLayer(material.hasBumpTexture), material.bumpIntensity);
     }
 
     let lighting = DoLighting( in.positionVS, N, specularPower );
@@ -2,6 +2,7 @@
 
 #include <WebGPUlib/Device.hpp>
 #include <WebGPUlib/GraphicsCommandBuffer.hpp>
+#include <WebGPUlib/ShaderReflection.hpp>
 #include <WebGPUlib/Surface.hpp>
 #include <WebGPUlib/Vertex.hpp>
 
@@ -15,55 +16,15 @@ TextureUnlitPipelineState::TextureUnlitPipelineState()
 #include "TextureUnlitShader.wgsl"
     };
 
-    WGPUDevice        device        = Device::get().getWGPUDevice();
     WGPUTextureFormat surfaceFormat = Device::get().getSurface()->getSurfaceFormat();
 
     // Load the shader module.
-    WGPUShaderModuleWGSLDescriptor shaderCodeDesc {};
-    shaderCodeDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
-    shaderCodeDesc.chain.next  = nullptr;
-    shaderCodeDesc.code        = shaderCode;
-
-    WGPUShaderModuleDescriptor shaderModuleDescriptor {};
-    shaderModuleDescriptor.nextInChain = &shaderCodeDesc.chain;
-    WGPUShaderModule shaderModule      = wgpuDeviceCreateShaderModule( device, &shaderModuleDescriptor );
-
-    // Setup the binding layout.
-    // @group( 0 ) @binding( 0 ) var<uniform> mvp : mat4x4f;
-    // @group( 0 ) @binding( 1 ) var<uniform> color : vec4f;
-    // @group( 0 ) @binding( 2 ) var          albedoTexture : texture_2d<f32>;
-    // @group( 0 ) @binding( 3 ) var          linearRepeatSampler : sampler;
-    WGPUBindGroupLayoutEntry               bindGroupLayoutEntries[4] {};
-    bindGroupLayoutEntries[0].binding               = 0;
-    bindGroupLayoutEntries[0].visibility            = WGPUShaderStage_Vertex;
-    bindGroupLayoutEntries[0].buffer.type           = WGPUBufferBindingType_Uniform;
-    bindGroupLayoutEntries[0].buffer.minBindingSize = sizeof( glm::mat4 );
-
-    bindGroupLayoutEntries[1].binding               = 1;
-    bindGroupLayoutEntries[1].visibility            = WGPUShaderStage_Fragment;
-    bindGroupLayoutEntries[1].buffer.type           = WGPUBufferBindingType_Uniform;
-    bindGroupLayoutEntries[1].buffer.minBindingSize = sizeof( glm::vec4 );
-
-    bindGroupLayoutEntries[2].binding               = 2;
-    bindGroupLayoutEntries[2].visibility            = WGPUShaderStage_Fragment;
-    bindGroupLayoutEntries[2].texture.sampleType    = WGPUTextureSampleType_Float;
-    bindGroupLayoutEntries[2].texture.viewDimension = WGPUTextureViewDimension_2D;
-
-    bindGroupLayoutEntries[3].binding      = 3;
-    bindGroupLayoutEntries[3].visibility   = WGPUShaderStage_Fragment;
-    bindGroupLayoutEntries[3].sampler.type = WGPUSamplerBindingType_Filtering;
-
-    // Setup the binding group.
-    WGPUBindGroupLayoutDescriptor bindGroupLayoutDescriptor {};
-    bindGroupLayoutDescriptor.entryCount = std::size( bindGroupLayoutEntries );
-    bindGroupLayoutDescriptor.entries    = bindGroupLayoutEntries;
-    bindGroupLayout                      = wgpuDeviceCreateBindGroupLayout( device, &bindGroupLayoutDescriptor );
-
-    // Setup the pipeline layout.
-    WGPUPipelineLayoutDescriptor pipelineLayoutDescriptor {};
-    pipelineLayoutDescriptor.bindGroupLayoutCount = 1;
-    pipelineLayoutDescriptor.bindGroupLayouts     = &bindGroupLayout;
-    WGPUPipelineLayout pipelineLayout             = wgpuDeviceCreatePipelineLayout( device, &pipelineLayoutDescriptor );
+    WGPUShaderModule shaderModule = Device::get().getShaderModule( shaderCode, "Texture Unlit Shader Module" );
+
+    // The bind group layouts are derived from the shader code.
+    const ShaderReflection reflection { shaderCode };
+    WGPUPipelineLayout     pipelineLayout =
+        Device::get().getPipelineLayout( reflection, bindGroupLayouts, "Texture Unlit Pipeline Layout" );
 
     // Setup the vertex layout.
     // glm::vec3 position;
@@ -155,17 +116,12 @@ TextureUnlitPipelineState::TextureUnlitPipelineState()
     pipelineDescriptor.depthStencil = &depthStencilState;
     pipelineDescriptor.multisample  = multisampleState;
     pipelineDescriptor.fragment     = &fragmentState;
-    pipeline                        = wgpuDeviceCreateRenderPipeline( device, &pipelineDescriptor );
 
-    wgpuShaderModuleRelease( shaderModule );
-    wgpuPipelineLayoutRelease( pipelineLayout );
+    // The pipeline is compiled in the background. Draws are skipped until it is ready (see isReady).
+    pipelineKey = Device::get().getRenderPipelineAsync( pipelineDescriptor );
 }
 
-TextureUnlitPipelineState::~TextureUnlitPipelineState()
-{
-    if ( bindGroupLayout )
-        wgpuBindGroupLayoutRelease( bindGroupLayout );
-}
+TextureUnlitPipelineState::~TextureUnlitPipelineState() = default;
 
 void TextureUnlitPipelineState::bind( GraphicsCommandBuffer& commandBuffer )
 {
@@ -19,16 +19,7 @@ public:
     TextureUnlitPipelineState& operator=( const TextureUnlitPipelineState& )     = delete;
     TextureUnlitPipelineState& operator=( TextureUnlitPipelineState&& ) noexcept = delete;
 
-    WGPUBindGroupLayout getWGPUBindGroupLayout( uint32_t groupIndex ) override
-    {
-        // This pipeline only has a single bind group.
-        return bindGroupLayout;
-    }
-
 protected:
     void bind( GraphicsCommandBuffer& commandBuffer ) override;
-
-private:
-    WGPUBindGroupLayout bindGroupLayout = nullptr;
 };
 }  // namespace WebGPUlib
\ No newline at end of file
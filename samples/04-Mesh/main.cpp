@@ -7,17 +7,26 @@
 #include <CameraController.hpp>
 #include <Timer.hpp>
 
+#include <WebGPUlib/AssetArchive.hpp>
+#include <WebGPUlib/ComputeCommandBuffer.hpp>
 #include <WebGPUlib/Device.hpp>
+#include <WebGPUlib/GeometryStreamer.hpp>
 #include <WebGPUlib/GraphicsCommandBuffer.hpp>
+#include <WebGPUlib/IndexBuffer.hpp>
 #include <WebGPUlib/Material.hpp>
+#include <WebGPUlib/MaterialTable.hpp>
 #include <WebGPUlib/Mesh.hpp>
+#include <WebGPUlib/MeshletCullingPipelineState.hpp>
+#include <WebGPUlib/PipelineCache.hpp>
 #include <WebGPUlib/Queue.hpp>
 #include <WebGPUlib/RenderTarget.hpp>
 #include <WebGPUlib/Sampler.hpp>
 #include <WebGPUlib/Scene.hpp>
 #include <WebGPUlib/SceneNode.hpp>
+#include <WebGPUlib/StorageBuffer.hpp>
 #include <WebGPUlib/Surface.hpp>
 #include <WebGPUlib/Texture.hpp>
+#include <WebGPUlib/TextureStreamer.hpp>
 #include <WebGPUlib/TextureView.hpp>
 #include <WebGPUlib/UniformBuffer.hpp>
 #include <WebGPUlib/VertexBuffer.hpp>
@@ -29,11 +38,20 @@
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
 
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 #include <glm/gtc/matrix_transform.hpp>  // For matrix transformations.
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <map>
 
 using namespace WebGPUlib;
 
@@ -51,6 +69,17 @@ std::vector<SpotLight>  spotLights;
 
 bool isRunning = true;
 
+// The maximum screen-space error (in pixels) of the selected level of detail.
+float maxPixelError = 1.0f;
+// Switch to a lower level of detail only if its error is below maxPixelError * lodHysteresis
+// to avoid popping between LODs when the camera moves back and forth.
+float lodHysteresis = 0.75f;
+// The currently selected LOD of each mesh instance. The keys point to the nodes and meshes of the scene,
+// so the map must be cleared whenever the scene is replaced or destroyed.
+std::map<std::pair<const SceneNode*, const Mesh*>, uint32_t> selectedLODs;
+
+float viewportHeight = static_cast<float>( WINDOW_HEIGHT );
+
 std::shared_ptr<Mesh>                      cubeMesh;
 std::shared_ptr<Mesh>                      sphereMesh;
 std::shared_ptr<UniformBuffer>             mvpBuffer;
@@ -63,6 +92,18 @@ std::shared_ptr<Sampler>                   linearRepeatSampler;
 std::shared_ptr<Scene>                     scene;
 std::unique_ptr<TextureUnlitPipelineState> textureUnlitPipelineState;
 std::unique_ptr<TextureLitPipelineState>   textureLitPipelineState;
+std::unique_ptr<TextureLitPipelineState>   textureLitQTangentPipelineState;
+
+// Stream the mips of the scene textures based on the screen-space size of the meshes.
+std::unique_ptr<TextureStreamer> textureStreamer;
+// Stream the geometry of the scene meshes that are closest to the camera.
+std::unique_ptr<GeometryStreamer> geometryStreamer;
+
+// Cull the meshlets of the scene meshes on the GPU (toggle with the M key).
+bool                                         useMeshletCulling = false;
+std::unique_ptr<MeshletCullingPipelineState> meshletCullingPipelineState;
+std::shared_ptr<IndexBuffer>                 culledIndexBuffer;
+std::shared_ptr<StorageBuffer>               drawArgsBuffer;
 
 void onResize( uint32_t width, uint32_t height )
 {
@@ -72,6 +113,8 @@ void onResize( uint32_t width, uint32_t height )
 
     surface->resize( width, height );
 
+    viewportHeight = static_cast<float>( height );
+
     // Create the MSAA color texture.
     WGPUTextureFormat colorTextureFormat = surface->getSurfaceFormat();
 
@@ -124,8 +167,31 @@ void onResize( uint32_t width, uint32_t height )
                           10000.0f );
 }
 
+// Get the directory for the cache files of the user (not the assets directory, which may be read-only or
+// checked into source control).
+std::filesystem::path getUserCachePath()
+{
+#if defined( _WIN32 )
+    if ( const char* localAppData = std::getenv( "LOCALAPPDATA" ) )
+        return localAppData;
+#elif defined( __APPLE__ )
+    if ( const char* home = std::getenv( "HOME" ) )
+        return std::filesystem::path { home } / "Library" / "Caches";
+#else
+    if ( const char* cacheHome = std::getenv( "XDG_CACHE_HOME" ); cacheHome && *cacheHome )
+        return cacheHome;
+    if ( const char* home = std::getenv( "HOME" ) )
+        return std::filesystem::path { home } / ".cache";
+#endif
+
+    std::error_code error;
+    return std::filesystem::temp_directory_path( error );
+}
+
 void init()
 {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
     SDL_Init( SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER );
 
     // Enable polling game controllers.s
@@ -140,12 +206,29 @@ void init()
         return;
     }
 
-    Device::create( window );
+    // The compiled shaders and pipelines are cached on disk, so they are only compiled on the first run.
+    DeviceOptions deviceOptions;
+    if ( const auto userCachePath = getUserCachePath(); !userCachePath.empty() )
+        deviceOptions.pipelineCachePath = userCachePath / "WebGPUlib" / "pipelines";
+
+    Device::create( window, deviceOptions );
 
     // Create a uniform buffer large enough to hold a single 4x4 matrix.
-    mvpBuffer                 = Device::get().createUniformBuffer( nullptr, sizeof( glm::mat4 ) );
+    mvpBuffer = Device::get().createUniformBuffer( nullptr, sizeof( glm::mat4 ) );
+
+    const auto pipelineStartTime = std::chrono::high_resolution_clock::now();
+
+    // Precompile all pipeline variants that are used by the sample. The pipelines are compiled in the background
+    // while the scene is loaded. Draws (and dispatches) with a pipeline that is not ready yet are skipped.
     textureUnlitPipelineState = std::make_unique<TextureUnlitPipelineState>();
     textureLitPipelineState   = std::make_unique<TextureLitPipelineState>();
+    textureLitQTangentPipelineState =
+        std::make_unique<TextureLitPipelineState>( VertexLayout::PositionQTangentTexture );
+    meshletCullingPipelineState = std::make_unique<MeshletCullingPipelineState>( true );
+
+    const double pipelineMs =
+        std::chrono::duration<double, std::milli>( std::chrono::high_resolution_clock::now() - pipelineStartTime )
+            .count();
 
     cameraController = std::make_unique<CameraController>( camera, glm::vec3 { 38.5, 14, 0 }, glm::vec3 { 0, 90, 0 } );
 
@@ -155,7 +238,33 @@ void init()
     albedoTexture = Device::get().loadTexture( "assets/textures/webgpu.png" );
     cubeMesh      = Device::get().createCube( 5.0f );
     sphereMesh    = Device::get().createSphere( 0.5f );
-    scene         = Device::get().loadScene( "assets/crytek-sponza/sponza_nobanner.obj" );
+    SceneImportOptions importOptions;
+    importOptions.numLODs       = 4;
+    importOptions.buildMeshlets = true;
+    importOptions.textureArrays = true;
+
+    textureStreamer               = std::make_unique<TextureStreamer>();
+    importOptions.textureStreamer = textureStreamer.get();
+
+    // Load the scene from the asset archive if it exists. The archive is created after the scene is imported
+    // the first time, so it also contains the preprocessed scene, the cooked textures and the geometry file.
+    const std::filesystem::path archivePath = "assets/crytek-sponza.wgpa";
+    const bool                  archived    = std::filesystem::exists( archivePath ) &&
+                                              Device::get().mountArchive( archivePath, "assets/crytek-sponza" );
+
+    // The geometry file is reused (from the archive or from disk) as long as it matches the imported meshes.
+    geometryStreamer =
+        std::make_unique<GeometryStreamer>( "assets/crytek-sponza/sponza_nobanner.geometry" );
+    importOptions.geometryStreamer = geometryStreamer.get();
+
+    selectedLODs.clear();
+    scene = Device::get().loadScene( "assets/crytek-sponza/sponza_nobanner.obj", importOptions );
+
+    // The geometry file is not compressed, so the geometry streamer can read it from the mapped archive.
+    if ( !archived )
+        AssetArchive::create(
+            archivePath, "assets/crytek-sponza", {}, true, &Device::get().getThreadPool(),
+            []( const std::filesystem::path& filePath ) { return filePath.extension() != ".geometry"; } );
 
     // Scale the root node
     scene->getRootNode()->setLocalTransform( glm::scale( glm::mat4 { 1 }, glm::vec3 { 0.1f } ) );
@@ -175,16 +284,76 @@ void init()
     linearRepeatSamplerDesc.maxAnisotropy = 8;
 
     linearRepeatSampler = Device::get().createSampler( linearRepeatSamplerDesc );
+
+    // Report the startup time. Compare the first run (cold pipeline cache) with the next runs (warm pipeline cache).
+    const double startupMs =
+        std::chrono::duration<double, std::milli>( std::chrono::high_resolution_clock::now() - startTime ).count();
+    std::cout << "INFO: Startup took " << startupMs << " ms (pipelines: " << pipelineMs << " ms, "
+              << Device::get().getNumPendingPipelines() << " still compiling";
+    if ( const PipelineCache* pipelineCache = Device::get().getPipelineCache() )
+    {
+        std::cout << ", " << ( pipelineCache->isWarm() ? "warm" : "cold" )
+                  << " pipeline cache: " << pipelineCache->getNumHits() << " hits, " << pipelineCache->getNumMisses()
+                  << " misses, " << pipelineCache->getNumStores() << " stores";
+    }
+    std::cout << ")" << std::endl;
+}
+
+// Select the level of detail of a mesh based on the projected screen-space error of the LODs.
+uint32_t selectLOD( const SceneNode& node, const Mesh& mesh, const glm::mat4& worldMatrix )
+{
+    const auto& lods = mesh.getLODs();
+    if ( lods.size() < 2 )
+        return 0;
+
+    // Transform the bounding sphere of the mesh to world space.
+    float scale = glm::max( glm::length( glm::vec3 { worldMatrix[0] } ),
+                            glm::max( glm::length( glm::vec3 { worldMatrix[1] } ),
+                                      glm::length( glm::vec3 { worldMatrix[2] } ) ) );
+    glm::vec3 center   = worldMatrix * glm::vec4 { mesh.getBoundingSphereCenter(), 1.0f };
+    float     distance = glm::length( center - camera.getPosition() ) - mesh.getBoundingSphereRadius() * scale;
+
+    auto pixelError = [&]( const MeshLOD& lod ) {
+        return camera.getProjectedSize( lod.error * scale, distance ) * viewportHeight;
+    };
+
+    uint32_t& lod = selectedLODs[{ &node, &mesh }];
+    lod           = std::min<uint32_t>( lod, static_cast<uint32_t>( lods.size() - 1 ) );
+
+    // Switch to a higher LOD if the error of the current LOD is too large.
+    while ( lod > 0 && pixelError( lods[lod] ) > maxPixelError )
+        --lod;
+
+    // Switch to a lower LOD only if the error is well below the threshold.
+    while ( lod + 1 < lods.size() && pixelError( lods[lod + 1] ) < maxPixelError * lodHysteresis )
+        ++lod;
+
+    return lod;
 }
 
-void bindTexture( std::shared_ptr<GraphicsCommandBuffer> commandBuffer, int groupIndex, int binding,
-                  std::shared_ptr<Texture> texture )
+// Get the size (in pixels) of the bounding sphere of a mesh on the screen.
+float getScreenSize( const Mesh& mesh, const glm::mat4& worldMatrix )
 {
-    const auto view = texture ? texture->getView() : Device::get().getDefaultWhiteTexture()->getView();
-    commandBuffer->bindTexture( groupIndex, binding, *( view ) );
+    float scale = glm::max( glm::length( glm::vec3 { worldMatrix[0] } ),
+                            glm::max( glm::length( glm::vec3 { worldMatrix[1] } ),
+                                      glm::length( glm::vec3 { worldMatrix[2] } ) ) );
+    glm::vec3 center   = worldMatrix * glm::vec4 { mesh.getBoundingSphereCenter(), 1.0f };
+    float     radius   = mesh.getBoundingSphereRadius() * scale;
+    float     distance = glm::length( center - camera.getPosition() ) - radius;
+
+    return camera.getProjectedSize( 2.0f * radius, distance ) * viewportHeight;
 }
 
-void renderNode( std::shared_ptr<GraphicsCommandBuffer> commandBuffer, std::shared_ptr<SceneNode> node )
+// All instances of a mesh (at the same LOD) are drawn with a single instanced draw call.
+struct MeshInstances
+{
+    std::shared_ptr<Mesh> mesh;
+    uint32_t              lod;
+    std::vector<Matrices> matrices;
+};
+
+void collectInstances( const std::shared_ptr<SceneNode>& node, std::vector<MeshInstances>& meshInstances,
+                       std::map<std::pair<const Mesh*, uint32_t>, std::size_t>& meshIndices )
 {
     auto worldMatrix      = node->getWorldTransform();
     auto viewMatrix       = camera.getViewMatrix();
@@ -196,30 +365,204 @@ void renderNode( std::shared_ptr<GraphicsCommandBuffer> commandBuffer, std::shar
     matrices.modelViewIT         = transpose( inverse( matrices.modelView ) );
     matrices.modelViewProjection = projectionMatrix * viewMatrix * worldMatrix;
 
-    commandBuffer->bindDynamicUniformBuffer( 0, 0, matrices );
-    commandBuffer->bindSampler( 0, 10, *linearRepeatSampler );
-
     for ( auto& mesh: node->getMeshes() )
     {
-        const auto material = mesh->getMaterial();
+        uint32_t lod = selectLOD( *node, *mesh, worldMatrix );
+
+        // Request the texture mips of the material that match the size of the mesh on the screen.
+        if ( auto material = mesh->getMaterial() )
+            textureStreamer->request( material, getScreenSize( *mesh, worldMatrix ) );
 
-        commandBuffer->bindDynamicUniformBuffer( 0, 1, material->getProperties() );
+        // Request the full geometry of the mesh (the proxy is drawn until the geometry is loaded).
+        glm::vec3 center = worldMatrix * glm::vec4 { mesh->getBoundingSphereCenter(), 1.0f };
+        geometryStreamer->request( *mesh, glm::length( center - camera.getPosition() ) );
 
-        bindTexture( commandBuffer, 0, 2, material->getTexture( TextureSlot::Ambient ) );
-        bindTexture( commandBuffer, 0, 3, material->getTexture( TextureSlot::Emissive ) );
-        bindTexture( commandBuffer, 0, 4, material->getTexture( TextureSlot::Diffuse ) );
-        bindTexture( commandBuffer, 0, 5, material->getTexture( TextureSlot::Specular ) );
-        bindTexture( commandBuffer, 0, 6, material->getTexture( TextureSlot::SpecularPower ) );
-        bindTexture( commandBuffer, 0, 7, material->getTexture( TextureSlot::Normal ) );
-        bindTexture( commandBuffer, 0, 8, material->getTexture( TextureSlot::Bump ) );
-        bindTexture( commandBuffer, 0, 9, material->getTexture( TextureSlot::Opacity ) );
+        auto [iter, inserted] = meshIndices.try_emplace( { mesh.get(), lod }, meshInstances.size() );
+        if ( inserted )
+            meshInstances.push_back( { mesh, lod, {} } );
 
-        commandBuffer->draw( *mesh );
+        meshInstances[iter->second].matrices.push_back( matrices );
     }
 
     for ( auto& child: node->getChildren() )
     {
-        renderNode( commandBuffer, node );
+        collectInstances( child, meshInstances, meshIndices );
+    }
+}
+
+// A mesh instance whose meshlets are culled on the GPU before it is drawn.
+struct MeshletDraw
+{
+    std::shared_ptr<Mesh> mesh;
+    Matrices              matrices;
+};
+
+// Extract the normalized frustum planes (pointing inwards) from a model-view-projection matrix.
+// The planes are in the object space of the model.
+void getFrustumPlanes( const glm::mat4& m, glm::vec4 planes[6] )
+{
+    glm::vec4 row0 { m[0][0], m[1][0], m[2][0], m[3][0] };
+    glm::vec4 row1 { m[0][1], m[1][1], m[2][1], m[3][1] };
+    glm::vec4 row2 { m[0][2], m[1][2], m[2][2], m[3][2] };
+    glm::vec4 row3 { m[0][3], m[1][3], m[2][3], m[3][3] };
+
+    planes[0] = row3 + row0;  // Left
+    planes[1] = row3 - row0;  // Right
+    planes[2] = row3 + row1;  // Bottom
+    planes[3] = row3 - row1;  // Top
+    planes[4] = row2;         // Near (the depth range is [0..1])
+    planes[5] = row3 - row2;  // Far
+
+    for ( int i = 0; i < 6; ++i )
+    {
+        planes[i] /= glm::length( glm::vec3 { planes[i] } );
+    }
+}
+
+// Cull the meshlets of all mesh instances that have meshlets on the GPU.
+// The instances are removed from meshInstances and added to meshletDraws.
+// The meshlets are built from the highest level of detail, so instances that selected a coarser LOD
+// (or whose full geometry is not resident yet) are still drawn with the instanced draw calls.
+void cullMeshlets( std::vector<MeshInstances>& meshInstances, std::vector<MeshletDraw>& meshletDraws )
+{
+    for ( auto& instances: meshInstances )
+    {
+        if ( !instances.mesh->getMeshletBuffer() || instances.lod != 0 ||
+             !geometryStreamer->isResident( *instances.mesh ) )
+            continue;
+
+        for ( auto& matrices: instances.matrices )
+        {
+            meshletDraws.push_back( { instances.mesh, matrices } );
+        }
+        instances.matrices.clear();
+    }
+
+    meshInstances.erase( std::remove_if( meshInstances.begin(), meshInstances.end(),
+                                         []( const MeshInstances& instances ) { return instances.matrices.empty(); } ),
+                         meshInstances.end() );
+
+    if ( meshletDraws.empty() )
+        return;
+
+    auto& device = Device::get();
+    auto  queue  = device.getQueue();
+
+    // Assign a range of the culled index buffer and the draw arguments to each draw.
+    std::vector<DrawIndexedIndirectArgs> drawArgs( meshletDraws.size() );
+    std::vector<MeshletCullParams>       cullParams( meshletDraws.size() );
+    uint32_t                             indexCount = 0;
+
+    for ( std::size_t i = 0; i < meshletDraws.size(); ++i )
+    {
+        const auto& draw = meshletDraws[i];
+
+        drawArgs[i].instanceCount = 1;
+        drawArgs[i].firstIndex    = indexCount;
+
+        auto& params = cullParams[i];
+        getFrustumPlanes( draw.matrices.modelViewProjection, params.frustumPlanes );
+        params.cameraPosition = inverse( draw.matrices.model ) * glm::vec4 { camera.getPosition(), 1.0f };
+        params.meshletCount   = static_cast<uint32_t>( draw.mesh->getMeshletBuffer()->getElementCount() );
+        params.drawIndex      = static_cast<uint32_t>( i );
+        params.firstIndex     = indexCount;
+
+        indexCount += static_cast<uint32_t>( draw.mesh->getMeshletIndexBuffer()->getElementCount() );
+    }
+
+    // Grow the culled index buffer and the draw arguments buffer if needed.
+    if ( !culledIndexBuffer || culledIndexBuffer->getIndexCount() < indexCount )
+    {
+        culledIndexBuffer =
+            device.createIndexBuffer( nullptr, indexCount, sizeof( uint32_t ), WGPUBufferUsage_Storage );
+    }
+    if ( !drawArgsBuffer || drawArgsBuffer->getElementCount() < drawArgs.size() )
+    {
+        drawArgsBuffer = device.createStorageBuffer( nullptr, drawArgs.size(), sizeof( DrawIndexedIndirectArgs ),
+                                                     WGPUBufferUsage_Indirect );
+    }
+
+    // Reset the draw arguments. The culling shader accumulates the index count of the visible meshlets.
+    queue->writeBuffer( *drawArgsBuffer, drawArgs.data(), drawArgs.size() * sizeof( DrawIndexedIndirectArgs ) );
+
+    auto commandBuffer = queue->createComputeCommandBuffer();
+
+    commandBuffer->setComputePipeline( *meshletCullingPipelineState );
+    commandBuffer->bindBuffer( 0, 3, *culledIndexBuffer );
+    commandBuffer->bindBuffer( 0, 4, *drawArgsBuffer );
+
+    for ( std::size_t i = 0; i < meshletDraws.size(); ++i )
+    {
+        const auto& mesh = meshletDraws[i].mesh;
+
+        commandBuffer->bindDynamicUniformBuffer( 0, 0, cullParams[i] );
+        commandBuffer->bindBuffer( 0, 1, *mesh->getMeshletBuffer() );
+        commandBuffer->bindBuffer( 0, 2, *mesh->getMeshletIndexBuffer() );
+
+        // One workgroup per meshlet. The number of workgroups in each dimension is limited,
+        // so large meshes are dispatched as a 2D grid of workgroups.
+        const uint32_t meshletCount = cullParams[i].meshletCount;
+        const uint32_t groupCountX  = std::min( meshletCount, MaxWorkgroupsPerDimension );
+        const uint32_t groupCountY  = ( meshletCount + MaxWorkgroupsPerDimension - 1 ) / MaxWorkgroupsPerDimension;
+        commandBuffer->dispatch( groupCountX, groupCountY );
+    }
+
+    queue->submit( *commandBuffer );
+}
+
+// Bind the pipeline and material for a mesh.
+void bindMesh( std::shared_ptr<GraphicsCommandBuffer> commandBuffer, const Mesh& mesh )
+{
+    const auto material = mesh.getMaterial();
+
+    // Select the pipeline that matches the vertex layout of the mesh.
+    if ( mesh.getVertexLayout() == VertexLayout::PositionQTangentTexture )
+        commandBuffer->setGraphicsPipeline( *textureLitQTangentPipelineState );
+    else
+        commandBuffer->setGraphicsPipeline( *textureLitPipelineState );
+
+    // The material bind group is prebuilt (and shared by the materials with the same textures),
+    // so binding a material does not create a bind group. The offset selects the properties of the material.
+    commandBuffer->bindBindGroup( 1, material->getBindGroup(), { material->getBindGroupOffset() } );
+}
+
+void renderScene( std::shared_ptr<GraphicsCommandBuffer> commandBuffer,
+                  const std::vector<MeshInstances>& meshInstances, const std::vector<MeshletDraw>& meshletDraws )
+{
+    // Upload the matrices of all instances to a single storage buffer.
+    // The instance index is used to index into the matrices in the vertex shader.
+    std::vector<Matrices> matrices;
+    for ( auto& instances: meshInstances )
+    {
+        matrices.insert( matrices.end(), instances.matrices.begin(), instances.matrices.end() );
+    }
+
+    if ( !matrices.empty() )
+        commandBuffer->bindDynamicStorageBuffer( 2, 0, matrices );
+
+    uint32_t firstInstance = 0;
+    for ( auto& [mesh, lod, instanceMatrices]: meshInstances )
+    {
+        const auto instanceCount = static_cast<uint32_t>( instanceMatrices.size() );
+
+        bindMesh( commandBuffer, *mesh );
+
+        commandBuffer->draw( *mesh, instanceCount, firstInstance, lod );
+
+        firstInstance += instanceCount;
+    }
+
+    // Draw the visible meshlets. The draw arguments were written by the meshlet culling pass.
+    for ( std::size_t i = 0; i < meshletDraws.size(); ++i )
+    {
+        const auto& draw = meshletDraws[i];
+
+        bindMesh( commandBuffer, *draw.mesh );
+
+        // Indirect draws must start at instance 0, so bind the matrices of this instance only.
+        commandBuffer->bindDynamicStorageBuffer( 2, 0, &draw.matrices, 1, sizeof( Matrices ) );
+        commandBuffer->drawIndexedIndirect( *draw.mesh, *culledIndexBuffer, *drawArgsBuffer,
+                                            i * sizeof( DrawIndexedIndirectArgs ) );
     }
 }
 
@@ -233,6 +576,23 @@ void render()
 
     const auto queue = Device::get().getQueue();
 
+    std::vector<MeshInstances>                              meshInstances;
+    std::map<std::pair<const Mesh*, uint32_t>, std::size_t> meshIndices;
+    std::vector<MeshletDraw>                                meshletDraws;
+
+    collectInstances( scene->getRootNode(), meshInstances, meshIndices );
+
+    // Load and evict the texture mips and the geometry that were requested by the scene meshes.
+    textureStreamer->update();
+    geometryStreamer->update();
+
+    // Upload the properties of the materials that changed.
+    Device::get().getMaterialTable().update();
+
+    // Meshlet culling is performed in a compute pass before the render pass.
+    if ( useMeshletCulling )
+        cullMeshlets( meshInstances, meshletDraws );
+
     const auto commandBuffer = queue->createGraphicsCommandBuffer( renderTarget, ClearFlags::Color | ClearFlags::Depth,
                                                                    { 0.4f, 0.6f, 0.9f, 1.0f }, 1.0f );
 
@@ -267,11 +627,13 @@ void render()
 
     commandBuffer->setGraphicsPipeline( *textureLitPipelineState );
 
-    commandBuffer->bindDynamicStorageBuffer( 0, 11, pointLights );
-    //commandBuffer->bindDynamicStorageBuffer( 0, 12, spotLights );
+    // The per-frame bind group of the lit pipeline has a different layout than the bind group of the unlit pipeline.
+    commandBuffer->resetBindGroup( 0 );
+    commandBuffer->bindDynamicStorageBuffer( 0, 0, pointLights );
+    //commandBuffer->bindDynamicStorageBuffer( 0, 1, spotLights );
 
     // Render the scene.
-    renderNode( commandBuffer, scene->getRootNode() );
+    renderScene( commandBuffer, meshInstances, meshletDraws );
 
     queue->submit( *commandBuffer );
 
@@ -281,6 +643,62 @@ void render()
     Device::get().poll();
 }
 
+// Compare the single pass and the multi pass mip generators on large textures (press the G key).
+// The time includes the CPU time to record and submit the command buffer and the GPU time to execute it.
+void benchmarkMips()
+{
+    auto& device = Device::get();
+    auto  queue  = device.getQueue();
+
+    const MipGenerator currentGenerator = device.getMipGenerator();
+
+    for ( uint32_t size: { 1024u, 2048u, 4096u } )
+    {
+        WGPUTextureDescriptor textureDesc {};
+        textureDesc.label         = "Mip Benchmark Texture";
+        textureDesc.dimension     = WGPUTextureDimension_2D;
+        textureDesc.format        = WGPUTextureFormat_RGBA8Unorm;
+        textureDesc.size          = { size, size, 1 };
+        textureDesc.sampleCount   = 1;
+        textureDesc.mipLevelCount = static_cast<uint32_t>( std::log2( size ) ) + 1;
+        textureDesc.usage         = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_StorageBinding |
+                                    WGPUTextureUsage_CopyDst;
+
+        auto texture = device.createTexture( textureDesc );
+
+        // Fill mip 0 with a pattern.
+        std::vector<uint32_t> pixels( static_cast<std::size_t>( size ) * size );
+        for ( std::size_t i = 0; i < pixels.size(); ++i )
+            pixels[i] = static_cast<uint32_t>( i * 2654435761u ) | 0xff000000u;
+
+        queue->writeTexture( *texture, 0, pixels.data(), pixels.size() * sizeof( uint32_t ) );
+
+        for ( MipGenerator generator: { MipGenerator::MultiPass, MipGenerator::SinglePass } )
+        {
+            constexpr int iterations = 20;
+
+            device.setMipGenerator( generator );
+
+            // Warm up (create the pipeline and the buffers).
+            device.generateMips( *texture );
+            device.waitIdle();
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for ( int i = 0; i < iterations; ++i )
+                device.generateMips( *texture );
+            device.waitIdle();
+            auto end = std::chrono::high_resolution_clock::now();
+
+            double ms = std::chrono::duration<double, std::milli>( end - start ).count() / iterations;
+            std::cout << "INFO: Generate mips " << size << "x" << size << " ("
+                      << ( generator == MipGenerator::SinglePass ? "single pass" : "multi pass" ) << "): " << ms
+                      << " ms" << std::endl;
+        }
+    }
+
+    device.setMipGenerator( currentGenerator );
+}
+
 void pollEvents()
 {
     SDL_Event event;
@@ -300,6 +718,13 @@ void pollEvents()
             case SDLK_r:
                 cameraController->reset();
                 break;
+            case SDLK_m:
+                useMeshletCulling = !useMeshletCulling;
+                std::cout << "Meshlet culling: " << ( useMeshletCulling ? "ON" : "OFF" ) << std::endl;
+                break;
+            case SDLK_g:
+                benchmarkMips();
+                break;
             default:
                 break;
             }
@@ -397,6 +822,10 @@ void update( void* userdata = nullptr )
 
 void destroy()
 {
+    selectedLODs.clear();
+    scene.reset();
+    textureStreamer.reset();
+    geometryStreamer.reset();
     Device::destroy();
 }
 